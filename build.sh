@@ -1,3 +1,3 @@
 cd march_cu; make $1; cd ..;
-cd iglucose/core; make $1; cd ../simp; make $1; cd ../..;
+cd iglucose/core; make MARCH=1 $1; cd ../simp; make $1; cd ../..;
 cd lingeling; ./configure.sh; make $1; cd ..;
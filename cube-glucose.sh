@@ -1,13 +1,18 @@
+#!/bin/bash
 CNF=$1
 DIR=~/CnC/
 OUT=/tmp
+# Simplify once for both march and iglucose; models are extended with the reconstruction stack
+$DIR/iglucose/simp/iglucose $CNF -verb=0 -dimacs=$OUT/simp$$.cnf -stack=$OUT/stack$$ > /dev/null
+if [[ $? == 20 ]]; then echo "s UNSATISFIABLE"; rm -f $OUT/simp$$.cnf $OUT/stack$$; exit 20; fi
 #~/Folkman/vdW/march_cu/march_cu $CNF -o $DIR/cubes$$ $2 $3 $4 $5 $6 $7 $8 $9
-$DIR/march_cu/march_cu $CNF -o $OUT/cubes$$ $2 $3 $4 $5 $6 $7 $8 $9
-echo "p inccnf" > $DIR/formula$$.icnf
-cat $CNF | grep -v c >> $OUT/formula$$.icnf
+$DIR/march_cu/march_cu $OUT/simp$$.cnf -o $OUT/cubes$$ $2 $3 $4 $5 $6 $7 $8 $9
+echo "p inccnf" > $OUT/formula$$.icnf
+cat $OUT/simp$$.cnf | grep -v c >> $OUT/formula$$.icnf
 cat $OUT/cubes$$ >> $OUT/formula$$.icnf
 rm  $OUT/cubes$$
-$DIR/iglucose/core/iglucose $OUT/formula$$.icnf -verb=0
+$DIR/iglucose/core/iglucose $OUT/formula$$.icnf -verb=0 -model > $OUT/result$$
+grep -v "^v" $OUT/result$$
+if grep -q "^s SATISFIABLE" $OUT/result$$; then $DIR/iglucose/simp/iglucose $OUT/result$$ -extend=$OUT/stack$$ | grep "^v"; fi
 #./iglucose/core/iglucose $DIR/formula$$.icnf -verb=0 -certified -certified-output=proof | grep -v bound
-rm $OUT/formula$$.icnf
-
+rm $OUT/formula$$.icnf $OUT/simp$$.cnf $OUT/stack$$ $OUT/result$$
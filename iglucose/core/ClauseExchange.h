@@ -0,0 +1,109 @@
+/********************************************************************************[ClauseExchange.h]
+ iGlucose -- clause sharing between parallel cube workers
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Glucose_ClauseExchange_h
+#define Glucose_ClauseExchange_h
+
+#include <atomic>
+
+#include "mtl/Vec.h"
+#include "core/SolverTypes.h"
+
+namespace Glucose {
+
+//=================================================================================================
+// ClauseRing -- bounded single-producer single-consumer queue of clauses.
+//
+// Each entry is the clause size, its LBD and its literals. The producer drops a clause when the
+// ring is full, so neither side ever waits.
+
+class ClauseRing {
+    uint32_t*             buf;
+    uint32_t              mask;
+    std::atomic<uint64_t> head;          // Next word to read, written by the consumer only.
+    char                  pad[64];       // Keep 'head' and 'tail' on different cache lines.
+    std::atomic<uint64_t> tail;          // Next word to write, written by the producer only.
+
+public:
+    ClauseRing() : buf(NULL), mask(0), head(0), tail(0) {}
+    ~ClauseRing() { free(buf); }
+
+    void init(int log2size) {
+        buf  = (uint32_t*)xrealloc(NULL, sizeof(uint32_t) << log2size);
+        mask = (1 << log2size) - 1; }
+
+    bool push(const vec<Lit>& c, unsigned int lbd);   // Returns FALSE if the ring is full.
+    bool pop (vec<Lit>& c, unsigned int& lbd);        // Returns FALSE if the ring is empty.
+};
+
+
+//=================================================================================================
+// ClauseExchange -- one ring for every ordered pair of workers.
+
+class ClauseExchange {
+    int         n;
+    ClauseRing* rings;
+
+public:
+    ClauseExchange(int workers, int log2size) : n(workers), rings(new ClauseRing[workers * workers]) {
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++)
+                if (i != j) rings[i * n + j].init(log2size); }
+    ~ClauseExchange() { delete [] rings; }
+
+    int         nWorkers()                const { return n; }
+    ClauseRing& ring    (int from, int to)      { return rings[from * n + to]; }
+};
+
+
+//=================================================================================================
+// Implementation of inline methods:
+
+inline bool ClauseRing::push(const vec<Lit>& c, unsigned int lbd)
+{
+    uint64_t t = tail.load(std::memory_order_relaxed);
+    if (t + c.size() + 2 - head.load(std::memory_order_acquire) > (uint64_t)mask + 1)
+        return false;
+    buf[t++ & mask] = c.size();
+    buf[t++ & mask] = lbd;
+    for (int i = 0; i < c.size(); i++)
+        buf[t++ & mask] = toInt(c[i]);
+    tail.store(t, std::memory_order_release);
+    return true;
+}
+
+
+inline bool ClauseRing::pop(vec<Lit>& c, unsigned int& lbd)
+{
+    uint64_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire))
+        return false;
+    int size = buf[h++ & mask];
+    lbd      = buf[h++ & mask];
+    c.clear();
+    for (int i = 0; i < size; i++)
+        c.push(toLit(buf[h++ & mask]));
+    head.store(h, std::memory_order_release);
+    return true;
+}
+
+//=================================================================================================
+}
+
+#endif
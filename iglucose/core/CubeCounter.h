@@ -0,0 +1,458 @@
+/**********************************************************************************[CubeCounter.h]
+ iGlucose -- model counting over cubes
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Glucose_CubeCounter_h
+#define Glucose_CubeCounter_h
+
+#include <stdio.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "mtl/Vec.h"
+#include "mtl/Sort.h"
+#include "core/Solver.h"
+#include "core/CubeTrie.h"
+#include "utils/System.h"
+
+namespace Glucose {
+
+//=================================================================================================
+// Count -- an unbounded model count.
+
+class Count {
+    vec<uint32_t> w;         // Little endian, without leading zero words.
+
+public:
+    Count(uint32_t x = 0)   { if (x) w.push(x); }
+    Count(const Count& c)   { c.w.copyTo(w); }
+    Count& operator=(const Count& c) { c.w.copyTo(w); return *this; }
+
+    bool   isZero() const   { return w.size() == 0; }
+    void   add   (const Count& c);
+    void   mul   (const Count& c);
+    void   shl   (int k);    // Multiplies by 2^k.
+    double log10 () const;
+    void   print (FILE* f) const;
+};
+
+
+inline void Count::add(const Count& c)
+{
+    uint64_t carry = 0;
+    w.growTo(c.w.size() > w.size() ? c.w.size() : w.size(), 0);
+    for (int i = 0; i < w.size(); i++){
+        carry += (uint64_t)w[i] + (i < c.w.size() ? c.w[i] : 0);
+        w[i]   = (uint32_t)carry;
+        carry >>= 32; }
+    if (carry) w.push((uint32_t)carry);
+}
+
+
+inline void Count::mul(const Count& c)
+{
+    if (isZero() || c.isZero()){ w.clear(); return; }
+    vec<uint32_t> r(w.size() + c.w.size(), 0);
+    for (int i = 0; i < w.size(); i++){
+        uint64_t carry = 0;
+        for (int j = 0; j < c.w.size(); j++){
+            carry   += (uint64_t)w[i] * c.w[j] + r[i + j];
+            r[i + j] = (uint32_t)carry;
+            carry  >>= 32; }
+        r[i + c.w.size()] = (uint32_t)carry; }
+    while (r.size() > 0 && r.last() == 0) r.pop();
+    r.moveTo(w);
+}
+
+
+inline void Count::shl(int k)
+{
+    if (isZero() || k == 0) return;
+    int words = k / 32, bits = k % 32, n = w.size();
+    w.growTo(n + words + 1, 0);
+    for (int i = n - 1; i >= 0; i--){
+        uint64_t x = (uint64_t)w[i] << bits;
+        w[i]             = 0;
+        w[i + words + 1] |= (uint32_t)(x >> 32);
+        w[i + words]     |= (uint32_t)x; }
+    while (w.last() == 0) w.pop();
+}
+
+
+inline double Count::log10() const
+{
+    double m = 0;
+    for (int i = w.size() - 1; i >= 0 && i >= w.size() - 3; i--) m = m * 4294967296.0 + w[i];
+    return isZero() ? -HUGE_VAL : ::log10(m) + 32 * ::log10(2.0) * (w.size() > 3 ? w.size() - 3 : 0);
+}
+
+
+// In decimal, by repeated division by 10^9.
+inline void Count::print(FILE* f) const
+{
+    vec<uint32_t> q, digits;
+    w.copyTo(q);
+    while (q.size() > 0){
+        uint64_t rem = 0;
+        for (int i = q.size() - 1; i >= 0; i--){
+            uint64_t x = (rem << 32) | q[i];
+            q[i] = (uint32_t)(x / 1000000000);
+            rem  = x % 1000000000; }
+        digits.push((uint32_t)rem);
+        while (q.size() > 0 && q.last() == 0) q.pop(); }
+
+    if (digits.size() == 0){ fprintf(f, "0"); return; }
+    fprintf(f, "%u", digits.last());
+    for (int i = digits.size() - 2; i >= 0; i--) fprintf(f, "%09u", digits[i]);
+}
+
+
+//=================================================================================================
+// ModelCounter -- exact model counting of a small formula by DPLL with connected components and a
+// cache of component counts. Literals are 'toInt()' of 'Lit'; a formula is a list of clauses, each
+// terminated by -1. Every formula passed around holds no assigned variable.
+
+class ModelCounter {
+    vec<signed char> val;    // By literal: 1 true, -1 false.
+    vec<int>         trail, stamp, root, occurs;
+    int              now;
+
+    // The cache, chained by hash:
+    vec<vec<int> >   keys;
+    vec<Count>       counts;
+    vec<int>         next, buckets;
+    uint64_t         cachedLits, maxCachedLits;
+
+    void   grow      (int lit);
+    int    countVars (const vec<int>& F);
+    bool   propagate (const vec<int>& F, int lit, vec<int>& G, int& nassigned);
+    void   components(const vec<int>& F, vec<vec<int> >& comps);
+    void   canonical (vec<int>& F);
+    Count  formula   (const vec<int>& F);
+    Count  component (vec<int>& F);
+
+    uint32_t hashKey (const vec<int>& F) const {
+        uint32_t h = 2166136261u;
+        for (int i = 0; i < F.size(); i++) h = (h ^ (uint32_t)F[i]) * 16777619u;
+        return h; }
+
+    struct ClauseLt {
+        const vec<int>& F;
+        ClauseLt(const vec<int>& F_) : F(F_) {}
+        bool operator()(int a, int b) const {
+            for (;; a++, b++){
+                if (F[a] != F[b]) return F[a] < F[b];    // -1 ends the shorter one first.
+                if (F[a] == -1)   return false; } }
+    };
+
+public:
+    uint64_t nodes, hits;
+
+    ModelCounter(uint64_t maxCachedLits_ = 1 << 25)
+        : now(0), cachedLits(0), maxCachedLits(maxCachedLits_), nodes(0), hits(0) {
+        buckets.growTo(1 << 16, -1); }
+
+    // The models of the clauses in 'lits' (terminated by 'lit_Undef') over the variables in them.
+    Count count(const vec<Lit>& lits);
+};
+
+
+inline void ModelCounter::grow(int lit)
+{
+    int v = lit >> 1;
+    if (v < stamp.size()) return;
+    val   .growTo(2 * v + 2, 0);
+    stamp .growTo(v + 1, 0);
+    root  .growTo(v + 1, 0);
+    occurs.growTo(v + 1, 0);
+}
+
+
+inline int ModelCounter::countVars(const vec<int>& F)
+{
+    int n = 0;
+    now++;
+    for (int i = 0; i < F.size(); i++)
+        if (F[i] != -1 && stamp[F[i] >> 1] != now){ stamp[F[i] >> 1] = now; n++; }
+    return n;
+}
+
+
+// Simplifies 'F' by 'lit' and the units that follow into 'G'. Returns FALSE on a conflict.
+inline bool ModelCounter::propagate(const vec<int>& F, int lit, vec<int>& G, int& nassigned)
+{
+    vec<int>        tmp;
+    const vec<int>* in = &F;
+    bool            conflict = false;
+
+    trail.clear();
+    trail.push(lit); val[lit] = 1; val[lit ^ 1] = -1;
+    for (;;){
+        int before = trail.size();
+        G.clear();
+        for (int i = 0, j; i < in->size() && !conflict; i = j + 1){
+            int  begin = G.size();
+            bool sat   = false;
+            for (j = i; (*in)[j] != -1; j++){
+                int p = (*in)[j];
+                if      (val[p] == 1) sat = true;
+                else if (val[p] == 0) G.push(p); }
+            int n = G.size() - begin;
+            if (sat)         G.shrink(n);
+            else if (n == 0) conflict = true;
+            else if (n == 1){
+                int u = G.last(); G.pop();
+                trail.push(u); val[u] = 1; val[u ^ 1] = -1; }
+            else G.push(-1); }
+        if (conflict || trail.size() == before) break;
+        G.copyTo(tmp);
+        in = &tmp; }
+
+    nassigned = trail.size();
+    for (int i = 0; i < trail.size(); i++) val[trail[i]] = val[trail[i] ^ 1] = 0;
+    return !conflict;
+}
+
+
+// Union-find over the variables, then the clauses by the root of their first variable.
+inline void ModelCounter::components(const vec<int>& F, vec<vec<int> >& comps)
+{
+    now++;
+    for (int i = 0; i < F.size(); i++)
+        if (F[i] != -1 && stamp[F[i] >> 1] != now){ stamp[F[i] >> 1] = now; root[F[i] >> 1] = F[i] >> 1; }
+
+    for (int i = 0, j; i < F.size(); i = j + 1){
+        int r = F[i] >> 1;
+        while (root[r] != r) r = root[r] = root[root[r]];
+        for (j = i + 1; F[j] != -1; j++){
+            int s = F[j] >> 1;
+            while (root[s] != s) s = root[s] = root[root[s]];
+            if (s != r) root[s] = r; } }
+
+    // 'occurs' maps a root to its component:
+    comps.clear();
+    now++;
+    for (int i = 0, j; i < F.size(); i = j + 1){
+        int r = F[i] >> 1;
+        while (root[r] != r) r = root[r];
+        if (stamp[r] != now){ stamp[r] = now; occurs[r] = comps.size(); comps.push(); }
+        vec<int>& c = comps[occurs[r]];
+        for (j = i; F[j] != -1; j++) c.push(F[j]);
+        c.push(-1); }
+}
+
+
+// Sorts the literals of every clause and then the clauses, so that equal components are equal keys.
+inline void ModelCounter::canonical(vec<int>& F)
+{
+    vec<int> starts, G;
+    for (int i = 0, j; i < F.size(); i = j + 1){
+        for (j = i; F[j] != -1; j++);
+        sort(&F[i], j - i);
+        starts.push(i); }
+    sort(starts, ClauseLt(F));
+    for (int i = 0; i < starts.size(); i++)
+        for (int j = starts[i]; ; j++){
+            G.push(F[j]);
+            if (F[j] == -1) break; }
+    G.moveTo(F);
+}
+
+
+inline Count ModelCounter::formula(const vec<int>& F)
+{
+    if (F.size() == 0) return Count(1);
+
+    vec<vec<int> > comps;
+    components(F, comps);
+    Count c = component(comps[0]);
+    for (int i = 1; i < comps.size() && !c.isZero(); i++)
+        c.mul(component(comps[i]));
+    return c;
+}
+
+
+inline Count ModelCounter::component(vec<int>& F)
+{
+    canonical(F);
+    uint32_t h = hashKey(F);
+    for (int e = buckets[h & (buckets.size() - 1)]; e != -1; e = next[e]){
+        if (keys[e].size() != F.size()) continue;
+        int i = 0;
+        while (i < F.size() && keys[e][i] == F[i]) i++;
+        if (i == F.size()){ hits++; return counts[e]; } }
+    nodes++;
+
+    // Branch on the variable with the most occurrences:
+    int best = -1, nvars = 0;
+    now++;
+    for (int i = 0; i < F.size(); i++){
+        if (F[i] == -1) continue;
+        int v = F[i] >> 1;
+        if (stamp[v] != now){ stamp[v] = now; occurs[v] = 0; nvars++; }
+        if (++occurs[v] > (best == -1 ? 0 : occurs[best])) best = v; }
+
+    Count    total;
+    vec<int> G;
+    for (int s = 0; s < 2; s++){
+        int nassigned;
+        if (!propagate(F, 2 * best + s, G, nassigned)) continue;
+        int   free = nvars - nassigned - countVars(G);
+        Count c    = formula(G);
+        c.shl(free);
+        total.add(c); }
+
+    // Store, or start over once the cache is full:
+    if (cachedLits + F.size() > maxCachedLits){
+        keys.clear(); counts.clear(); next.clear();
+        for (int i = 0; i < buckets.size(); i++) buckets[i] = -1;
+        cachedLits = 0; }
+    if (keys.size() >= 4 * buckets.size()){
+        buckets.clear(); buckets.growTo(2 * keys.size(), -1);   // Twice a power of two.
+        for (int e = 0; e < keys.size(); e++){
+            int b = hashKey(keys[e]) & (buckets.size() - 1);
+            next[e] = buckets[b]; buckets[b] = e; } }
+    int b = h & (buckets.size() - 1);
+    keys.push(); F.copyTo(keys.last());
+    counts.push(); counts.last() = total;
+    next.push(buckets[b]); buckets[b] = keys.size() - 1;
+    cachedLits += F.size();
+    return total;
+}
+
+
+inline Count ModelCounter::count(const vec<Lit>& lits)
+{
+    vec<int> F;
+    for (int i = 0; i < lits.size(); i++)
+        if (lits[i] == lit_Undef) F.push(-1);
+        else { F.push(toInt(lits[i])); grow(toInt(lits[i])); }
+    return formula(F);
+}
+
+
+//=================================================================================================
+// CubeCounter -- counts the models of a formula as the sum of the counts of its cubes, which have
+// to partition the assignments (like the cubes of march_cu -#). Every worker owns a copy of the
+// formula and takes the next cube: 'Solver::reduceCube()' fixes the propagated cube and replaces
+// equivalent literals, the remaining clauses go to a 'ModelCounter' and every variable that is
+// left out of them doubles the count.
+
+class CubeCounter {
+    struct Worker {
+        CubeCounter*  counter;
+        Solver*       S;
+        ModelCounter  mc;
+        pthread_t     thread;
+    };
+
+    const CubeTrie&  cubes;
+    pthread_mutex_t  lock;
+    int              next;
+    Count            total;
+    int              ncounted, nrefuted;
+    uint64_t         nodes, hits;
+
+    Count        countCube(Solver& S, ModelCounter& mc, const vec<Lit>& cube);
+    static void* work     (void* arg);
+
+public:
+    CubeCounter(const CubeTrie& cubes_)
+        : cubes(cubes_), next(0), ncounted(0), nrefuted(0), nodes(0), hits(0) {}
+
+    Count run       (Solver& S, int nworkers);
+    void  printStats(double seconds) const {
+        printf("c counted cubes         : %d (%d without models) in %.2f s\n", ncounted, nrefuted, seconds);
+        printf("c counter nodes         : %lld (%lld cache hits)\n", (long long int)nodes, (long long int)hits); }
+};
+
+
+inline Count CubeCounter::countCube(Solver& S, ModelCounter& mc, const vec<Lit>& cube)
+{
+    vec<Lit> out, units, repr;
+    lbool    ret = S.reduceCube(cube, out, units, repr);
+    if (ret == l_False) return Count(0);
+
+    // Fixed or equivalent to a smaller variable (1), in the reduced clauses (2), free (0):
+    vec<char> used(S.nVars(), 0);
+    for (int i = 0; i < units.size(); i++) used[var(units[i])] = 1;
+    for (Var v = 0; v < S.nVars() && repr.size() > 0; v++)
+        if (var(repr[toInt(mkLit(v))]) != v) used[v] = 1;
+    for (int i = 0; i < out.size(); i++)
+        if (out[i] != lit_Undef) used[var(out[i])] = 2;
+
+    Count c   = ret == l_True ? Count(1) : mc.count(out);
+    int  free = 0;
+    for (Var v = 0; v < S.nVars(); v++) free += used[v] == 0;
+    c.shl(free);
+    return c;
+}
+
+
+inline void* CubeCounter::work(void* arg)
+{
+    Worker&      w = *(Worker*)arg;
+    CubeCounter& c = *w.counter;
+    vec<Lit>     cube;
+
+    pthread_mutex_lock(&c.lock);
+    while (c.next < c.cubes.size()){
+        c.cubes.cube(c.next++, cube);
+        pthread_mutex_unlock(&c.lock);
+
+        Count n = c.countCube(*w.S, w.mc, cube);
+
+        pthread_mutex_lock(&c.lock);
+        c.total.add(n);
+        c.ncounted++;
+        c.nrefuted += n.isZero(); }
+    c.nodes += w.mc.nodes;
+    c.hits  += w.mc.hits;
+    pthread_mutex_unlock(&c.lock);
+    return NULL;
+}
+
+
+inline Count CubeCounter::run(Solver& S, int nworkers)
+{
+    if (!S.okay()) return Count(0);
+
+    Worker* workers = new Worker[nworkers];
+    pthread_mutex_init(&lock, NULL);
+    for (int i = 0; i < nworkers; i++){
+        workers[i].counter = this;
+        if (i == 0) workers[i].S = &S;
+        else {
+            workers[i].S = new Solver;
+            S.copyClausesTo(*workers[i].S); } }
+    for (int i = 0; i < nworkers; i++)
+        pthread_create(&workers[i].thread, NULL, work, &workers[i]);
+    for (int i = 0; i < nworkers; i++)
+        pthread_join(workers[i].thread, NULL);
+
+    for (int i = 1; i < nworkers; i++) delete workers[i].S;
+    delete [] workers;
+    pthread_mutex_destroy(&lock);
+    return total;
+}
+
+
+//=================================================================================================
+}
+
+#endif
@@ -0,0 +1,162 @@
+/***********************************************************************************[CubeJournal.h]
+ iGlucose -- crash-safe journal of refuted cubes
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Glucose_CubeJournal_h
+#define Glucose_CubeJournal_h
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "mtl/Vec.h"
+#include "core/SolverTypes.h"
+#include "utils/System.h"
+
+namespace Glucose {
+
+//=================================================================================================
+// CubeJournal -- append-only record of the refuted cubes of a run, for resuming after a crash.
+//
+// The file starts with 'p journal <cubes>', followed by one line 'u <id> <failed literals> 0' per
+// refuted cube. Records are buffered and written with one 'fsync()' per group: after 'batch'
+// records or 'interval' seconds, whichever comes first. A crash loses at most the last group and
+// a torn last line is cut off when the journal is opened again. A complete record that does not fit
+// the run (cube id or variable out of range) is skipped on its own. The format is shared with
+// ilingeling's '-j' option.
+
+class CubeJournal {
+    int       fd;
+    vec<char> buf;            // Records not yet synced.
+    int       pending;
+    int       batch;
+    double    interval;
+    double    last_sync;
+
+    void append(const char* s) { while (*s) buf.push(*s++); }
+    void emit  ();
+
+public:
+    CubeJournal(int batch_ = 64, double interval_ = 1.0)
+        : fd(-1), pending(0), batch(batch_), interval(interval_), last_sync(realTime()) {}
+    ~CubeJournal() { close(); }
+
+    // Opens or creates the journal of a run with 'ncubes' cubes over 'nvars' variables. The ids and
+    // failed literals of the cubes refuted before are returned in 'ids' and 'failed'. Returns FALSE
+    // if the file can not be used, e.g. it belongs to a run with a different number of cubes.
+    bool open  (const char* file, int ncubes, int nvars, vec<int>& ids, vec<vec<Lit> >& failed);
+    // Returns TRUE once a group is complete. It has then been written to the file, and the caller
+    // should 'flush()' it to disk after releasing any lock shared with other threads.
+    bool record(int id, const vec<Lit>& failed);
+    void flush () { if (fd >= 0) fsync(fd); }
+    void sync  () { emit(); flush(); }
+    void close () { if (fd >= 0){ sync(); ::close(fd); fd = -1; } }
+};
+
+
+//=================================================================================================
+// Implementation of inline methods:
+
+inline bool CubeJournal::open(const char* file, int ncubes, int nvars, vec<int>& ids, vec<vec<Lit> >& failed)
+{
+    ids.clear();
+    failed.clear();
+
+    long  good = 0;          // End of the last complete record.
+    FILE* in   = fopen(file, "r");
+    if (in != NULL){
+        int n;
+        if (fscanf(in, "p journal %d", &n) != 1 || n != ncubes || fgetc(in) != '\n'){
+            fclose(in);
+            return false; }
+        good = ftell(in);
+
+        vec<Lit> lits;
+        int      id, lit, skipped = 0;
+        while (fscanf(in, " u %d", &id) == 1){
+            bool fits = id >= 0 && id < ncubes;
+            lits.clear();
+            lit = 1;
+            while (fscanf(in, "%d", &lit) == 1 && lit != 0)
+                if (lit < -nvars || lit > nvars) fits = false;
+                else lits.push(mkLit(abs(lit) - 1, lit < 0));
+            if (lit != 0 || fgetc(in) != '\n') break;
+            good = ftell(in);
+            if (!fits){ skipped++; continue; }
+            ids.push(id);
+            failed.push();
+            lits.copyTo(failed.last());
+        }
+        fclose(in);
+        if (skipped > 0)
+            fprintf(stderr, "c WARNING! Skipped %d journal records that do not fit the formula.\n", skipped);
+    }
+
+    fd = ::open(file, O_WRONLY | O_CREAT, 0644);
+    if (fd < 0 || ftruncate(fd, good) != 0 || lseek(fd, good, SEEK_SET) != good)
+        return false;
+    if (good == 0){
+        char header[64];
+        snprintf(header, sizeof(header), "p journal %d\n", ncubes);
+        append(header);
+        sync();
+    }
+    return true;
+}
+
+
+inline bool CubeJournal::record(int id, const vec<Lit>& failed)
+{
+    if (fd < 0) return false;
+    char tmp[32];
+    snprintf(tmp, sizeof(tmp), "u %d", id);
+    append(tmp);
+    for (int i = 0; i < failed.size(); i++){
+        snprintf(tmp, sizeof(tmp), " %s%d", sign(failed[i]) ? "-" : "", var(failed[i]) + 1);
+        append(tmp); }
+    append(" 0\n");
+
+    if (++pending < batch && realTime() - last_sync < interval)
+        return false;
+    emit();
+    return true;
+}
+
+
+// Writes the buffered records. They reach the page cache only, which is cheap enough to do while
+// holding the lock that orders the records; the 'fsync()' is left to 'flush()'.
+inline void CubeJournal::emit()
+{
+    last_sync = realTime();
+    if (fd < 0 || buf.size() == 0) return;
+    for (int done = 0; done < buf.size(); ){
+        ssize_t n = write(fd, (const char*)buf + done, buf.size() - done);
+        if (n <= 0){
+            fprintf(stderr, "c WARNING! Could not write the cube journal.\n");
+            break; }
+        done += n;
+    }
+    buf.clear();
+    pending = 0;
+}
+
+//=================================================================================================
+}
+
+#endif
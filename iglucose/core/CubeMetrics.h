@@ -0,0 +1,161 @@
+/***********************************************************************************[CubeMetrics.h]
+ iGlucose -- metrics snapshots of a cube-and-conquer run
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Glucose_CubeMetrics_h
+#define Glucose_CubeMetrics_h
+
+#include <stdio.h>
+#include <math.h>
+
+#include "mtl/Vec.h"
+#include "core/SolverTypes.h"
+#include "utils/System.h"
+
+namespace Glucose {
+
+//=================================================================================================
+// CubeMetrics -- machine-readable progress of the cube loop.
+//
+// The driver reports every cube it starts and finishes. At most once per 'interval' seconds of
+// wall-clock time a JSON snapshot is written to a temporary file which is then renamed over the
+// metrics file, so readers never see a partial snapshot. Not thread-safe: the parallel driver
+// calls it under its lock. Without a file nothing is timed.
+
+class CubeMetrics {
+    struct Worker {
+        int      cube;       // Cube being solved, or -1 when idle.
+        double   since;      // Wall-clock time the cube was started.
+        uint64_t conflicts;  // Conflicts of the worker at its last finished cube.
+    };
+
+    enum { nbuckets = 32 };   // Bucket 'i > 0' counts solve times in [2^(i-1), 2^i) ms.
+
+    const char*  file;
+    double       interval;
+    double       start, last;
+    int          total, solved, npruned, nresumed, nsat;
+    double       done;       // Fraction of the search space covered, each cube counts 2^-size.
+    uint64_t     hist[nbuckets];
+    double       max_time;
+    vec<Worker>  workers;
+
+    uint64_t conflicts() const {
+        uint64_t n = 0;
+        for (int i = 0; i < workers.size(); i++) n += workers[i].conflicts;
+        return n; }
+    double   percentile(double p) const;
+
+public:
+    CubeMetrics(const char* file_, double interval_, int nworkers, int ncubes)
+        : file(file_), interval(interval_), start(realTime()), last(start), total(ncubes)
+        , solved(0), npruned(0), nresumed(0), nsat(0), done(0), max_time(0)
+    {
+        for (int i = 0; i < nbuckets; i++) hist[i] = 0;
+        workers.growTo(nworkers);
+        for (int i = 0; i < nworkers; i++){
+            workers[i].cube = -1; workers[i].since = start; workers[i].conflicts = 0; }
+    }
+
+    int  addWorker () {
+        workers.push();
+        workers.last().cube = -1; workers.last().since = realTime(); workers.last().conflicts = 0;
+        return workers.size() - 1; }
+    void startCube (int worker, int cube) {
+        if (file == NULL) return;
+        workers[worker].cube = cube; workers[worker].since = realTime(); }
+    void finishCube(int worker, int size, lbool ret, uint64_t conflicts);
+    void prunedCube(int size)             { npruned++; done += pow(0.5, size); }
+    void resumedCube(int size)            { nresumed++; done += pow(0.5, size); }
+    void setTotal  (int ncubes)           { total = ncubes; }
+    bool due       ()               const { return file != NULL && realTime() - last >= interval; }
+    void write     (bool final = false);
+};
+
+
+//=================================================================================================
+// Implementation of inline methods:
+
+inline void CubeMetrics::finishCube(int worker, int size, lbool ret, uint64_t conflicts)
+{
+    if (file == NULL) return;
+    Worker& w = workers[worker];
+    double  t = realTime() - w.since;
+    int     b = 0;
+    for (double ms = t * 1000; ms >= 1 && b < nbuckets - 1; ms /= 2) b++;
+    hist[b]++;
+    if (t > max_time) max_time = t;
+
+    solved++;
+    if (ret == l_True) nsat++;
+    done += pow(0.5, size);
+    w.cube      = -1;
+    w.conflicts = conflicts;
+}
+
+
+// Upper bound of the bucket holding the 'p'-th fraction of the solve times, in seconds.
+inline double CubeMetrics::percentile(double p) const
+{
+    uint64_t seen = 0, target = (uint64_t)ceil(p * solved);
+    for (int i = 0; i < nbuckets; i++){
+        seen += hist[i];
+        if (seen >= target && seen > 0) return ldexp(1.0, i) / 1000; }
+    return 0;
+}
+
+
+inline void CubeMetrics::write(bool final)
+{
+    if (file == NULL) return;
+    double now = realTime(), elapsed = now - start;
+    last = now;
+
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", file);
+    FILE* f = fopen(tmp, "w");
+    if (f == NULL) return;
+
+    fprintf(f, "{\n  \"tool\": \"iglucose\",\n  \"final\": %s,\n  \"elapsed\": %.3f,\n", final ? "true" : "false", elapsed);
+    fprintf(f, "  \"cubes\": { \"total\": %d, \"solved\": %d, \"pruned\": %d, \"resumed\": %d, \"sat\": %d, \"pending\": %d },\n",
+            total, solved, npruned, nresumed, nsat, total - solved - npruned - nresumed);
+    fprintf(f, "  \"cubes_per_sec\": %.2f,\n", elapsed > 0 ? solved / elapsed : 0);
+    fprintf(f, "  \"conflicts\": %llu,\n  \"conflicts_per_sec\": %.0f,\n",
+            (unsigned long long)conflicts(), elapsed > 0 ? conflicts() / elapsed : 0);
+    fprintf(f, "  \"done\": %.6f,\n  \"eta\": %.1f,\n", done, done > 0 ? elapsed / done - elapsed : -1);
+    fprintf(f, "  \"solve_time\": { \"p50\": %g, \"p90\": %g, \"p99\": %g, \"max\": %.3f, \"histogram_ms\": [",
+            percentile(0.5), percentile(0.9), percentile(0.99), max_time);
+    int hi = nbuckets;
+    while (hi > 1 && hist[hi - 1] == 0) hi--;
+    for (int i = 0; i < hi; i++)
+        fprintf(f, "%s%llu", i ? ", " : "", (unsigned long long)hist[i]);
+    fprintf(f, "] },\n  \"workers\": [");
+    for (int i = 0; i < workers.size(); i++)
+        fprintf(f, "%s\n    { \"id\": %d, \"state\": \"%s\", \"cube\": %d, \"cube_time\": %.3f, \"conflicts\": %llu }",
+                i ? "," : "", i, workers[i].cube >= 0 ? "solving" : "idle", workers[i].cube,
+                workers[i].cube >= 0 ? now - workers[i].since : 0, (unsigned long long)workers[i].conflicts);
+    fprintf(f, "\n  ]\n}\n");
+
+    if (fclose(f) == 0)
+        rename(tmp, file);
+}
+
+//=================================================================================================
+}
+
+#endif
@@ -0,0 +1,272 @@
+/***********************************************************************************[CubeRouter.h]
+ iGlucose -- routing of cubes to look-ahead or CDCL
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Glucose_CubeRouter_h
+#define Glucose_CubeRouter_h
+
+#include <stdio.h>
+#include <math.h>
+
+#include "mtl/Vec.h"
+#include "mtl/Sort.h"
+#include "core/Solver.h"
+#include "core/CubeTrie.h"
+#include "utils/System.h"
+
+#ifdef GLUCOSE_MARCH
+#include "march_cu/libmarch.h"
+#endif
+
+namespace Glucose {
+
+//=================================================================================================
+// CubeRouter -- sends every cube to the look-ahead solver of march_cu (its plain mode, through
+// libmarch) or to CDCL.
+//
+// The features of a cube come from one pass over the problem clauses under the propagated cube
+// (see 'Solver::cubeShape()'). 'calibrate()' solves cubes spread over the cube file with both
+// engines and picks the rule with the least total time on them: every cube to CDCL, or a decision
+// stump on one feature. A look-ahead run that reaches 'limit' dead ends is finished by CDCL, which
+// the calibration charges to the look-ahead. While calibrating, CDCL stops after 'limit' conflicts
+// as well and its learnt clauses are removed again. The sampled cubes are solved again by the cube
+// loop. Samples that take less than 'minTime' together are mostly timer noise and keep every
+// cube on CDCL.
+
+class CubeRouter {
+public:
+    enum { nfeatures = 6 };
+
+private:
+    struct Sample {
+        double f[nfeatures];
+        double la, cdcl;     // Seconds, 'la' includes CDCL if the look-ahead gave up.
+    };
+
+    struct FeatureLt {
+        const vec<Sample>& samples;
+        int                k;
+        FeatureLt(const vec<Sample>& s, int k_) : samples(s), k(k_) {}
+        bool operator()(int i, int j) const { return samples[i].f[k] < samples[j].f[k]; }
+    };
+
+    int          limit;
+    double       minTime;
+    int          feature;    // -1 if every cube goes to CDCL.
+    double       threshold;
+    bool         above;      // Look-ahead if the feature is at least (or below) the threshold.
+    vec<Sample>  samples;
+    vec<int>     lengths;
+    int          nla, ncdcl, nfallback;
+
+    bool  features      (Solver& S, const vec<Lit>& cube, double* f);
+    bool  toLookahead   (const double* f) const {
+        return feature >= 0 && (f[feature] >= threshold) == above; }
+    lbool solveLookahead(Solver& S, const vec<Lit>& cube);
+
+public:
+    CubeRouter(int limit_, double minTime_)
+        : limit(limit_), minTime(minTime_), feature(-1), threshold(0), above(true), nla(0), ncdcl(0), nfallback(0) {
+        lengths.growTo(5, 0); }
+
+    static bool        available() {
+#ifdef GLUCOSE_MARCH
+        return true;
+#else
+        return false;
+#endif
+    }
+    static const char* name(int k) {
+        static const char* names[nfeatures] = { "binary", "ternary", "ratio", "assigned", "size", "free" };
+        return names[k]; }
+
+    // Solves up to 'nsample' pending cubes with ids 'from', 'from + inc', ... 'to', spread evenly.
+    void  calibrate(Solver& S, CubeTrie& cubes, int from, int to, int inc, int nsample);
+    lbool solve    (Solver& S, const vec<Lit>& cube);
+    void  printStats() const {
+        printf("c hybrid cubes          : %d look-ahead (%d finished by CDCL), %d CDCL\n", nla, nfallback, ncdcl); }
+};
+
+
+//=================================================================================================
+// Implementation of the router:
+
+
+// The fractions of binary and ternary clauses, the clause/variable ratio, the fraction of the free
+// variables the cube assigns, the size of the cube and the free variables under it. Returns FALSE
+// if propagation refutes the cube.
+inline bool CubeRouter::features(Solver& S, const vec<Lit>& cube, double* f)
+{
+    int assigned;
+    if (S.cubeShape(cube, lengths, assigned) == l_False) return false;
+
+    double n    = lengths[2] + lengths[3] + lengths[4];
+    double free = S.nFreeVars() - assigned;
+    f[0] = n > 0 ? lengths[2] / n : 0;
+    f[1] = n > 0 ? lengths[3] / n : 0;
+    f[2] = free > 0 ? n / free : 0;
+    f[3] = S.nFreeVars() > 0 ? assigned / (double)S.nFreeVars() : 1;
+    f[4] = cube.size();
+    f[5] = free;
+    return true;
+}
+
+
+// Solves the formula under 'cube' with march_cu's look-ahead solver. A model is extended with the
+// units and equivalences of 'Solver::reduceCube()'. A refutation sets 'S.conflict' to the whole
+// cube. Returns l_Undef if the look-ahead reaches its limit.
+inline lbool CubeRouter::solveLookahead(Solver& S, const vec<Lit>& cube)
+{
+    vec<Lit> out, units, repr;
+    lbool    ret = S.reduceCube(cube, out, units, repr);
+    vec<int> map(S.nVars(), 0);
+    vec<int> val(S.nVars(), 0);
+
+#ifdef GLUCOSE_MARCH
+    if (ret == l_Undef){
+        March* m = march_new();
+        int    max = 0;
+        march_set_option(m, "p", 1);
+        if (limit > 0) march_set_option(m, "L", limit);
+        for (int i = 0; i < out.size(); i++){
+            if (out[i] == lit_Undef){ march_add(m, 0); continue; }
+            Var v = var(out[i]);
+            if (map[v] == 0) map[v] = ++max;
+            march_add(m, sign(out[i]) ? -map[v] : map[v]); }
+
+        int res = march_cube(m);
+        if (res == 10){
+            ret = l_True;
+            for (Var v = 0; v < S.nVars(); v++)
+                if (map[v]) val[v] = march_val(m, map[v]) > 0 ? 1 : -1;
+        }else if (res == 20)
+            ret = l_False;
+        march_delete(m);
+    }
+#endif
+
+    if (ret == l_False){
+        S.conflict.clear();
+        for (int i = 0; i < cube.size(); i++) S.conflict.push(~cube[i]);
+    }else if (ret == l_True){
+        for (int i = 0; i < units.size(); i++)
+            val[var(units[i])] = sign(units[i]) ? -1 : 1;
+        S.model.clear();
+        for (Var v = 0; v < S.nVars(); v++)
+            S.model.push(val[v] > 0 ? l_True : l_False);
+        for (Var v = 0; v < S.nVars() && repr.size() > 0; v++){
+            Lit p = repr[toInt(mkLit(v))];
+            if (var(p) != v && val[v] == 0) S.model[v] = S.model[var(p)] ^ sign(p); }
+    }
+    return ret;
+}
+
+
+inline void CubeRouter::calibrate(Solver& S, CubeTrie& cubes, int from, int to, int inc, int nsample)
+{
+    vec<Lit> cube;
+    int      pending = 0;
+    for (int id = from; id < cubes.size() && id <= to; id += inc) pending += cubes.pending(id);
+    int      stride  = pending > nsample ? pending / nsample : 1;
+
+    samples.clear();
+    for (int id = from, k = 0; id < cubes.size() && id <= to && samples.size() < nsample; id += inc){
+        if (!cubes.pending(id) || k++ % stride != 0) continue;
+        cubes.cube(id, cube);
+        Sample s;
+        if (!features(S, cube, s.f)) continue;
+
+        // Every sample starts from the same clauses, the learnt ones of earlier samples would make
+        // later CDCL runs look faster:
+        S.markLearnts();
+        double start = realTime();
+        if (limit > 0) S.setConfBudget(limit);
+        lbool  ret   = S.simplify() ? S.solveLimited(cube) : l_False;
+        s.cdcl = realTime() - start;
+        S.budgetOff();
+        if (!S.okay()) break;
+        S.removeNewLearnts();
+
+        start = realTime();
+        lbool la = solveLookahead(S, cube);
+        s.la = realTime() - start + (la == l_Undef ? s.cdcl : 0);
+        samples.push(s);
+        if (ret == l_True || la == l_True) break;
+    }
+
+    // Every cube to CDCL, unless a stump does better:
+    double best = 0, total_la = 0;
+    for (int i = 0; i < samples.size(); i++){
+        best     += samples[i].cdcl;
+        total_la += samples[i].la; }
+    double total_cdcl = best;
+    feature = -1;
+
+    vec<int> order;
+    for (int k = 0; total_la + total_cdcl >= minTime && k < nfeatures; k++){
+        order.clear();
+        for (int i = 0; i < samples.size(); i++) order.push(i);
+        sort(order, FeatureLt(samples, k));
+
+        // Split after the first 'i' samples, look-ahead above or below:
+        double la_below = 0, cdcl_below = 0;
+        for (int i = 0; i <= order.size(); i++){
+            if (i > 0){
+                la_below   += samples[order[i - 1]].la;
+                cdcl_below += samples[order[i - 1]].cdcl; }
+            if (i > 0 && i < order.size() && samples[order[i - 1]].f[k] == samples[order[i]].f[k]) continue;
+            double t = i == 0 ? -HUGE_VAL : i == order.size() ? HUGE_VAL
+                     : (samples[order[i - 1]].f[k] + samples[order[i]].f[k]) / 2;
+            double cost_above = cdcl_below + (total_la - la_below);
+            double cost_below = la_below + (total_cdcl - cdcl_below);
+            if (cost_above < best){ best = cost_above; feature = k; threshold = t; above = true; }
+            if (cost_below < best){ best = cost_below; feature = k; threshold = t; above = false; }
+        }
+    }
+
+    printf("c hybrid calibration    : %d cubes, %.2f s look-ahead, %.2f s CDCL, %.2f s routed\n",
+           samples.size(), total_la, total_cdcl, best);
+    if (feature < 0 && total_la + total_cdcl < minTime)
+        printf("c hybrid rule           : every cube to CDCL (samples below %.2f s)\n", minTime);
+    else if (feature < 0)
+        printf("c hybrid rule           : every cube to CDCL\n");
+    else if (threshold == -HUGE_VAL || threshold == HUGE_VAL)
+        printf("c hybrid rule           : every cube to look-ahead\n");
+    else
+        printf("c hybrid rule           : look-ahead if %s %s %g\n", name(feature), above ? ">=" : "<", threshold);
+}
+
+
+inline lbool CubeRouter::solve(Solver& S, const vec<Lit>& cube)
+{
+    double f[nfeatures];
+    if (features(S, cube, f) && toLookahead(f)){
+        nla++;
+        lbool ret = solveLookahead(S, cube);
+        if (ret != l_Undef) return ret;
+        nfallback++;
+    }else
+        ncdcl++;
+    return S.solveLimited(cube);
+}
+
+
+//=================================================================================================
+}
+
+#endif
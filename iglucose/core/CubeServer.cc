@@ -0,0 +1,447 @@
+/***********************************************************************************[CubeServer.cc]
+ iGlucose -- cube dispatch server and its worker connection
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "utils/System.h"
+#include "core/CubeServer.h"
+
+using namespace Glucose;
+
+//=================================================================================================
+// Sockets:
+
+
+int Glucose::openCubeSocket(const char* addr, bool server)
+{
+    int one = 1;
+    if (strncmp(addr, "unix:", 5) == 0){
+        sockaddr_un sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sun_family = AF_UNIX;
+        if (strlen(addr + 5) >= sizeof(sa.sun_path)) return -1;
+        strcpy(sa.sun_path, addr + 5);
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        if (server) unlink(sa.sun_path);
+        if (server ? bind(fd, (sockaddr*)&sa, sizeof(sa)) != 0 || listen(fd, 64) != 0
+                   : connect(fd, (sockaddr*)&sa, sizeof(sa)) != 0){
+            close(fd); return -1; }
+        return fd; }
+
+    char        host[256] = "";
+    const char* port      = strrchr(addr, ':');
+    if (port != NULL){
+        if (port - addr >= (int)sizeof(host)) return -1;
+        memcpy(host, addr, port - addr);
+        host[port - addr] = 0;
+        port++;
+    }else
+        port = addr;
+
+    addrinfo hints, *res;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags    = server ? AI_PASSIVE : 0;
+    if (getaddrinfo(host[0] ? host : NULL, port, &hints, &res) != 0) return -1;
+
+    int fd = -1;
+    for (addrinfo* a = res; a != NULL && fd < 0; a = a->ai_next){
+        if ((fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol)) < 0) continue;
+        if (server) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        else        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (server ? bind(fd, a->ai_addr, a->ai_addrlen) != 0 || listen(fd, 64) != 0
+                   : connect(fd, a->ai_addr, a->ai_addrlen) != 0){
+            close(fd); fd = -1; }
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+
+bool CubeChannel::fill()
+{
+    if (head > 0){
+        for (int i = head; i < in.size(); i++) in[i - head] = in[i];
+        in.shrink(head);
+        head = 0; }
+    char tmp[65536];
+    ssize_t n;
+    do n = read(fd, tmp, sizeof(tmp)); while (n < 0 && errno == EINTR);
+    if (n <= 0) return false;
+    for (int i = 0; i < n; i++) in.push(tmp[i]);
+    return true;
+}
+
+
+char* CubeChannel::line()
+{
+    for (int i = head; i < in.size(); i++)
+        if (in[i] == '\n'){
+            char* l = &in[head];
+            in[i] = 0;
+            head  = i + 1;
+            return l; }
+    return NULL;
+}
+
+
+void CubeChannel::putInt(int64_t v)
+{
+    char tmp[24];
+    snprintf(tmp, sizeof(tmp), " %lld", (long long)v);
+    put(tmp);
+}
+
+
+bool CubeChannel::flush()
+{
+    for (int done = 0; done < out.size(); ){
+        ssize_t n = send(fd, (const char*)out + done, out.size() - done, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0){ out.clear(); return false; }
+        done += n; }
+    out.clear();
+    return true;
+}
+
+
+void CubeChannel::close()
+{
+    if (fd >= 0){ ::close(fd); fd = -1; }
+}
+
+
+// Reads a DIMACS literal or integer from 'p' and advances it. FALSE if there is none.
+static bool readCubeInt(char*& p, int64_t& v)
+{
+    char* end;
+    v = strtoll(p, &end, 10);
+    if (end == p) return false;
+    p = end;
+    return true;
+}
+
+static bool readCubeLits(char*& p, vec<Lit>& lits)
+{
+    int64_t v;
+    bool    ok;
+    lits.clear();
+    while ((ok = readCubeInt(p, v)) && v != 0)
+        lits.push(mkLit((int)(v < 0 ? -v : v) - 1, v < 0));
+    return ok;
+}
+
+
+//=================================================================================================
+// Server:
+
+
+CubeServer::~CubeServer()
+{
+    for (int i = 0; i < clients.size(); i++) delete clients[i];
+    if (listener >= 0) close(listener);
+    if (path != NULL) unlink(path);
+}
+
+
+bool CubeServer::open(const char* addr)
+{
+    if (strncmp(addr, "unix:", 5) == 0) path = addr + 5;
+    return (listener = openCubeSocket(addr, true)) >= 0;
+}
+
+
+// A cube to hand out again goes to a worker that did not leave it unsolved, if any other cube is
+// left for 'c'.
+int CubeServer::take(const Client& c)
+{
+    for (int i = retry.size() - 1; i >= 0; i--){
+        if (!cubes.pending(retry[i])){
+            retry[i] = retry.last(); retry.pop();
+            retryFrom[i] = retryFrom.last(); retryFrom.pop();
+            continue; }
+        if (retryFrom[i] == c.slot) continue;
+        int id = retry[i];
+        retry[i] = retry.last(); retry.pop();
+        retryFrom[i] = retryFrom.last(); retryFrom.pop();
+        return id; }
+    while (next < cubes.size())
+        if (cubes.pending(next++)) return next - 1;
+    if (retry.size() > 0){
+        int id = retry.last();
+        retry.pop(); retryFrom.pop();
+        return id; }
+    return -1;
+}
+
+
+void CubeServer::serve(Client& c)
+{
+    // Near the end smaller batches keep the workers busy until the last cube:
+    int unsent = retry.size() + cubes.size() - next;
+    int n      = unsent / (2 * clients.size());
+    if (n < 1)      n = 1;
+    if (n > c.want) n = c.want;
+    int sent   = 0;
+
+    vec<Lit> cube;
+    for (int id; sent < n && (id = take(c)) >= 0; sent++){
+        cubes.cube(id, cube);
+        c.ch.put("c");
+        c.ch.putInt(id);
+        for (int i = 0; i < cube.size(); i++) c.ch.putLit(cube[i]);
+        c.ch.put(" 0\n");
+        if (c.outstanding.size() == 0) metrics.startCube(c.slot, id);
+        c.outstanding.push(id); }
+
+    if (sent > 0){
+        c.ch.put("e\n");
+        c.want = 0; }
+}
+
+
+// A worker went away, its unreported cubes are handed out again.
+void CubeServer::drop(int i)
+{
+    Client* c = clients[i];
+    for (int j = c->outstanding.size() - 1; j >= 0; j--)
+        if (cubes.pending(c->outstanding[j])){
+            retry.push(c->outstanding[j]);
+            retryFrom.push(-1); }
+    metrics.startCube(c->slot, -1);
+    printf("c worker %d disconnected, %d cubes handed out again\n", c->slot, c->outstanding.size());
+    delete c;
+    clients[i] = clients.last();
+    clients.pop();
+}
+
+
+// Returns FALSE on a protocol error.
+bool CubeServer::handle(Client& c, char* line)
+{
+    char     cmd = *line++;
+    int64_t  id, conflicts;
+    vec<Lit> lits;
+
+    if (cmd == 'g'){
+        if (!readCubeInt(line, id) || id <= 0) return false;
+        c.want = (int)id;
+        return true; }
+
+    if (!readCubeInt(line, id) || id < 0 || id >= cubes.size()) return false;
+    for (int i = 0; i < c.outstanding.size(); i++)
+        if (c.outstanding[i] == id){
+            for (int j = i + 1; j < c.outstanding.size(); j++) c.outstanding[j - 1] = c.outstanding[j];
+            c.outstanding.pop();
+            break; }
+
+    if (cmd == 'x'){
+        if (cubes.pending(id)){
+            retry.push((int)id);
+            retryFrom.push(c.slot); }
+        metrics.startCube(c.slot, c.outstanding.size() > 0 ? c.outstanding[0] : -1);
+        return true; }
+
+    if (!readCubeInt(line, conflicts) || !readCubeLits(line, lits)) return false;
+    vec<Lit> cube;
+    cubes.cube(id, cube);
+    if (cmd == 's'){
+        sat = true;
+        model->clear();
+        for (int i = 0; i < lits.size(); i++){
+            if (model->size() <= var(lits[i])) model->growTo(var(lits[i]) + 1, l_Undef);
+            (*model)[var(lits[i])] = lbool(!sign(lits[i])); }
+        metrics.finishCube(c.slot, cube.size(), l_True, conflicts);
+    }else if (cmd == 'u'){
+        if (cubes.pending(id)){
+            // Without pruning the cubes still have to be dropped if the formula is unsatisfiable:
+            cubes.finish(id);
+            if (prune || lits.size() == 0) cubes.prune(lits);
+            if (journal.record(id, lits)) journal.flush();
+            metrics.finishCube(c.slot, cube.size(), l_False, conflicts); }
+    }else
+        return false;
+
+    metrics.startCube(c.slot, c.outstanding.size() > 0 ? c.outstanding[0] : -1);
+    return true;
+}
+
+
+lbool CubeServer::run(vec<lbool>& m)
+{
+    model = &m;
+    vec<pollfd> fds;
+    while (!sat && !indet && cubes.nPending() > 0){
+        fds.clear();
+        fds.push();
+        fds.last().fd = listener; fds.last().events = POLLIN;
+        for (int i = 0; i < clients.size(); i++){
+            fds.push();
+            fds.last().fd = clients[i]->ch.socket(); fds.last().events = POLLIN; }
+
+        if (poll(fds, fds.size(), 1000) < 0){
+            if (errno == EINTR) printf("c cube server interrupted\n");
+            else                printf("c ERROR! Cube server poll failed: %s\n", strerror(errno));
+            indet = true;
+            break; }
+
+        // Clients before index 'fds.size() - 1' are polled, dropping one moves the last one forward:
+        for (int i = fds.size() - 2; i >= 0; i--){
+            if (!(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            Client& c = *clients[i];
+            bool    ok = c.ch.fill();
+            for (char* l; ok && (l = c.ch.line()) != NULL; )
+                if (!handle(c, l)){
+                    printf("c ERROR! Protocol error from worker %d: %s\n", c.slot, l);
+                    ok = false; }
+            if (!ok) drop(i); }
+
+        if (fds[0].revents & POLLIN){
+            int fd = accept(listener, NULL, NULL);
+            if (fd >= 0){
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                clients.push(new Client(fd, metrics.addWorker()));
+                printf("c worker %d connected\n", clients.last()->slot); } }
+
+        for (int i = 0; i < clients.size(); i++){
+            if (clients[i]->want > 0) serve(*clients[i]);
+            clients[i]->ch.flush(); }
+        if (metrics.due()) metrics.write();
+    }
+
+    lbool ret  = sat ? l_True : cubes.nPending() == 0 ? l_False : l_Undef;
+    int   code = ret == l_True ? 10 : ret == l_False ? 20 : 0;
+    char  tmp[16];
+    snprintf(tmp, sizeof(tmp), "q %d\n", code);
+    for (int i = 0; i < clients.size(); i++){
+        clients[i]->ch.put(tmp);
+        clients[i]->ch.flush();
+        clients[i]->ch.close(); }
+    return ret;
+}
+
+
+//=================================================================================================
+// Client:
+
+
+bool CubeClient::connect(const char* addr, double timeout)
+{
+    for (double start = realTime(); ; usleep(100000)){
+        int fd = openCubeSocket(addr, false);
+        if (fd >= 0){ ch.attach(fd); return true; }
+        if (realTime() - start >= timeout) return false; }
+}
+
+
+bool CubeClient::receive(bool wait_for_batch)
+{
+    vec<Lit> lits;
+    for (;;){
+        for (char* l; (l = ch.line()) != NULL; ){
+            int64_t v;
+            if (l[0] == 'c' && readCubeInt(++l, v) && readCubeLits(l, lits)){
+                ids.push((int)v);
+                queue.push();
+                lits.copyTo(queue.last());
+            }else if (l[0] == 'e')
+                wait_for_batch = false;
+            else if (l[0] == 'q' && readCubeInt(++l, v)){
+                code = (int)v;
+                return false; } }
+        if (!wait_for_batch) return true;
+        if (!ch.fill()){ code = 0; return false; } }
+}
+
+
+bool CubeClient::next(int& id, vec<Lit>& cube)
+{
+    if (code >= 0) return false;
+    if (head == ids.size()){
+        ids.clear();
+        queue.clear();
+        head = 0;
+        char tmp[32];
+        snprintf(tmp, sizeof(tmp), "g %d\n", batch);
+        ch.put(tmp);
+        ch.flush();    // On failure the result of the run may still be waiting in the socket.
+        if (!receive(true)){
+            if (code < 0) code = 0;
+            return false; } }
+    id = ids[head];
+    queue[head++].copyTo(cube);
+    return true;
+}
+
+
+bool CubeClient::cancelled()
+{
+    if (code >= 0) return true;
+    pollfd p;
+    p.fd = ch.socket(); p.events = POLLIN;
+    if (!ch.buffered() && poll(&p, 1, 0) <= 0) return false;
+    if (!ch.buffered() && !ch.fill()){ code = 0; return true; }
+    receive(false);
+    return code >= 0;
+}
+
+
+void CubeClient::refuted(int id, uint64_t conflicts, const vec<Lit>& failed)
+{
+    ch.put("u");
+    ch.putInt(id);
+    ch.putInt(conflicts);
+    for (int i = 0; i < failed.size(); i++) ch.putLit(failed[i]);
+    ch.put(" 0\n");
+    ch.flush();
+}
+
+
+void CubeClient::satisfied(int id, uint64_t conflicts, const vec<lbool>& model)
+{
+    ch.put("s");
+    ch.putInt(id);
+    ch.putInt(conflicts);
+    for (int i = 0; i < model.size(); i++)
+        if (model[i] != l_Undef) ch.putLit(mkLit(i, model[i] == l_False));
+    ch.put(" 0\n");
+    ch.flush();
+}
+
+
+void CubeClient::unknown(int id)
+{
+    ch.put("x");
+    ch.putInt(id);
+    ch.put("\n");
+    ch.flush();
+}
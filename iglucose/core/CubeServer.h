@@ -0,0 +1,166 @@
+/************************************************************************************[CubeServer.h]
+ iGlucose -- cube dispatch server and its worker connection
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Glucose_CubeServer_h
+#define Glucose_CubeServer_h
+
+#include <stdint.h>
+
+#include "mtl/Vec.h"
+#include "core/SolverTypes.h"
+#include "core/CubeTrie.h"
+#include "core/CubeJournal.h"
+#include "core/CubeMetrics.h"
+
+namespace Glucose {
+
+//=================================================================================================
+// Cube protocol -- one command per line over a Unix socket ('unix:PATH') or TCP ('HOST:PORT' or
+// 'PORT'). All literals are DIMACS integers, cube ids count the cubes of the iCNF file from 0.
+//
+//   worker -> server:  'g <n>'                           request up to 'n' cubes
+//                      'u <id> <conflicts> <failed> 0'   cube refuted with these failed assumptions
+//                      's <id> <conflicts> <model> 0'    cube satisfiable
+//                      'x <id>'                          cube left unsolved
+//   server -> worker:  'c <id> <literals> 0'             one cube of a batch
+//                      'e'                               end of the batch
+//                      'q <result>'                      end of the run (10, 20 or 0 = unknown)
+//
+// The server hands out the pending cubes in file order, so the cubes of one batch share long
+// prefixes and one round trip pays for many cubes. Requests that can not be served are parked
+// until a cube becomes available again (its worker disconnected or left it unsolved) or the run
+// ends. A cube left unsolved goes to another worker if there is one. Apart from 'q' the server
+// only sends in reply to 'g', which lets a worker treat any input while it is solving as
+// cancellation. ilingeling speaks the same protocol with its '-c' option.
+
+// Opens a listening socket ('server') or a connection to 'addr'. Returns -1 on failure.
+int openCubeSocket(const char* addr, bool server);
+
+
+//=================================================================================================
+// CubeChannel -- buffered line input and output on a socket.
+
+class CubeChannel {
+    int       fd;
+    vec<char> in, out;
+    int       head;           // Start of the unread input.
+
+public:
+    CubeChannel(int fd_ = -1) : fd(fd_), head(0) {}
+    ~CubeChannel() { close(); }
+
+    void attach  (int fd_)      { close(); fd = fd_; in.clear(); out.clear(); head = 0; }
+    int  socket  () const { return fd; }
+    bool buffered() const { return head < in.size(); }
+
+    // Reads the available input, blocking until there is some. FALSE on end of file or error.
+    bool  fill   ();
+    // Returns the next complete line without its newline, or NULL. Valid until the next 'fill()'.
+    char* line   ();
+
+    void put    (const char* s) { while (*s) out.push(*s++); }
+    void putInt (int64_t v);
+    void putLit (Lit p)         { putInt(sign(p) ? -(var(p) + 1) : var(p) + 1); }
+
+    bool flush  ();
+    void close  ();
+};
+
+
+//=================================================================================================
+// CubeServer -- owns the pending cubes, the journal and the metrics of a distributed run.
+
+class CubeServer {
+    struct Client {
+        CubeChannel ch;
+        vec<int>    outstanding;  // Cubes sent but not reported, in the order they were sent.
+        int         want;         // Cubes of a parked request.
+        int         slot;         // Worker index in the metrics.
+        Client(int fd, int slot_) : ch(fd), want(0), slot(slot_) {}
+    };
+
+    CubeTrie&     cubes;
+    CubeJournal&  journal;
+    CubeMetrics&  metrics;
+    bool          prune;
+    int           listener;
+    const char*   path;           // Unix socket to remove at the end, or NULL.
+    vec<Client*>  clients;
+    vec<int>      retry;          // Cubes to hand out again, and the worker that left each unsolved
+    vec<int>      retryFrom;      // (-1 if it disconnected).
+    int           next;           // Next cube id never handed out.
+    bool          indet;          // The server was interrupted.
+    bool          sat;
+    vec<lbool>*   model;
+
+    int  take   (const Client& c);
+    void serve  (Client& c);
+    void drop   (int i);
+    bool handle (Client& c, char* line);
+
+public:
+    CubeServer(CubeTrie& cubes_, CubeJournal& journal_, CubeMetrics& metrics_, bool prune_)
+        : cubes(cubes_), journal(journal_), metrics(metrics_), prune(prune_), listener(-1), path(NULL), next(0)
+        , indet(false), sat(false), model(NULL) {}
+    ~CubeServer();
+
+    bool  open(const char* addr);
+
+    // Serves the cubes until one is satisfiable, all are refuted or the server is interrupted. The
+    // model reported by the winning worker is stored in 'm'.
+    lbool run (vec<lbool>& m);
+};
+
+
+//=================================================================================================
+// CubeClient -- the worker side of the protocol.
+
+class CubeClient {
+    CubeChannel     ch;
+    int             batch;
+    vec<int>        ids;
+    vec<vec<Lit> >  queue;
+    int             head;
+    int             code;      // Result sent with 'q', or -1 while the run goes on.
+
+    bool receive(bool wait_for_batch);
+
+public:
+    CubeClient(int batch_) : batch(batch_), head(0), code(-1) {}
+
+    // Retries for 'timeout' seconds, the server may still be reading its input.
+    bool connect  (const char* addr, double timeout);
+
+    int  socket   () const { return ch.socket(); }
+    int  result   () const { return code; }
+
+    // Next cube to solve, FALSE once the server ended the run.
+    bool next     (int& id, vec<Lit>& cube);
+    // Non-blocking check whether the server ended the run.
+    bool cancelled();
+
+    void refuted  (int id, uint64_t conflicts, const vec<Lit>& failed);
+    void satisfied(int id, uint64_t conflicts, const vec<lbool>& model);
+    void unknown  (int id);
+};
+
+//=================================================================================================
+}
+
+#endif
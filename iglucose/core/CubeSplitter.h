@@ -0,0 +1,207 @@
+/**********************************************************************************[CubeSplitter.h]
+ iGlucose -- cube-and-conquer of hard bounds in one process
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Glucose_CubeSplitter_h
+#define Glucose_CubeSplitter_h
+
+#include <stdio.h>
+
+#include "mtl/Vec.h"
+#include "core/Solver.h"
+
+#ifdef GLUCOSE_MARCH
+#include "march_cu/libmarch.h"
+#endif
+
+namespace Glucose {
+
+//=================================================================================================
+// CubeSplitter -- solves a bound (a set of assumptions) that CDCL does not decide within 'conflicts'
+// by splitting it with the cuber of march_cu (through libmarch) and solving the leaves under the
+// bound with the same solver, so the learnt clauses carry over to the leaves and the later bounds.
+//
+// The leaves of a split, refuted or not, partition the assignments, whatever the formula. The next
+// hard bound therefore starts from the same leaves: those with a literal that is now false at the
+// root are dropped, true literals are removed. So are the leaves with the negation of a literal of
+// the bound, which the bound refutes by itself. A reused leaf that is not decided within 'conflicts'
+// is split once more; the leaves of a split made for the current bound are solved to the end.
+
+class CubeSplitter {
+    int              conflicts;  // 0 if bounds are never split.
+    int              depth;
+    vec<vec<Lit> >   tree;       // Leaves of the last split bound.
+    vec<char>        mark;       // By literal, 1 for the assumptions of the bound, 2 once in the core.
+    int              nsplit, nreused, nleaves;
+
+    struct Leaves {
+        vec<vec<Lit> >*  leaves;
+        const vec<Lit>*  prefix;
+        const vec<Var>*  map;
+    };
+
+    static void leaf (void* state, const int* cube, int size, int refuted);
+    bool        split(Solver& S, const vec<Lit>& bound, const vec<Lit>& prefix, vec<vec<Lit> >& leaves);
+
+public:
+    CubeSplitter(int conflicts_, int depth_)
+        : conflicts(conflicts_), depth(depth_), nsplit(0), nreused(0), nleaves(0) {}
+
+    static bool available() {
+#ifdef GLUCOSE_MARCH
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    lbool solve     (Solver& S, const vec<Lit>& bound);
+    void  printStats() const {
+        printf("c split bounds          : %d split, %d leaves reused, %d leaves solved\n", nsplit, nreused, nleaves); }
+};
+
+
+//=================================================================================================
+// Implementation of the splitter:
+
+
+inline void CubeSplitter::leaf(void* state, const int* cube, int size, int refuted)
+{
+    Leaves& l = *(Leaves*)state;
+    l.leaves->push();
+    vec<Lit>& c = l.leaves->last();
+    l.prefix->copyTo(c);
+    for (int i = 0; i < size; i++)
+        c.push(mkLit((*l.map)[abs(cube[i]) - 1], cube[i] < 0));
+}
+
+
+// Cubes the formula under 'bound' and 'prefix' and appends the leaves, each extending 'prefix'.
+// Returns FALSE if no leaves were made: the cube is refuted or solved by propagation, the cuber
+// decided it, or libmarch is missing.
+inline bool CubeSplitter::split(Solver& S, const vec<Lit>& bound, const vec<Lit>& prefix, vec<vec<Lit> >& leaves)
+{
+    vec<Lit> cube, out, units, repr;
+    bound .copyTo(cube);
+    for (int i = 0; i < prefix.size(); i++) cube.push(prefix[i]);
+    if (S.reduceCube(cube, out, units, repr) != l_Undef) return false;
+
+#ifdef GLUCOSE_MARCH
+    vec<int> ids(S.nVars(), 0);
+    vec<Var> map;
+    March*   m = march_new();
+    march_set_option(m, "d", depth);
+    for (int i = 0; i < out.size(); i++){
+        if (out[i] == lit_Undef){ march_add(m, 0); continue; }
+        Var v = var(out[i]);
+        if (ids[v] == 0){ map.push(v); ids[v] = map.size(); }
+        march_add(m, sign(out[i]) ? -ids[v] : ids[v]); }
+
+    Leaves l;
+    int    before = leaves.size();
+    l.leaves = &leaves;
+    l.prefix = &prefix;
+    l.map    = &map;
+    march_set_cube_callback(m, &l, leaf);
+    int res = march_cube(m);
+    march_delete(m);
+
+    // Solutions and refutations of the cuber are left to CDCL, which certifies them:
+    if (res == 0 && leaves.size() > before) return true;
+    leaves.shrink(leaves.size() - before);
+#endif
+    return false;
+}
+
+
+inline lbool CubeSplitter::solve(Solver& S, const vec<Lit>& bound)
+{
+    if (conflicts == 0) return S.solveLimited(bound);
+
+    S.setConfBudget(conflicts);
+    lbool ret = S.solveLimited(bound);
+    S.budgetOff();
+    if (ret != l_Undef) return ret;
+
+    mark.clear();
+    mark.growTo(2 * S.nVars(), 0);
+    for (int i = 0; i < bound.size(); i++) mark[toInt(bound[i])] = 1;
+
+    // Start from the leaves of the last split bound, or split this one:
+    vec<vec<Lit> > work, next;
+    vec<char>      fresh;
+    for (int i = 0; i < tree.size(); i++){
+        work.push();
+        bool falsified = false;
+        for (int j = 0; j < tree[i].size() && !falsified; j++)
+            if      (S.value(tree[i][j]) == l_False || mark[toInt(~tree[i][j])]) falsified = true;
+            else if (S.value(tree[i][j]) == l_Undef) work.last().push(tree[i][j]);
+        if (falsified) work.pop();
+        else           fresh.push(false); }
+    nreused += work.size();
+    if (work.size() == 0){
+        vec<Lit> empty;
+        if (split(S, bound, empty, work)) nsplit++;
+        else                              work.push();
+        fresh.growTo(work.size(), true); }
+
+    // The leaves are refuted with the union of their failed assumptions among those of the bound:
+    vec<Lit> assumps, prefix, core;
+    int      i;
+    ret = l_False;
+    for (i = 0; i < work.size() && ret == l_False; i++){
+        bound.copyTo(assumps);
+        for (int j = 0; j < work[i].size(); j++) assumps.push(work[i][j]);
+
+        if (!fresh[i]){
+            S.setConfBudget(conflicts);
+            ret = S.solveLimited(assumps);
+            S.budgetOff();
+            work[i].copyTo(prefix);     // 'work' grows while it is split.
+            if (ret == l_Undef && split(S, bound, prefix, work)){
+                nsplit++;
+                fresh.growTo(work.size(), true);
+                ret = l_False;
+                continue; } }
+        if (ret == l_Undef || fresh[i]) ret = S.solveLimited(assumps);
+        nleaves++;
+        next.push();
+        work[i].copyTo(next.last());
+
+        if (ret == l_False){
+            for (int j = 0; j < S.conflict.size(); j++){
+                Lit p = ~S.conflict[j];
+                if (mark[toInt(p)] == 1){ mark[toInt(p)] = 2; core.push(p); } }
+            if (!S.okay()){ i++; break; } }
+    }
+    for (; i < work.size(); i++){
+        next.push();
+        work[i].copyTo(next.last()); }
+    next.moveTo(tree);
+
+    if (ret == l_False){
+        S.conflict.clear();
+        for (int j = 0; j < core.size(); j++) S.conflict.push(~core[j]); }
+    return ret;
+}
+
+
+//=================================================================================================
+}
+
+#endif
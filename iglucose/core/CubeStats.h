@@ -0,0 +1,130 @@
+/************************************************************************************[CubeStats.h]
+ iGlucose -- per-cube statistics
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Glucose_CubeStats_h
+#define Glucose_CubeStats_h
+
+#include <stdio.h>
+#include <string.h>
+
+#include "mtl/Vec.h"
+#include "core/Solver.h"
+#include "utils/System.h"
+
+namespace Glucose {
+
+//=================================================================================================
+// CubeStats -- one record per solved cube, to relate the cubes to what they cost.
+//
+// A record holds the id and size of the cube, its result, the wall-clock time, the conflicts,
+// decisions and propagations of the solver on it, the size of the core of a refuted cube, the learnt
+// clauses kept afterwards and, if iglucose is built with GLUCOSE_PROFILE, the cycles of every phase
+// (see 'Profile.h'). The file is CSV with a header line, or JSON lines if its name ends in ".json"
+// or ".jsonl". Records are written line by line, so an interrupted run keeps those of the finished
+// cubes. Not thread-safe: the parallel driver calls it under its lock.
+
+class CubeStats {
+    FILE*  out;
+    bool   json;
+
+public:
+    // The counters of a solver when it starts a cube.
+    struct Start {
+        double    time;
+        uint64_t  conflicts, decisions, propagations;
+        uint64_t  cycles[nPhases];
+    };
+
+    CubeStats() : out(NULL), json(false) {}
+    ~CubeStats() { if (out != NULL) fclose(out); }
+
+    bool open  (const char* file);
+    bool active() const { return out != NULL; }
+    void start (const Solver& S, Start& s) const;
+    void record(int cube, int worker, int size, lbool ret, const Solver& S, const Start& s);
+};
+
+
+//=================================================================================================
+// Implementation of inline methods:
+
+
+inline bool CubeStats::open(const char* file)
+{
+    if ((out = fopen(file, "w")) == NULL) return false;
+    setvbuf(out, NULL, _IOLBF, 0);
+    int n = strlen(file);
+    json = (n >= 5 && strcmp(file + n - 5, ".json") == 0) || (n >= 6 && strcmp(file + n - 6, ".jsonl") == 0);
+    if (!json){
+        fprintf(out, "cube,worker,size,result,time,conflicts,decisions,propagations,core,learnts");
+        for (int p = 0; p < nPhases && PhaseProfile::enabled(); p++)
+            fprintf(out, ",%s_cycles", PhaseProfile::name(p));
+        fprintf(out, "\n"); }
+    return true;
+}
+
+
+inline void CubeStats::start(const Solver& S, Start& s) const
+{
+    s.time         = realTime();
+    s.conflicts    = S.conflicts;
+    s.decisions    = S.decisions;
+    s.propagations = S.propagations;
+    for (int p = 0; p < nPhases; p++) s.cycles[p] = S.profile.cycles[p];
+}
+
+
+inline void CubeStats::record(int cube, int worker, int size, lbool ret, const Solver& S, const Start& s)
+{
+    if (out == NULL) return;
+    const char* result = ret == l_True ? "sat" : ret == l_False ? "unsat" : "indet";
+    double      time   = realTime() - s.time;
+    int         core   = ret == l_False ? S.conflict.size() : -1;
+
+    if (json){
+        fprintf(out, "{\"cube\": %d, \"worker\": %d, \"size\": %d, \"result\": \"%s\", \"time\": %.6f, "
+                "\"conflicts\": %llu, \"decisions\": %llu, \"propagations\": %llu, ",
+                cube, worker, size, result, time, (unsigned long long)(S.conflicts - s.conflicts),
+                (unsigned long long)(S.decisions - s.decisions), (unsigned long long)(S.propagations - s.propagations));
+        if (core >= 0) fprintf(out, "\"core\": %d, ", core);
+        else           fprintf(out, "\"core\": null, ");
+        fprintf(out, "\"learnts\": %d", S.nLearnts());
+        if (PhaseProfile::enabled()){
+            fprintf(out, ", \"cycles\": {");
+            for (int p = 0; p < nPhases; p++)
+                fprintf(out, "%s\"%s\": %llu", p ? ", " : " ", PhaseProfile::name(p),
+                        (unsigned long long)(S.profile.cycles[p] - s.cycles[p]));
+            fprintf(out, " }"); }
+        fprintf(out, "}\n");
+    }else{
+        fprintf(out, "%d,%d,%d,%s,%.6f,%llu,%llu,%llu,", cube, worker, size, result, time,
+                (unsigned long long)(S.conflicts - s.conflicts), (unsigned long long)(S.decisions - s.decisions),
+                (unsigned long long)(S.propagations - s.propagations));
+        if (core >= 0) fprintf(out, "%d", core);
+        fprintf(out, ",%d", S.nLearnts());
+        for (int p = 0; p < nPhases && PhaseProfile::enabled(); p++)
+            fprintf(out, ",%llu", (unsigned long long)(S.profile.cycles[p] - s.cycles[p]));
+        fprintf(out, "\n");
+    }
+}
+
+//=================================================================================================
+}
+
+#endif
@@ -0,0 +1,200 @@
+/**************************************************************************************[CubeTrie.h]
+ iGlucose -- cube index for the cube-and-conquer driver
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Glucose_CubeTrie_h
+#define Glucose_CubeTrie_h
+
+#include "mtl/Vec.h"
+#include "core/SolverTypes.h"
+
+namespace Glucose {
+
+//=================================================================================================
+// CubeTrie -- the pending cubes of an iCNF file, indexed by literal in file order.
+//
+// Cubes produced by a look-ahead solver share long prefixes, so they are stored as paths in a
+// trie. Every node keeps the number of pending cubes below it and an abstraction of the variables
+// occurring below it. When a cube is refuted with a failed-assumption core, 'prune()' drops every
+// pending cube containing the whole core without calling the solver on it.
+
+class CubeTrie {
+    struct Node {
+        Lit      lit;        // Edge literal from the parent (lit_Undef for the root).
+        int      parent;
+        int      child;      // First child, siblings are linked through 'sibling'.
+        int      sibling;
+        int      ends;       // First cube ending in this node, further ones linked through 'next'.
+        int      live;       // Number of pending cubes in this subtree.
+        uint32_t abst;       // Abstraction of the variables occurring in this subtree.
+    };
+
+    vec<Node>     nodes;
+    vec<int>      leaf;      // 'leaf[id]' is the node in which cube 'id' ends.
+    vec<int>      next;      // Next cube ending in the same node.
+    vec<char>     state;     // 0 = pending, 1 = finished, 2 = pruned.
+    vec<char>     mark;      // Core literals during 'prune()' (1 = open, 2 = matched on the path).
+    const vec<Lit>* core;
+    int           npruned;
+
+    static uint32_t abstractVar(Var v) { return 1 << (v & 31); }
+
+    int  newNode(Lit p, int parent) {
+        nodes.push();
+        Node& n = nodes.last();
+        n.lit = p; n.parent = parent; n.child = n.sibling = n.ends = -1; n.live = 0; n.abst = 0;
+        return nodes.size() - 1; }
+
+    void setMark(Lit p, char v) {
+        if (mark.size() <= toInt(p)) mark.growTo(toInt(p) + 1, 0);
+        mark[toInt(p)] = v; }
+    char getMark(Lit p) const { return toInt(p) < mark.size() ? mark[toInt(p)] : 0; }
+
+    void kill   (int id) { state[id] = 2; npruned++; }
+    int  killAll(int n);
+    int  pruneRec(int n, int open);
+
+public:
+    CubeTrie() : core(NULL), npruned(0) { newNode(lit_Undef, -1); }
+
+    int  size      ()       const { return leaf.size(); }
+    int  nPending  ()       const { return nodes[0].live; }
+    int  nPruned   ()       const { return npruned; }
+    bool pending   (int id) const { return state[id] == 0; }
+    bool pruned    (int id) const { return state[id] == 2; }
+
+    int  insert    (const vec<Lit>& cube);        // Adds a pending cube and returns its id.
+    void cube      (int id, vec<Lit>& out) const; // Retrieves the literals of a cube in file order.
+    void finish    (int id);                      // Removes a solved cube from the pending set.
+    int  prune     (const vec<Lit>& failed);      // Drops all pending cubes containing 'failed'.
+};
+
+
+//=================================================================================================
+// Implementation of inline methods:
+
+inline int CubeTrie::insert(const vec<Lit>& cube)
+{
+    int id = leaf.size();
+    int n  = 0;
+    nodes[0].live++;
+    for (int i = 0; i < cube.size(); i++){
+        int c;
+        for (c = nodes[n].child; c != -1 && nodes[c].lit != cube[i]; c = nodes[c].sibling);
+        if (c == -1){
+            c = newNode(cube[i], n);
+            nodes[c].sibling = nodes[n].child;
+            nodes[n].child   = c; }
+        n = c;
+        nodes[n].live++; }
+
+    // Record the variables on the path in all ancestors:
+    uint32_t abst = 0;
+    for (int m = n; m != -1; m = nodes[m].parent){
+        nodes[m].abst |= abst;
+        if (nodes[m].lit != lit_Undef) abst |= abstractVar(var(nodes[m].lit)); }
+
+    leaf .push(n);
+    next .push(nodes[n].ends);
+    state.push(0);
+    nodes[n].ends = id;
+    return id;
+}
+
+
+inline void CubeTrie::cube(int id, vec<Lit>& out) const
+{
+    out.clear();
+    for (int n = leaf[id]; n != 0; n = nodes[n].parent)
+        out.push(nodes[n].lit);
+    for (int i = 0, j = out.size() - 1; i < j; i++, j--){
+        Lit tmp = out[i]; out[i] = out[j]; out[j] = tmp; }
+}
+
+
+inline void CubeTrie::finish(int id)
+{
+    if (state[id] != 0) return;
+    state[id] = 1;
+    for (int n = leaf[id]; n != -1; n = nodes[n].parent)
+        nodes[n].live--;
+}
+
+
+// Marks every pending cube in the subtree of 'n' as pruned and returns how many there were.
+// Live counters are only updated inside the subtree, the caller fixes the ancestors.
+inline int CubeTrie::killAll(int n)
+{
+    int killed = 0;
+    for (int id = nodes[n].ends; id != -1; id = next[id])
+        if (state[id] == 0) kill(id), killed++;
+    for (int c = nodes[n].child; c != -1; c = nodes[c].sibling)
+        if (nodes[c].live > 0) killed += killAll(c);
+    nodes[n].live = 0;
+    return killed;
+}
+
+
+// Visits the subtree of 'n' where 'open' core literals are still missing on the path. Returns the
+// number of cubes pruned below 'n' and updates the live counters of the subtree.
+inline int CubeTrie::pruneRec(int n, int open)
+{
+    // Abstraction of the variables of the core literals still missing:
+    uint32_t need = 0;
+    for (int i = 0; i < core->size(); i++)
+        if (getMark((*core)[i]) == 1) need |= abstractVar(var((*core)[i]));
+
+    int killed = 0;
+    for (int c = nodes[n].child; c != -1; c = nodes[c].sibling){
+        Lit p = nodes[c].lit;
+        if (nodes[c].live == 0 || getMark(~p)) continue;
+        if (getMark(p) == 1){
+            if (open == 1)
+                killed += killAll(c);
+            else{
+                setMark(p, 2);
+                killed += pruneRec(c, open - 1);
+                setMark(p, 1); }
+        }else if ((need & ~(nodes[c].abst | abstractVar(var(p)))) == 0)
+            killed += pruneRec(c, open);
+        // Otherwise some missing core variable does not occur below 'c'.
+    }
+
+    // Cubes ending in 'n' itself miss 'open' > 0 core literals and stay pending.
+    nodes[n].live -= killed;
+    return killed;
+}
+
+
+inline int CubeTrie::prune(const vec<Lit>& failed)
+{
+    if (nodes[0].live == 0) return 0;
+    if (failed.size() == 0) return killAll(0);
+
+    core = &failed;
+    for (int i = 0; i < failed.size(); i++) setMark(failed[i], 1);
+    int killed = pruneRec(0, failed.size());
+    for (int i = 0; i < failed.size(); i++) setMark(failed[i], 0);
+    core = NULL;
+    return killed;
+}
+
+//=================================================================================================
+}
+
+#endif
@@ -51,8 +51,10 @@ static void readClause(B& in, Solver& S, vec<Lit>& lits) {
     }
 }
 
+// In an iCNF file an 'h' line holds the phase and activity hints for the cubes after it. They are
+// read into 'hints', or skipped if it is NULL. The variables of a 'p cnf' header go to 'declared'.
 template<class B, class Solver>
-static bool parse_DIMACS_main(B& in, Solver& S, vec<Lit>* assumptions = NULL) {
+static bool parse_DIMACS_main(B& in, Solver& S, vec<Lit>* assumptions = NULL, vec<Lit>* hints = NULL, int* declared = NULL) {
     vec<Lit> lits;
     bool dimacsCNF = false;
     bool incCNF    = false;   
@@ -72,6 +74,7 @@ static bool parse_DIMACS_main(B& in, Solver& S, vec<Lit>* assumptions = NULL) {
                     vars     = parseInt(in);
                     clauses  = parseInt(in);
                     dimacsCNF= true;
+                    if (declared != NULL) *declared = vars;
                     // SATRACE'06 hack
                     // if (clauses > 4000000)
                     //     S.eliminate(true);
@@ -88,6 +91,10 @@ static bool parse_DIMACS_main(B& in, Solver& S, vec<Lit>* assumptions = NULL) {
             readClause(in, S, *assumptions); // SW: Not reading a "clause" here, but a sequence of literals anyway
 
             return true;
+        } else if (assumptions != NULL && *in == 'h') {
+            ++in;
+            if (hints != NULL) readClause(in, S, *hints);
+            else               skipLine(in);
         } else if (*in == 'c' || *in == 'p') {
             skipLine(in);
         } else {
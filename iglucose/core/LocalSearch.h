@@ -0,0 +1,163 @@
+/***********************************************************************************[LocalSearch.h]
+ iGlucose -- probSAT local search on the formula under a cube
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Glucose_LocalSearch_h
+#define Glucose_LocalSearch_h
+
+#include <math.h>
+
+#include "mtl/Vec.h"
+#include "core/SolverTypes.h"
+
+namespace Glucose {
+
+//=================================================================================================
+// LocalSearch -- probSAT (Balint and Schoening, SAT 2012) over flat arrays: the clauses are one
+// literal array with offsets, the occurrences of every literal one range of a second array. A
+// flip picks a random falsified clause and one of its variables with a probability that falls with
+// its break value, polynomially for clauses of up to three literals and exponentially for longer
+// ones, with the constants of the paper for the length of that clause.
+
+class LocalSearch {
+    enum { maxBreak = 64 };
+
+    vec<Lit>     lits;       // All clauses, clause 'c' is 'lits[start[c]]' up to 'lits[start[c + 1]]'.
+    vec<int>     start;
+    vec<int>     occStart;   // The clauses of literal 'p' are 'occ[occStart[toInt(p)]]' up to the next.
+    vec<int>     occ;
+    vec<int>     numTrue;    // True literals by clause.
+    vec<int>     falsified;  // The falsified clauses, and the position of each in it (or -1).
+    vec<int>     position;
+    vec<char>    value;      // By variable, 1 if its positive literal is true.
+    vec<double>  probs;      // By length class ('lengthClass()') and break value up to 'maxBreak'.
+    uint64_t     rnd;
+
+    static int lengthClass(int len) { return len <= 3 ? 0 : len == 4 ? 1 : len <= 6 ? 2 : 3; }
+
+    bool     isTrue (Lit p) const { return value[var(p)] == !sign(p); }
+    uint32_t random ()            { rnd ^= rnd << 13; rnd ^= rnd >> 7; rnd ^= rnd << 17; return (uint32_t)(rnd >> 32); }
+    void     add    (int c)       { position[c] = falsified.size(); falsified.push(c); }
+    void     remove (int c)       { int d = falsified.last(); falsified[position[c]] = d; position[d] = position[c];
+                                    falsified.pop(); position[c] = -1; }
+    int      breaks (Var v) const;
+    void     flip   (Var v);
+
+public:
+    vec<char>    best;       // The assignment with the fewest falsified clauses so far.
+    int          bestFalsified;
+    uint64_t     flips;
+
+    // 'clauses' are terminated by 'lit_Undef', over variables below 'nvars'.
+    LocalSearch(const vec<Lit>& clauses, int nvars, uint64_t seed);
+
+    // Starts from 'init' (by variable, 1 = positive literal true). Returns TRUE once no clause is
+    // falsified, within 'maxFlips' flips.
+    bool run(const vec<char>& init, uint64_t maxFlips);
+};
+
+
+inline LocalSearch::LocalSearch(const vec<Lit>& clauses, int nvars, uint64_t seed)
+    : rnd(seed | 1), bestFalsified(INT32_MAX), flips(0)
+{
+    occStart.growTo(2 * nvars + 1, 0);
+    start.push(0);
+    for (int i = 0; i < clauses.size(); i++){
+        if (clauses[i] == lit_Undef){
+            start.push(lits.size());
+            continue; }
+        lits.push(clauses[i]);
+        occStart[toInt(clauses[i]) + 1]++; }
+
+    for (int i = 0; i < 2 * nvars; i++) occStart[i + 1] += occStart[i];
+    occ.growTo(lits.size());
+    vec<int> fill;
+    occStart.copyTo(fill);
+    for (int c = 0; c + 1 < start.size(); c++)
+        for (int i = start[c]; i < start[c + 1]; i++)
+            occ[fill[toInt(lits[i])]++] = c;
+
+    // The constants of the paper by clause length:
+    for (int k = 0; k < 4; k++)
+        for (int b = 0; b <= maxBreak; b++)
+            probs.push(k == 0 ? pow(0.9 + b, -2.06) : pow(k == 1 ? 3.0 : k == 2 ? 3.7 : 5.4, -b));
+}
+
+
+inline int LocalSearch::breaks(Var v) const
+{
+    Lit p = mkLit(v, !value[v]);
+    int n = 0;
+    for (int i = occStart[toInt(p)]; i < occStart[toInt(p) + 1]; i++)
+        n += numTrue[occ[i]] == 1;
+    return n;
+}
+
+
+inline void LocalSearch::flip(Var v)
+{
+    Lit p = mkLit(v, !value[v]);       // True before the flip.
+    value[v] ^= 1;
+    flips++;
+    for (int i = occStart[toInt(~p)]; i < occStart[toInt(~p) + 1]; i++)
+        if (numTrue[occ[i]]++ == 0) remove(occ[i]);
+    for (int i = occStart[toInt(p)]; i < occStart[toInt(p) + 1]; i++)
+        if (--numTrue[occ[i]] == 0) add(occ[i]);
+}
+
+
+inline bool LocalSearch::run(const vec<char>& init, uint64_t maxFlips)
+{
+    int nclauses = start.size() - 1;
+    init.copyTo(value);
+    numTrue .clear(); numTrue .growTo(nclauses, 0);
+    position.clear(); position.growTo(nclauses, -1);
+    falsified.clear();
+    for (int c = 0; c < nclauses; c++){
+        for (int i = start[c]; i < start[c + 1]; i++) numTrue[c] += isTrue(lits[i]);
+        if (numTrue[c] == 0) add(c); }
+
+    vec<double> weights;
+    for (uint64_t limit = flips + maxFlips; ; ){
+        if (falsified.size() < bestFalsified){
+            bestFalsified = falsified.size();
+            value.copyTo(best); }
+        if (falsified.size() == 0) return true;
+        if (flips >= limit) return false;
+
+        int           c    = falsified[random() % falsified.size()];
+        const double* prob = &probs[lengthClass(start[c + 1] - start[c]) * (maxBreak + 1)];
+        double        sum  = 0;
+        weights.clear();
+        for (int i = start[c]; i < start[c + 1]; i++){
+            int b = breaks(var(lits[i]));
+            weights.push(prob[b < maxBreak ? b : maxBreak]);
+            sum += weights.last(); }
+
+        double r = sum * (random() / 4294967296.0);
+        int    i = 0;
+        while (i < weights.size() - 1 && (r -= weights[i]) > 0) i++;
+        flip(var(lits[start[c] + i]));
+    }
+}
+
+
+//=================================================================================================
+}
+
+#endif
@@ -28,15 +28,26 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 **************************************************************************************************/
 
 #include <errno.h>
+#include <unistd.h>
+#include <poll.h>
 
 #include <signal.h>
 #include <zlib.h>
+#include <pthread.h>
 
 #include "utils/System.h"
 #include "utils/ParseUtils.h"
 #include "utils/Options.h"
 #include "core/Dimacs.h"
 #include "core/Solver.h"
+#include "core/CubeTrie.h"
+#include "core/CubeMetrics.h"
+#include "core/CubeJournal.h"
+#include "core/CubeServer.h"
+#include "core/CubeRouter.h"
+#include "core/CubeSplitter.h"
+#include "core/CubeCounter.h"
+#include "core/CubeStats.h"
 
 using namespace Glucose;
 
@@ -61,11 +72,358 @@ void printStats(Solver& solver)
     printf("c propagations          : %-12"PRIu64"   (%.0f /sec)\n", solver.propagations, solver.propagations/cpu_time);
     printf("c conflict literals     : %-12"PRIu64"   (%4.2f %% deleted)\n", solver.tot_literals, (solver.max_literals - solver.tot_literals)*100 / (double)solver.max_literals);
     printf("c nb reduced Clauses    : %lld\n", (long long int) solver.nbReducedClauses);
+    if (solver.nbInprocess > 0)
+        printf("c nb inprocessings      : %lld (%lld lits vivified, %lld subsumed, %lld strengthened)\n",
+               (long long int) solver.nbInprocess, (long long int) solver.nbVivifiedLits,
+               (long long int) solver.nbInprocSubsumed, (long long int) solver.nbInprocStrengthened);
+    if (solver.nbProbes > 0)
+        printf("c nb probes             : %lld (%lld failed, %lld implied, %lld equivalent literals)\n",
+               (long long int) solver.nbProbes, (long long int) solver.nbFailedLits,
+               (long long int) solver.nbImpliedLits, (long long int) solver.nbEquivLits);
+    if (solver.nbWalks > 0)
+        printf("c nb walks              : %lld (%lld models, %lld flips)\n",
+               (long long int) solver.nbWalks, (long long int) solver.nbWalkModels, (long long int) solver.nbWalkFlips);
+    if (PhaseProfile::enabled()){
+        uint64_t total = 0;
+        for (int p = 0; p < nPhases; p++) total += solver.profile.cycles[p];
+        for (int p = 0; p < nPhases; p++)
+            if (solver.profile.cycles[p] > 0)
+                printf("c phase %-16s: %-12.1f Mcycles (%4.1f %%)\n", PhaseProfile::name(p),
+                       solver.profile.cycles[p] / 1e6, solver.profile.cycles[p] * 100.0 / total);
+    }
 
     if (mem_used != 0) printf("Memory used           : %.2f MB\n", mem_used);
     printf("c CPU time              : %g s\n", cpu_time);
 }
 
+// At most once per second, so that the console does not slow down short cubes.
+static void printProgress(double done)
+{
+    static double last = 0;
+    double now = realTime();
+    if (now - last < 1) return;
+    last = now;
+
+    printf ("\rc %.2f%% [", done * 100);
+    for (int f = 1; f <= 20; f++) {
+      if (done * 20.0 < 1.0 * f) printf(" ");
+      else printf("="); }
+    printf ("] time remaining: %.2f seconds ", cpuTime() / done - cpuTime());
+    fflush (stdout);
+}
+
+// Returns the index of 'hints' in 'sets' (-1 if there are none). Cubes below the same look-ahead
+// node share their hints, so only the last set is compared.
+static int hintSet(vec<vec<Lit> >& sets, const vec<Lit>& hints)
+{
+    if (hints.size() == 0) return -1;
+    if (sets.size() > 0 && sets.last().size() == hints.size()){
+        int i;
+        for (i = 0; i < hints.size() && sets.last()[i] == hints[i]; i++);
+        if (i == hints.size()) return sets.size() - 1; }
+    sets.push();
+    hints.copyTo(sets.last());
+    return sets.size() - 1;
+}
+
+
+//=================================================================================================
+// Parallel cube workers:
+//
+// Every worker owns a copy of the formula and takes the next pending cube from the shared trie.
+// Short learnt clauses are exchanged through a 'ClauseExchange'; the trie and the progress are
+// protected by one lock, taken once per cube.
+
+struct CubeWorker {
+    Solver*   S;
+    pthread_t thread;
+};
+
+static struct {
+    CubeWorker*     workers;
+    int             nworkers;
+    CubeTrie*       cubes;
+    vec<vec<Lit> >* hintSets;
+    vec<int>*       cubeHints;          // Index in 'hintSets' for every cube id, or -1.
+    pthread_mutex_t lock;
+    int             next, to, inc;      // Bound loop: next cube id, last id, increment.
+    bool            prune, stopAtSat, stopAtUnsat;
+    int             inpCubes, inpConfl;
+    bool            stop;               // Set once the remaining cubes need not be solved.
+    bool            indet;              // Some cube was interrupted.
+    int             winner;             // Worker which found a model, or -1.
+    double          done;
+    CubeMetrics*    metrics;
+    CubeJournal*    journal;
+    CubeStats*      stats;
+    bool            progress;           // Print the progress bar.
+} par;
+
+static void stopWorkers()
+{
+    par.stop = true;
+    for (int i = 0; i < par.nworkers; i++)
+        par.workers[i].S->interrupt();
+}
+
+static void* cubeWorker(void* arg)
+{
+    int         id = (CubeWorker*)arg - par.workers;
+    Solver&     S  = *par.workers[id].S;
+    vec<Lit>    assumptions, failed;
+    int         cubes_since_inp = 0;
+    uint64_t    confl_at_inp = 0;
+    bool        flush = false;      // A journal group is to be synced once the lock is released.
+
+    pthread_mutex_lock(&par.lock);
+    for (;;){
+        while (!par.stop && par.next < par.cubes->size() && par.next <= par.to && !par.cubes->pending(par.next)){
+            par.cubes->cube(par.next, assumptions);
+            par.done += pow (0.5, assumptions.size());
+            if (par.cubes->pruned(par.next)) par.metrics->prunedCube(assumptions.size());
+            else                             par.metrics->resumedCube(assumptions.size());
+            par.next += par.inc; }
+        if (par.stop || par.next >= par.cubes->size() || par.next > par.to) break;
+        int cube = par.next;
+        par.next += par.inc;
+        par.cubes->cube(cube, assumptions);
+        par.metrics->startCube(id, cube);
+        pthread_mutex_unlock(&par.lock);
+        if (flush) par.journal->flush(), flush = false;
+
+        if ((par.inpCubes > 0 && cubes_since_inp >= par.inpCubes) ||
+            (par.inpConfl > 0 && S.conflicts - confl_at_inp >= (uint64_t)par.inpConfl)) {
+          cubes_since_inp = 0;
+          confl_at_inp = S.conflicts;
+          S.inprocess(); }
+
+        CubeStats::Start start;
+        par.stats->start(S, start);
+        if ((*par.cubeHints)[cube] >= 0) S.hintCube((*par.hintSets)[(*par.cubeHints)[cube]]);
+        lbool ret = S.simplify() ? S.solveLimited (assumptions) : l_False;
+        cubes_since_inp++;
+
+        pthread_mutex_lock(&par.lock);
+        if (ret == l_Undef){
+          if (!par.stop) par.indet = true;
+          stopWorkers();
+          break; }
+
+        par.cubes->finish(cube);
+        par.done += pow (0.5, assumptions.size());
+        par.metrics->finishCube(id, assumptions.size(), ret, S.conflicts);
+        par.stats->record(cube, id, assumptions.size(), ret, S, start);
+        if (ret == l_True){
+          if (par.winner == -1) par.winner = id;
+          if (par.stopAtSat) stopWorkers();
+        }else if (!S.okay()){
+          // The formula itself is unsatisfiable:
+          failed.clear();
+          par.cubes->prune(failed);
+          flush |= par.journal->record(cube, failed);
+          par.done = 1;
+        }else{
+          failed.clear();
+          for (int i = 0; i < S.conflict.size(); i++)
+            failed.push(~S.conflict[i]);
+          if (par.prune) par.cubes->prune(failed);
+          flush |= par.journal->record(cube, failed);
+          if (par.stopAtUnsat) stopWorkers();
+        }
+        if (par.metrics->due()) par.metrics->write();
+        if (par.progress) printProgress(par.done);
+    }
+    pthread_mutex_unlock(&par.lock);
+    if (flush) par.journal->flush();
+    return NULL;
+}
+
+
+//=================================================================================================
+// Remote cube worker:
+//
+// Solves the batches of cubes handed out by a cube server (see 'CubeServer.h') and reports every
+// result. While a cube is solved a watcher thread waits for input from the server, which can only
+// be the end of the run, and interrupts the solver. 'remote.cube' changes with every cube, so a
+// late wake-up never interrupts the next one. The state is only read and written under
+// 'remote.lock'; the watcher sleeps on 'remote.changed' between cubes.
+
+static struct {
+    Solver*         S;
+    CubeClient*     client;
+    pthread_mutex_t lock;
+    pthread_cond_t  changed;
+    bool            solving;
+    unsigned        cube;
+    bool            finished;
+} remote;
+
+static void setRemote(bool solving, bool finished)
+{
+    pthread_mutex_lock(&remote.lock);
+    remote.solving  = solving;
+    remote.finished = finished;
+    remote.cube++;
+    pthread_cond_broadcast(&remote.changed);
+    pthread_mutex_unlock(&remote.lock);
+}
+
+static void* cubeWatcher(void*)
+{
+    pollfd p;
+    p.fd = remote.client->socket(); p.events = POLLIN;
+    pthread_mutex_lock(&remote.lock);
+    while (!remote.finished) {
+        if (!remote.solving) { pthread_cond_wait(&remote.changed, &remote.lock); continue; }
+        unsigned cube = remote.cube;
+        pthread_mutex_unlock(&remote.lock);
+        int ready = poll(&p, 1, 100);
+        pthread_mutex_lock(&remote.lock);
+        if (ready <= 0) continue;
+
+        // The input stays unread until the cube is over:
+        if (remote.solving && remote.cube == cube) remote.S->interrupt();
+        while (!remote.finished && remote.cube == cube) pthread_cond_wait(&remote.changed, &remote.lock);
+    }
+    pthread_mutex_unlock(&remote.lock);
+    return NULL;
+}
+
+static lbool conquerRemote(Solver& S, const char* addr, int batch, int inpCubes, int inpConfl, CubeStats& stats)
+{
+    CubeClient client(batch);
+    if (!client.connect(addr, 30))
+        printf("c ERROR! Could not connect to cube server: %s\n", addr), exit(1);
+
+    remote.S        = &S;
+    remote.client   = &client;
+    remote.solving  = remote.finished = false;
+    remote.cube     = 0;
+    pthread_mutex_init(&remote.lock, NULL);
+    pthread_cond_init(&remote.changed, NULL);
+    pthread_t watcher;
+    pthread_create(&watcher, NULL, cubeWatcher, NULL);
+
+    vec<Lit> assumptions, failed;
+    lbool    ret = l_Undef;
+    int      id, solved = 0, cubes_since_inp = 0;
+    uint64_t confl_at_inp = 0;
+    while (ret != l_True && client.next(id, assumptions)) {
+        for (int i = 0; i < assumptions.size(); i++)
+            while (var(assumptions[i]) >= S.nVars()) S.newVar();
+
+        if ((inpCubes > 0 && cubes_since_inp >= inpCubes) ||
+            (inpConfl > 0 && S.conflicts - confl_at_inp >= (uint64_t)inpConfl)) {
+          cubes_since_inp = 0;
+          confl_at_inp = S.conflicts;
+          S.inprocess(); }
+
+        CubeStats::Start start;
+        stats.start(S, start);
+        setRemote(true, false);
+        ret = S.simplify() ? S.solveLimited (assumptions) : l_False;
+        setRemote(false, false);
+        cubes_since_inp++;
+        stats.record(id, 0, assumptions.size(), ret, S, start);
+
+        if (ret == l_True)
+          client.satisfied(id, S.conflicts, S.model);
+        else if (ret == l_False) {
+          failed.clear();
+          for (int i = 0; i < S.conflict.size(); i++)
+            failed.push(~S.conflict[i]);
+          client.refuted(id, S.conflicts, failed);
+        } else if (!client.cancelled())
+          client.unknown(id);
+        else
+          break;
+        solved++;
+    }
+    setRemote(false, true);
+    pthread_join(watcher, NULL);
+    pthread_cond_destroy(&remote.changed);
+    pthread_mutex_destroy(&remote.lock);
+
+    printf("c conquered %d cubes for %s\n", solved, addr);
+    if (ret == l_True) return l_True;
+    if (client.result() == 10) printf("c another worker found a model\n");
+    return client.result() == 20 ? l_False : l_Undef;
+}
+
+
+//=================================================================================================
+// Cube export:
+//
+// Writes the formula under each selected cube as a CNF of its own (see 'Solver::exportCube()'),
+// reading the cubes once. A '%d' in the file name is replaced by the cube id, otherwise all CNFs
+// go to one file ('-' is standard output) and start with their 'c cube' line.
+
+// Parses "3,7,10-20" into sorted ranges. Returns FALSE on a syntax error.
+static bool parseCubeIds(const char* s, vec<int>& from, vec<int>& to)
+{
+    while (*s){
+        char* end;
+        long  a = strtol(s, &end, 10), b = a;
+        if (end == s || a < 0) return false;
+        s = end;
+        if (*s == '-'){
+            b = strtol(++s, &end, 10);
+            if (end == s || b < a) return false;
+            s = end; }
+        from.push(a); to.push(b);
+        if (*s == ',') s++;
+        else if (*s) return false; }
+
+    for (int i = 1; i < from.size(); i++)
+        for (int j = i; j > 0 && from[j] < from[j - 1]; j--){
+            int t = from[j]; from[j] = from[j - 1]; from[j - 1] = t;
+            t = to[j]; to[j] = to[j - 1]; to[j - 1] = t; }
+    return from.size() > 0;
+}
+
+static void exportCubes(Solver& S, StreamBuffer& in, const char* file, const char* ids,
+                        int fromBound, int toBound, int incBound)
+{
+    vec<int> from, to;
+    if (ids && !parseCubeIds(ids, from, to))
+        printf("c ERROR! Invalid cube ids: %s\n", ids), exit(1);
+    int last = ids ? to.last() : toBound;
+
+    const char* pat = strstr(file, "%d");
+    FILE*       out = NULL;
+    if (!pat){
+        out = strcmp(file, "-") ? fopen(file, "wb") : stdout;
+        if (out == NULL) printf("c ERROR! Could not open file: %s\n", file), exit(1); }
+
+    double   start = realTime();
+    int      written = 0, refuted = 0, satisfied = 0, range = 0;
+    vec<Lit> cube;
+    for (int id = 0; id <= last && parse_DIMACS_main(in, S, &cube); id++){
+        if (id == 0) S.simplify();
+        if (ids){
+            while (range < from.size() && to[range] < id) range++;
+            if (range == from.size() || id < from[range]) continue;
+        }else if (id < fromBound || (id - fromBound) % incBound != 0) continue;
+
+        FILE* f = out;
+        if (pat){
+            char name[4096];
+            snprintf(name, sizeof(name), "%.*s%d%s", (int)(pat - file), file, id, pat + 2);
+            if ((f = fopen(name, "wb")) == NULL)
+                printf("c ERROR! Could not open file: %s\n", name), exit(1); }
+        lbool ret = S.exportCube(f, cube, id);
+        if (pat) fclose(f);
+        written++;
+        refuted   += ret == l_False;
+        satisfied += ret == l_True; }
+
+    if (out && out != stdout) fclose(out);
+    fflush(stdout);
+    fprintf(stderr, "c exported %d cubes (%d refuted, %d satisfied by propagation) in %.2f s\n",
+            written, refuted, satisfied, realTime() - start);
+}
+
+
 static Solver* solver;
 // Terminate by notifying the solver and back out gracefully. This is mainly to have a test-case
 // for this feature of the Solver as it may take longer than an immediate call to '_exit()'.
@@ -110,6 +468,30 @@ int main(int argc, char** argv)
         IntOption    inc_bound  ("MAIN", "inc-bound","After solving a bound increment it by this amount.\n", 1, IntRange(1, INT32_MAX));
  	BoolOption   stopAtSat  ("MAIN", "stop-at-sat", "Stop solving if a bound is found SATISFIABLE.\n", true);
  	BoolOption   stopAtUnsat("MAIN", "stop-at-unsat", "Stop solving if a bound is found UNSATISFIABLE.\n", false);
+ 	BoolOption   pruneCubes ("MAIN", "prune-cubes", "Read all cubes first and drop pending cubes containing the failed assumptions of a refuted cube.\n", false);
+        IntOption    inp_cubes ("MAIN", "inprocess-cubes", "Inprocess the learnt clauses after this many cubes (0 = never).\n", 0, IntRange(0, INT32_MAX));
+        IntOption    inp_confl ("MAIN", "inprocess-conflicts", "Inprocess the learnt clauses after this many conflicts (0 = never).\n", 0, IntRange(0, INT32_MAX));
+        IntOption    workers ("MAIN", "workers", "Number of parallel cube workers sharing short learnt clauses.\n", 1, IntRange(1, 1024));
+        StringOption save_image ("MAIN", "save-image", "Write the solver after parsing and root-level simplification to this image and stop.\n");
+        StringOption load_image ("MAIN", "load-image", "Start from this solver image, the input file then only needs the cubes.\n");
+        StringOption metrics_file ("MAIN", "metrics", "Rewrite a JSON snapshot of the progress to this file instead of printing a progress bar.\n");
+        DoubleOption metrics_interval ("MAIN", "metrics-interval", "Seconds between two metrics snapshots.\n", 1.0, DoubleRange(0, true, HUGE_VAL, false));
+        StringOption journal_file ("MAIN", "journal", "Append the refuted cubes to this journal and skip the cubes it already holds.\n");
+        StringOption serve_addr ("MAIN", "serve", "Hand out the cubes to worker processes connecting to this address (unix:PATH, HOST:PORT or PORT).\n");
+        StringOption connect_addr ("MAIN", "connect", "Solve the cubes handed out by the cube server at this address.\n");
+        IntOption    batch ("MAIN", "batch", "Number of cubes a worker requests from the cube server at once.\n", 16, IntRange(1, INT32_MAX));
+        IntOption    ring_size ("MAIN", "share-ring", "Log2 of the words in each clause sharing ring.\n", 16, IntRange(4, 30));
+        StringOption export_file ("MAIN", "export", "Write the propagated and renumbered formula under each cube in the bound range to this file ('%d' is replaced by the cube id, '-' is stdout) and stop.\n");
+        StringOption export_ids ("MAIN", "export-ids", "Only export these cube ids (comma separated ids and ranges FROM-TO).\n");
+        BoolOption   use_hints ("MAIN", "hints", "Apply the phase and activity hints of the cubes ('h' lines of march_cu -hints).\n", true);
+        BoolOption   hybrid ("MAIN", "hybrid", "Solve every cube with the look-ahead solver of march_cu or with CDCL, as decided from its features.\n", false);
+        IntOption    hybrid_sample ("MAIN", "hybrid-sample", "Cubes solved by both engines to calibrate -hybrid.\n", 16, IntRange(0, INT32_MAX));
+        DoubleOption hybrid_min ("MAIN", "hybrid-min-time", "Seconds the calibration samples must take together before -hybrid routes any cube to the look-ahead solver.\n", 1.0, DoubleRange(0, true, HUGE_VAL, false));
+        BoolOption   count ("MAIN", "count", "Count the models as the sum over the cubes, which must partition the assignments (march_cu -#), on -workers threads.\n", false);
+        IntOption    split_confl ("MAIN", "split-conflicts", "Split a bound that takes more conflicts with the cuber of march_cu, starting from the leaves of the last split bound (0 = never).\n", 0, IntRange(0, INT32_MAX));
+        IntOption    split_depth ("MAIN", "split-depth", "Depth of the cube trees of -split-conflicts.\n", 8, IntRange(1, 30));
+        StringOption cube_stats ("MAIN", "cube-stats", "Write the time, conflicts, propagations, core size and learnts kept of every solved cube to this file (CSV, or JSON lines if it ends in .json).\n");
+        IntOption    hybrid_limit ("MAIN", "hybrid-limit", "Dead ends of the look-ahead solver before CDCL takes over a cube, and conflicts of CDCL on the sampled cubes (0 = no limit).\n", 10000, IntRange(0, INT32_MAX));
 
         parseOptions(argc, argv, true);
 
@@ -165,9 +547,170 @@ int main(int argc, char** argv)
  	vec<Lit> assumptions;
  	int bound = 0;
  	int next_solve_bound = from_bound;
+ 	int cubes_since_inp = 0;
+ 	uint64_t confl_at_inp = 0;
  	StreamBuffer streamBuf(in);
-         while (parse_DIMACS_main(streamBuf, S, &assumptions) ) {
+ 	CubeTrie cubes;
+ 	vec<Lit> failed;
+ 	vec<Lit> hints;
+ 	vec<Lit>* hintsp = use_hints ? &hints : NULL;
+ 	vec<vec<Lit> > hintSets;
+ 	vec<int> cubeHints;
+ 	if (load_image && !S.loadImage(load_image))
+ 	  printf("c ERROR! Could not load image: %s\n", (const char*)load_image), exit(1);
+
+ 	if (save_image) {
+ 	  parse_DIMACS_main(streamBuf, S, &assumptions); // Clauses up to the first cube.
+ 	  if (!S.saveImage(save_image)) {
+ 	    if (!S.okay()) printf("s UNSATISFIABLE\n"), exit(20);
+ 	    printf("c ERROR! Could not write image: %s\n", (const char*)save_image), exit(1); }
+ 	  printf("c wrote image %s with %d variables and %d clauses\n", (const char*)save_image, S.nVars(), S.nClauses());
+ 	  exit(0); }
+
+ 	if (export_file) {
+ 	  exportCubes(S, streamBuf, export_file, export_ids, from_bound, to_bound, inc_bound);
+ 	  exit(0); }
+
+ 	if (connect_addr && (serve_addr || journal_file || workers > 1))
+ 	  printf("c ERROR! -connect can not be combined with -serve, -journal or -workers\n"), exit(1);
+ 	if (hybrid && !CubeRouter::available())
+ 	  printf("c ERROR! -hybrid needs iglucose built with make MARCH=1\n"), exit(1);
+ 	if (hybrid && (connect_addr || serve_addr || workers > 1 || S.certifiedUNSAT))
+ 	  printf("c ERROR! -hybrid can not be combined with -connect, -serve, -workers or -certified\n"), exit(1);
+ 	if (count && (connect_addr || serve_addr || journal_file || hybrid || split_confl > 0 || S.certifiedUNSAT))
+ 	  printf("c ERROR! -count can not be combined with -connect, -serve, -journal, -hybrid, -split-conflicts or -certified\n"), exit(1);
+ 	if (split_confl > 0 && !CubeSplitter::available())
+ 	  printf("c ERROR! -split-conflicts needs iglucose built with make MARCH=1\n"), exit(1);
+ 	if (split_confl > 0 && (connect_addr || serve_addr || workers > 1 || hybrid))
+ 	  printf("c ERROR! -split-conflicts can not be combined with -connect, -serve, -workers or -hybrid\n"), exit(1);
+ 	if (cube_stats && (serve_addr || count))
+ 	  printf("c ERROR! -cube-stats can not be combined with -serve or -count\n"), exit(1);
+ 	CubeStats stats;
+ 	if (cube_stats && !stats.open(cube_stats))
+ 	  printf("c ERROR! Could not open file: %s\n", (const char*)cube_stats), exit(1);
+
+ 	// A remote worker only reads the clauses, its cubes come from the server:
+ 	bool useTrie = !connect_addr && (pruneCubes || workers > 1 || journal_file || serve_addr || hybrid || count);
+ 	int declared = 0;
+ 	if (useTrie)
+ 	  while (parse_DIMACS_main(streamBuf, S, &assumptions, hintsp, &declared)){
+ 	    cubes.insert(assumptions);
+ 	    cubeHints.push(hintSet(hintSets, hints)); }
+
+ 	if (count) {
+ 	  if (cubes.size() == 0) cubes.insert(assumptions);     // No cubes, count the whole formula.
+ 	  while (S.nVars() < declared) S.newVar();               // Declared but in no clause: free.
+ 	  double      start = realTime();
+ 	  CubeCounter counter(cubes);
+ 	  Count       n = counter.run(S, workers);
+ 	  printf(n.isZero() ? "s UNSATISFIABLE\n" : "s SATISFIABLE\n");
+ 	  printf("c s type mc\nc s log10-estimate %.6f\nc s exact arb int ", n.log10());
+ 	  n.print(stdout);
+ 	  printf("\n");
+ 	  counter.printStats(realTime() - start);
+ 	  exit(0); }
+
+ 	if (workers > 1 && S.certifiedUNSAT) {
+ 	  printf("c WARNING! Shared clauses cannot be certified, using a single worker.\n");
+ 	  workers = 1; }
+
+ 	CubeMetrics metrics(metrics_file, metrics_interval, serve_addr ? 0 : (int)workers, cubes.size());
+
+ 	// Skip the cubes refuted by an earlier run and add their failed assumptions again:
+ 	CubeJournal journal;
+ 	if (journal_file) {
+ 	  vec<int>       ids;
+ 	  vec<vec<Lit> > cores;
+ 	  if (!journal.open(journal_file, cubes.size(), S.nVars(), ids, cores))
+ 	    printf("c ERROR! Could not use journal: %s\n", (const char*)journal_file), exit(1);
+ 	  for (int i = 0; i < ids.size(); i++) {
+ 	    cubes.finish(ids[i]);
+ 	    failed.clear();
+ 	    for (int j = 0; j < cores[i].size(); j++)
+ 	      failed.push(~cores[i][j]);
+ 	    S.addClause(failed);
+ 	    if (pruneCubes) cubes.prune(cores[i]); }
+ 	  if (ids.size() > 0)
+ 	    printf("c resumed %d refuted cubes from %s\n", ids.size(), (const char*)journal_file);
+ 	}
+
+ 	CubeRouter router(hybrid_limit, hybrid_min);
+ 	CubeSplitter splitter(split_confl, split_depth);
+ 	if (hybrid && S.okay())
+ 	  router.calibrate(S, cubes, from_bound, to_bound, inc_bound, hybrid_sample);
+ 	if (!S.okay()) ret = l_False;     // Refuted by the journal or by a calibration run.
+
+ 	if (serve_addr) {
+ 	  CubeServer server(cubes, journal, metrics, pruneCubes);
+ 	  if (!server.open(serve_addr))
+ 	    printf("c ERROR! Could not serve cubes on: %s\n", (const char*)serve_addr), exit(1);
+ 	  printf("c serving %d pending cubes on %s\n", cubes.nPending(), (const char*)serve_addr);
+ 	  fflush(stdout);
+ 	  ret = S.okay() ? server.run(S.model) : l_False;
+ 	  if (ret == l_True) S.model.growTo(S.nVars(), l_Undef);
+ 	} else if (connect_addr) {
+ 	  parse_DIMACS_main(streamBuf, S, &assumptions); // Clauses up to the first cube.
+ 	  ret = conquerRemote(S, connect_addr, batch, inp_cubes, inp_confl, stats);
+ 	} else if (workers > 1) {
+ 	  ClauseExchange exchange(workers, ring_size);
+ 	  par.nworkers    = workers;
+ 	  par.workers     = new CubeWorker[workers];
+ 	  par.cubes       = &cubes;
+ 	  par.hintSets    = &hintSets;
+ 	  par.cubeHints   = &cubeHints;
+ 	  par.next        = from_bound;
+ 	  par.to          = to_bound;
+ 	  par.inc         = inc_bound;
+ 	  par.prune       = pruneCubes;
+ 	  par.stopAtSat   = stopAtSat;
+ 	  par.stopAtUnsat = stopAtUnsat;
+ 	  par.inpCubes    = inp_cubes;
+ 	  par.inpConfl    = inp_confl;
+ 	  par.stop        = par.indet = false;
+ 	  par.winner      = -1;
+ 	  par.done        = 0.0;
+ 	  par.metrics     = &metrics;
+ 	  par.journal     = &journal;
+ 	  par.stats       = &stats;
+ 	  par.progress    = !metrics_file;
+ 	  pthread_mutex_init(&par.lock, NULL);
+ 	  for (int i = 0; i < workers; i++) {
+ 	    if (i == 0) par.workers[i].S = &S;
+ 	    else {
+ 	      par.workers[i].S = new Solver;
+ 	      S.copyClausesTo(*par.workers[i].S); }
+ 	    par.workers[i].S->setExchange(&exchange, i); }
+ 	  for (int i = 0; i < workers; i++)
+ 	    pthread_create(&par.workers[i].thread, NULL, cubeWorker, &par.workers[i]);
+ 	  for (int i = 0; i < workers; i++)
+ 	    pthread_join(par.workers[i].thread, NULL);
+
+ 	  ret = par.winner != -1 ? l_True : par.indet ? l_Undef : l_False;
+ 	  if (par.winner > 0) par.workers[par.winner].S->model.copyTo(S.model);
+ 	  uint64_t exported = 0, imported = 0;
+ 	  for (int i = 0; i < workers; i++) {
+ 	    exported += par.workers[i].S->nbExported;
+ 	    imported += par.workers[i].S->nbImported;
+ 	    if (i > 0) delete par.workers[i].S; }
+ 	  delete [] par.workers;
+ 	  pthread_mutex_destroy(&par.lock);
+ 	  printf("\nc shared clauses        : %lld exported, %lld imported (%d workers)",
+ 		 (long long int) exported, (long long int) imported, (int)workers);
+ 	} else if (S.okay())
+
+         while (useTrie ? bound < cubes.size() : parse_DIMACS_main(streamBuf, S, &assumptions, hintsp) ) {
  	  if ( bound < next_solve_bound ) goto nextBound;
+ 	  if (useTrie) {
+ 	    cubes.cube(bound, assumptions);
+ 	    if (!cubes.pending(bound)) {
+ 	      // Contains the failed assumptions of an earlier cube, or is in the journal:
+ 	      ret = l_False;
+ 	      done += pow (0.5, assumptions.size());
+ 	      if (cubes.pruned(bound)) metrics.prunedCube(assumptions.size());
+ 	      else                     metrics.resumedCube(assumptions.size());
+ 	      next_solve_bound+= inc_bound;
+ 	      goto nextBound; }
+ 	  }
 
  	  if (S.verbosity > 0){
  	    printf("============================[ Problem Statistics ]=============================\n");
@@ -176,18 +719,43 @@ int main(int argc, char** argv)
  	    printf("|  Number of variables:  %12d                                         |\n", S.nVars());
  	    printf("|  Number of clauses:    %12d                                         |\n", S.nClauses()); }
 
+ 	  if ((inp_cubes > 0 && cubes_since_inp >= inp_cubes) ||
+ 	      (inp_confl > 0 && S.conflicts - confl_at_inp >= (uint64_t)inp_confl)) {
+ 	    cubes_since_inp = 0;
+ 	    confl_at_inp = S.conflicts;
+ 	    S.inprocess(); }
+
  	  if (!S.simplify()){
- 	    if (res != NULL) fprintf(res, "UNSAT\n");
  	    if (S.verbosity > 0){
  	      printf("===============================================================================\n");
  	      printf("Solved by unit propagation\n");
  	      printStats(S);
  	      printf("\n"); }
  	    printf("Bound %d is UNSATISFIABLE by IUP\n", bound);
+ 	    ret = l_False;
  	    break;
  	  }
 
- 	  ret = S.solveLimited (assumptions);
+ 	  if (!useTrie) metrics.setTotal(bound + 1);
+ 	  metrics.startCube(0, bound);
+ 	  CubeStats::Start start;
+ 	  stats.start(S, start);
+ 	  if (!useTrie)               S.hintCube(hints);
+ 	  else if (cubeHints[bound] >= 0) S.hintCube(hintSets[cubeHints[bound]]);
+ 	  ret = hybrid ? router.solve(S, assumptions) : splitter.solve(S, assumptions);
+ 	  metrics.finishCube(0, assumptions.size(), ret, S.conflicts);
+ 	  stats.record(bound, 0, assumptions.size(), ret, S, start);
+ 	  if (metrics.due()) metrics.write();
+ 	  cubes_since_inp++;
+ 	  if (useTrie && ret != l_Undef) {
+ 	    cubes.finish(bound);
+ 	    if (ret == l_False) {
+ 	      failed.clear();
+ 	      for (int i = 0; i < S.conflict.size(); i++)
+ 		failed.push(~S.conflict[i]);
+ 	      if (pruneCubes) cubes.prune(failed);
+ 	      if (journal.record(bound, failed)) journal.flush(); }
+ 	  }
  	  if (S.verbosity > 0){
  	    printStats(S);
  	    printf("\n"); }
@@ -195,12 +763,7 @@ int main(int argc, char** argv)
 //          printf("c %.2f bound %d (size %d used %d) is %s (%.2f%%)\n", cpuTime(), bound, assumptions.size(), S.conflict.size(),
 //                 ret == l_True ? "SATISFIABLE" : ret == l_False ? "UNSATISFIABLE" : "INDETERMINATE", done);
 
-          printf ("\rc %.2f%% [", done * 100);
-          for (int f = 1; f <= 20; f++) {
-            if (done * 20.0 < 1.0 * f) printf(" ");
-            else printf("="); }
-          printf ("] time remaining: %.2f seconds ", cpuTime() / done - cpuTime());
-          fflush (stdout);
+          if (!metrics_file) printProgress(done);
 
  	  if ( ret == l_Undef ) break;
  	  next_solve_bound+= inc_bound;
@@ -211,6 +774,9 @@ int main(int argc, char** argv)
  	       || ( ret == l_False && stopAtUnsat )
  	       ) break;
  	}
+ 	metrics.write(true);
+ 	journal.close();
+
  	  if (res != NULL){
  	    if (ret == l_True){
  	      fprintf(res, "SAT ");
@@ -243,6 +809,11 @@ int main(int argc, char** argv)
  	if (S.verbosity == 0){
  	  printf("\n");
  	  printStats(S);
+ 	  if (pruneCubes)
+ 	    printf("c pruned cubes          : %-12d   (%4.2f %% of %d)\n", cubes.nPruned(),
+ 		   cubes.size() ? cubes.nPruned()*100 / (double)cubes.size() : 0, cubes.size());
+ 	  if (hybrid) router.printStats();
+ 	  if (split_confl > 0) splitter.printStats();
  	  printf("\n"); }
 
  	return 0;
@@ -0,0 +1,98 @@
+/**************************************************************************************[Profile.h]
+ iGlucose -- cycle counts of the phases of the search
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Glucose_Profile_h
+#define Glucose_Profile_h
+
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace Glucose {
+
+//=================================================================================================
+// PhaseProfile -- cycles spent by a solver in each phase of the search.
+//
+// A phase is entered with 'PROFILE_PHASE()' at the top of a block and left at its end. The counts
+// are exclusive: the cycles of a nested phase (garbage collection in 'reduceDB()', propagation in
+// 'simplify()') are not charged to the enclosing one as well, so the phases add up to the time in
+// the solver. 'PROFILE_PHASE()' expands to nothing unless iglucose is built with GLUCOSE_PROFILE
+// ("make PHASES=1"), the counts then stay 0.
+
+enum Phase { phSearch, phPropagate, phAnalyze, phMinimize, phReduceDB, phSimplify, phGarbage, phProof,
+             phInprocess, phProbe, phWalk, nPhases };
+
+class PhaseProfile {
+    int       current;            // 'nPhases' outside of the solver.
+    uint64_t  since;
+
+public:
+    uint64_t  cycles[nPhases + 1];
+
+    PhaseProfile() : current(nPhases), since(0) { for (int i = 0; i <= nPhases; i++) cycles[i] = 0; }
+
+    static bool        enabled() {
+#ifdef GLUCOSE_PROFILE
+        return true;
+#else
+        return false;
+#endif
+    }
+    static const char* name(int p) {
+        static const char* names[nPhases] = { "search", "propagate", "analyze", "minimize", "reduce", "simplify",
+                                              "garbage", "proof", "inprocess", "probe", "walk" };
+        return names[p]; }
+
+    // The time stamp counter where there is one, nanoseconds otherwise.
+    static uint64_t    now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        timespec t;
+        clock_gettime(CLOCK_MONOTONIC, &t);
+        return (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+#endif
+    }
+
+    int  enter(int p)    { uint64_t t = now(); cycles[current] += t - since; since = t;
+                           int prev = current; current = p; return prev; }
+    void leave(int prev) { uint64_t t = now(); cycles[current] += t - since; since = t; current = prev; }
+};
+
+class PhaseScope {
+    PhaseProfile& profile;
+    int           prev;
+public:
+    PhaseScope (PhaseProfile& p, int phase) : profile(p), prev(p.enter(phase)) {}
+    ~PhaseScope()                           { profile.leave(prev); }
+};
+
+#ifdef GLUCOSE_PROFILE
+#define PROFILE_PHASE(p) PhaseScope phase_scope_(profile, p)
+#else
+#define PROFILE_PHASE(p)
+#endif
+
+//=================================================================================================
+}
+
+#endif
@@ -28,10 +28,12 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 **************************************************************************************************/
 
 #include <math.h>
+#include <sys/stat.h>
 
 #include "mtl/Sort.h"
 #include "core/Solver.h"
 #include "core/Constants.h"
+#include "core/LocalSearch.h"
 #include "utils/System.h"
 
 using namespace Glucose;
@@ -43,6 +45,10 @@ static const char* _cat = "CORE";
 static const char* _cr = "CORE -- RESTART";
 static const char* _cred = "CORE -- REDUCE";
 static const char* _cm = "CORE -- MINIMIZE";
+static const char* _cinp = "CORE -- INPROCESS";
+static const char* _cs = "CORE -- SHARING";
+static const char* _cpr = "CORE -- PROBE";
+static const char* _cw = "CORE -- LOCAL SEARCH";
 static const char* _certified = "CORE -- CERTIFIED UNSAT";
 
 
@@ -62,6 +68,19 @@ static IntOption    opt_lb_lbd_frozen_clause      (_cred, "minLBDFrozenClause",
 static IntOption     opt_lb_size_minimzing_clause     (_cm, "minSizeMinimizingClause",      "The min size required to minimize clause", 30, IntRange(3, INT32_MAX));
 static IntOption     opt_lb_lbd_minimzing_clause     (_cm, "minLBDMinimizingClause",      "The min LBD required to minimize clause", 6, IntRange(3, INT32_MAX));
 
+static IntOption     opt_lb_lbd_vivify_clause     (_cinp, "maxLBDVivifyClause",      "The max LBD of learnt clauses vivified during inprocessing", 8, IntRange(0, INT32_MAX));
+static IntOption     opt_inprocess_sub_lim     (_cinp, "inp-sub-lim",      "Do not subsume or strengthen learnt clauses larger than this during inprocessing", 100, IntRange(2, INT32_MAX));
+static DoubleOption  opt_inprocess_effort     (_cinp, "inp-effort",      "Vivification propagations relative to the search propagations since the last inprocessing", 0.1, DoubleRange(0, true, HUGE_VAL, false));
+static IntOption     opt_share_lbd     (_cs, "share-lbd",      "Max LBD of learnt clauses shared with other workers", 2, IntRange(0, INT32_MAX));
+static IntOption     opt_share_size     (_cs, "share-size",      "Max size of learnt clauses shared with other workers (units are always shared)", 8, IntRange(1, INT32_MAX));
+static IntOption     opt_inprocess_steps     (_cinp, "inp-steps",      "Literals visited by learnt clause subsumption per inprocessing (in millions)", 10, IntRange(0, INT32_MAX));
+static IntOption     opt_probe_cands     (_cpr, "probe-cands",      "Variables probed for failed and implied literals under each set of assumptions (0 = no probing)", 0, IntRange(0, INT32_MAX));
+static IntOption     opt_probe_order     (_cpr, "probe-order",      "Choose the probed variables by activity (0) or by binary implications (1)", 0, IntRange(0, 1));
+static IntOption     opt_probe_props     (_cpr, "probe-props",      "Propagations allowed for probing under each set of assumptions (in thousands)", 100, IntRange(0, INT32_MAX));
+static IntOption     opt_walk_flips     (_cw, "walk-flips",      "Flips of each local search run under the assumptions (in thousands, 0 = no local search, experimental)", 0, IntRange(0, INT32_MAX));
+static IntOption     opt_walk_cubes     (_cw, "walk-cubes",      "Run local search before CDCL for this many first sets of assumptions", 16, IntRange(0, INT32_MAX));
+static DoubleOption  opt_walk_trail     (_cw, "walk-trail",      "Run local search at a restart once the trail reached this fraction of the variables (0 = never)", 0.9, DoubleRange(0, true, 1, true));
+
 
 static DoubleOption  opt_var_decay         (_cat, "var-decay",   "The variable activity decay factor",            0.8,     DoubleRange(0, false, 1, false));
 static DoubleOption  opt_clause_decay      (_cat, "cla-decay",   "The clause activity decay factor",              0.999,    DoubleRange(0, false, 1, false));
@@ -71,6 +90,7 @@ static IntOption     opt_ccmin_mode        (_cat, "ccmin-mode",  "Controls confl
 static IntOption     opt_phase_saving      (_cat, "phase-saving", "Controls the level of phase saving (0=none, 1=limited, 2=full)", 2, IntRange(0, 2));
 static BoolOption    opt_rnd_init_act      (_cat, "rnd-init",    "Randomize the initial activity", false);
 static DoubleOption  opt_garbage_frac      (_cat, "gc-frac",     "The fraction of wasted memory allowed before a garbage collection is triggered",  0.20, DoubleRange(0, false, HUGE_VAL, false));
+static DoubleOption  opt_ternary_frac      (_cat, "ter-frac",    "Watch ternary clauses inline if they are at least this fraction of the problem clauses (above 1 = never)", 2, DoubleRange(0, true, HUGE_VAL, false));
 static BoolOption    opt_certified         (_certified, "certified",    "Certified UNSAT using DRUP format", false);
 static StringOption  opt_certified_file    (_certified, "certified-output",    "Certified UNSAT output file", "NULL");
 static BoolOption    opt_vbyte             (_certified, "vbyte",    "Emit proof in variable-byte encoding", false);
@@ -96,6 +116,18 @@ Solver::Solver() :
     , lbLBDFrozenClause (opt_lb_lbd_frozen_clause)
     , lbSizeMinimizingClause (opt_lb_size_minimzing_clause)
     , lbLBDMinimizingClause (opt_lb_lbd_minimzing_clause)
+    , lbLBDVivifyClause (opt_lb_lbd_vivify_clause)
+    , inprocessSubLim (opt_inprocess_sub_lim)
+    , inprocessEffort (opt_inprocess_effort)
+    , inprocessSteps ((int64_t)opt_inprocess_steps * 1000000)
+    , shareLBD (opt_share_lbd)
+    , shareSize (opt_share_size)
+    , probeCands (opt_probe_cands)
+    , probeOrder (opt_probe_order)
+    , probeProps ((int64_t)opt_probe_props * 1000)
+    , walkFlips ((int64_t)opt_walk_flips * 1000)
+    , walkCubes (opt_walk_cubes)
+    , walkTrail (opt_walk_trail)
   , var_decay        (opt_var_decay)
   , clause_decay     (opt_clause_decay)
   , random_var_freq  (opt_random_var_freq)
@@ -105,19 +137,27 @@ Solver::Solver() :
   , rnd_pol          (false)
   , rnd_init_act     (opt_rnd_init_act)
   , garbage_frac     (opt_garbage_frac)
+  , ternary_frac     (opt_ternary_frac)
   , certifiedOutput  (NULL)
   , certifiedUNSAT   (opt_certified)
   , vbyte            (opt_vbyte)
   ,  nbRemovedClauses(0),nbReducedClauses(0), nbDL2(0),nbBin(0),nbUn(0) , nbReduceDB(0)
     , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0),conflicts(0),conflictsRestarts(0),nbstopsrestarts(0),nbstopsrestartssame(0),lastblockatrestart(0)
   , dec_vars(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
+  , nbInprocess(0), nbVivifiedLits(0), nbInprocSubsumed(0), nbInprocStrengthened(0)
+  , nbExported(0), nbImported(0)
+  , nbProbes(0), nbFailedLits(0), nbImpliedLits(0), nbEquivLits(0)
+  , nbWalks(0), nbWalkModels(0), nbWalkFlips(0)
     , curRestart(1)
 
   , ok                 (true)
   , cla_inc            (1)
   , var_inc            (1)
+  , hintScale          (1)
   , watches            (WatcherDeleted(ca))
   , watchesBin            (WatcherDeleted(ca))
+  , watchesTer         (WatcherDeleted(ca))
+  , ternaryWatches     (false)
   , qhead              (0)
   , simpDB_assigns     (-1)
   , simpDB_props       (0)
@@ -130,6 +170,12 @@ Solver::Solver() :
   , conflict_budget    (-1)
   , propagation_budget (-1)
   , asynch_interrupt   (false)
+  , lastInprocessProps (0)
+  , exchange           (NULL)
+  , exchangeId         (0)
+  , probeCount         (0)
+  , maxTrail           (0)
+  , walkedTrail        (0)
   , incremental(opt_incremental)
   , nbVarsInitialFormula(INT32_MAX)
 {
@@ -201,6 +247,8 @@ Var Solver::newVar(bool sign, bool dvar)
     watches  .init(mkLit(v, true ));
     watchesBin  .init(mkLit(v, false));
     watchesBin  .init(mkLit(v, true ));
+    watchesTer  .init(mkLit(v, false));
+    watchesTer  .init(mkLit(v, true ));
     assigns  .push(l_Undef);
     vardata  .push(mkVarData(CRef_Undef, 0));
     //activity .push(0);
@@ -244,6 +292,7 @@ bool Solver::addClause_(vec<Lit>& ps)
     ps.shrink(i - j);
 
     if (flag && certifiedUNSAT) {
+      PROFILE_PHASE(phProof);
       if (vbyte) {
         write_char('a');
         for (i = j = 0, p = lit_Undef; i < ps.size(); i++)
@@ -289,6 +338,9 @@ void Solver::attachClause(CRef cr) {
     if(c.size()==2) {
       watchesBin[~c[0]].push(Watcher(cr, c[1]));
       watchesBin[~c[1]].push(Watcher(cr, c[0]));
+    } else if (c.size()==3 && ternaryWatches) {
+      watchesTer[~c[0]].push(TernaryWatcher(cr, c[1], c[2]));
+      watchesTer[~c[1]].push(TernaryWatcher(cr, c[0], c[2]));
     } else {
       watches[~c[0]].push(Watcher(cr, c[1]));
       watches[~c[1]].push(Watcher(cr, c[0]));
@@ -299,6 +351,42 @@ void Solver::attachClause(CRef cr) {
 
 
 
+// Ternary clauses make up most of many cube-and-conquer instances. If they are at least
+// 'ternary_frac' of the problem clauses, their watchers move from 'watches' to 'watchesTer' before
+// the first search. Incremental mode adds selectors to the clauses and keeps the usual watches.
+void Solver::attachTernaries() {
+    if (incremental || ternaryWatches) return;
+
+    int ternaries = 0;
+    for (int i = 0; i < clauses.size(); i++)
+        if (ca[clauses[i]].size() == 3) ternaries++;
+    if (ternaries == 0 || ternaries < ternary_frac * clauses.size()) return;
+
+    watches.cleanAll();
+    for (int i = 0; i < 2 * nVars(); i++){
+        vec<Watcher>& ws = watches[toLit(i)];
+        int j = 0;
+        for (int k = 0; k < ws.size(); k++)
+            if (ca[ws[k].cref].size() != 3) ws[j++] = ws[k];
+        ws.shrink(ws.size() - j);
+    }
+
+    ternaryWatches = true;
+    for (int t = 0; t < 2; t++){
+        const vec<CRef>& cs = t ? learnts : clauses;
+        for (int i = 0; i < cs.size(); i++){
+            const Clause& c = ca[cs[i]];
+            if (c.size() != 3 || c.mark()) continue;
+            watchesTer[~c[0]].push(TernaryWatcher(cs[i], c[1], c[2]));
+            watchesTer[~c[1]].push(TernaryWatcher(cs[i], c[0], c[2]));
+        }
+    }
+
+    if (verbosity >= 1)
+        printf("c Watching %d ternary clauses (%.0f%% of the problem) inline\n", ternaries, 100.0 * ternaries / clauses.size());
+}
+
+
 void Solver::detachClause(CRef cr, bool strict) {
     const Clause& c = ca[cr];
     
@@ -312,6 +400,14 @@ void Solver::detachClause(CRef cr, bool strict) {
         watchesBin.smudge(~c[0]);
         watchesBin.smudge(~c[1]);
       }
+    } else if (c.size()==3 && ternaryWatches) {
+      if (strict){
+        remove(watchesTer[~c[0]], TernaryWatcher(cr, c[1], c[2]));
+        remove(watchesTer[~c[1]], TernaryWatcher(cr, c[0], c[2]));
+      }else{
+        watchesTer.smudge(~c[0]);
+        watchesTer.smudge(~c[1]);
+      }
     } else {
       if (strict){
         remove(watches[~c[0]], Watcher(cr, c[1]));
@@ -331,6 +427,7 @@ void Solver::removeClause(CRef cr) {
   Clause& c = ca[cr];
 
   if (certifiedUNSAT) {
+    PROFILE_PHASE(phProof);
     if (vbyte) {
       write_char ('d');
       for (int i = 0; i < c.size(); i++)
@@ -347,7 +444,11 @@ void Solver::removeClause(CRef cr) {
 
   detachClause(cr);
   // Don't leave pointers to free'd memory!
-  if (locked(c)) vardata[var(c[0])].reason = CRef_Undef;
+  if (locked(c)){
+    // The implied literal of a binary or inline ternary reason need not be the first one:
+    int k = 0;
+    while (value(c[k]) != l_True || reason(var(c[k])) == CRef_Undef || ca.lea(reason(var(c[k]))) != &c) k++;
+    vardata[var(c[k])].reason = CRef_Undef; }
   c.mark(1);
   ca.free(cr);
 }
@@ -431,6 +532,7 @@ inline unsigned int Solver::computeLBD(const Clause &c) {
  * Minimisation with binary reolution
  ******************************************************************/
 void Solver::minimisationWithBinaryResolution(vec<Lit> &out_learnt) {
+  PROFILE_PHASE(phMinimize);
 
   // Find the LBD measure
   unsigned int lbd = computeLBD(out_learnt);
@@ -512,6 +614,39 @@ Lit Solver::pickBranchLit()
 }
 
 
+// Sets the saved phase of every hinted variable and lifts it above the most active variable, the
+// last hint first so that the first hint ends on top. Conflicts then bump and decay as usual. The
+// lift only holds for the next solve, which takes it back at the end: the hints of one cube must
+// not decide the order for all later ones.
+void Solver::hintCube(const vec<Lit>& hints)
+{
+    undoHints();
+    for (int i = hints.size() - 1; i >= 0; i--){
+        Var v = var(hints[i]);
+        if (v >= nVars() || value(v) != l_Undef || !decision[v]) continue;
+        polarity[v] = sign(hints[i]);
+        if (order_heap.inHeap(v)){
+            double bonus = activity[order_heap[0]] - activity[v] + var_inc;
+            hinted.push(v);
+            hintBonus.push(bonus / hintScale);
+            varBumpActivity(v, bonus); } }
+}
+
+
+void Solver::undoHints()
+{
+    for (int i = 0; i < hinted.size(); i++){
+        Var v = hinted[i];
+        activity[v] -= hintBonus[i] * hintScale;
+        if (activity[v] < 0) activity[v] = 0;
+        if (order_heap.inHeap(v))
+            order_heap.increase(v); }
+    hinted.clear();
+    hintBonus.clear();
+    hintScale = 1;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  analyze : (confl : Clause*) (out_learnt : vec<Lit>&) (out_btlevel : int&)  ->  [void]
@@ -531,6 +666,7 @@ Lit Solver::pickBranchLit()
 |________________________________________________________________________________________________@*/
 void Solver::analyze(CRef confl, vec<Lit>& out_learnt,vec<Lit>&selectors, int& out_btlevel, unsigned int &lbd,unsigned int &szWithoutSelectors)
 {
+    PROFILE_PHASE(phAnalyze);
     int pathC = 0;
     Lit p     = lit_Undef;
 
@@ -569,8 +705,10 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt,vec<Lit>&selectors, int& o
 #endif
 
 
-        for (int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++){
+        // Inline ternary watchers propagate any of the three literals without reordering the clause:
+        for (int j = (p == lit_Undef || (c.size()==3 && ternaryWatches)) ? 0 : 1; j < c.size(); j++){
             Lit q = c[j];
+            if (var(q) == var(p)) continue;
 
             if (!seen[var(q)] && level(var(q)) > 0){
 	      if(!isSelector(var(q)))
@@ -630,7 +768,7 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt,vec<Lit>&selectors, int& o
             else{
                 Clause& c = ca[reason(var(out_learnt[i]))];
                 // Thanks to Siert Wieringa for this bug fix!
-                for (int k = ((c.size()==2) ? 0:1); k < c.size(); k++)
+                for (int k = ((c.size()<=3) ? 0:1); k < c.size(); k++)
                     if (!seen[var(c[k])] && level(var(c[k])) > 0){
                         out_learnt[j++] = out_learnt[i];
                         break; }
@@ -718,7 +856,8 @@ bool Solver::litRedundant(Lit p, uint32_t abstract_levels)
 	  c[0] =  c[1], c[1] = tmp;
 	}
 
-        for (int i = 1; i < c.size(); i++){
+        // The implied literal of an inline ternary reason is anywhere, but 'seen' skips it:
+        for (int i = (c.size()==3 && ternaryWatches) ? 0 : 1; i < c.size(); i++){
             Lit p  = c[i];
             if (!seen[var(p)] && level(var(p)) > 0){
                 if (reason(var(p)) != CRef_Undef && (abstractLevel(var(p)) & abstract_levels) != 0){
@@ -769,7 +908,7 @@ void Solver::analyzeFinal(Lit p, vec<Lit>& out_conflict)
 		//                for (int j = 1; j < c.size(); j++) Minisat (glucose 2.0) loop
 		// Bug in case of assumptions due to special data structures for Binary.
 		// Many thanks to Sam Bayless (sbayless@cs.ubc.ca) for discover this bug.
-		for (int j = ((c.size()==2) ? 0:1); j < c.size(); j++)
+		for (int j = ((c.size()<=3) ? 0:1); j < c.size(); j++)
                     if (level(var(c[j])) > 0)
                         seen[var(c[j])] = 1;
             }
@@ -804,10 +943,12 @@ void Solver::uncheckedEnqueue(Lit p, CRef from)
 |________________________________________________________________________________________________@*/
 CRef Solver::propagate()
 {
+    PROFILE_PHASE(phPropagate);
     CRef    confl     = CRef_Undef;
     int     num_props = 0;
     watches.cleanAll();
     watchesBin.cleanAll();
+    if (ternaryWatches) watchesTer.cleanAll();
     while (qhead < trail.size()){
         Lit            p   = trail[qhead++];     // 'p' is enqueued fact to propagate.
         vec<Watcher>&  ws  = watches[p];
@@ -830,7 +971,49 @@ CRef Solver::propagate()
 	    uncheckedEnqueue(imp,wbin[k].cref);
 	  }
 	}
-    
+
+	// Then ternary clauses, if they have their own watches. Satisfied, unit and conflicting
+	// clauses are decided by the inline literals, only moving the watch reads the clause
+	// (without -ter-frac they are in 'watches' and the lists stay empty)
+	if (ternaryWatches) {
+	  vec<TernaryWatcher>&  wter  = watchesTer[p];
+	  TernaryWatcher        *ti, *tj, *tend;
+	  for(ti = tj = (TernaryWatcher*)wter, tend = ti + wter.size(); ti != tend;) {
+	    lbool v1 = value(ti->other1);
+	    if(v1 == l_True) { *tj++ = *ti++; continue; }
+	    lbool v2 = value(ti->other2);
+	    if(v2 == l_True) {
+	      // Keep the true literal first, like a blocker
+	      Lit tmp = ti->other1; ti->other1 = ti->other2, ti->other2 = tmp;
+	      *tj++ = *ti++; continue; }
+	    if(v1 == l_Undef && v2 == l_Undef) {
+	      // Both others are open, the unwatched one 'c[2]' takes over
+	      CRef     cr        = ti->cref;
+	      Clause&  c         = ca[cr];
+	      Lit      false_lit = ~p;
+	      if (c[0] == false_lit)
+	        c[0] = c[1], c[1] = false_lit;
+	      assert(c[1] == false_lit && value(c[2]) == l_Undef);
+	      c[1] = c[2], c[2] = false_lit;
+	      watchesTer[~c[1]].push(TernaryWatcher(cr, c[0], false_lit));
+	      ti++;
+	      continue;
+	    }
+	    *tj++ = *ti;
+	    if(v1 == l_False && v2 == l_False) {
+	      confl = ti->cref;
+	      qhead = trail.size();
+	      for (ti++; ti != tend;)
+	        *tj++ = *ti++;
+	      break;
+	    }
+	    uncheckedEnqueue(v1 == l_False ? ti->other2 : ti->other1, ti->cref);
+	    ti++;
+	  }
+	  wter.shrink(ti - tj);
+	  if(confl != CRef_Undef) break;
+	}
+
 
 
         for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
@@ -945,6 +1128,7 @@ struct reduceDB_lt {
 
 void Solver::reduceDB()
 {
+  PROFILE_PHASE(phReduceDB);
 
   int     i, j;
   nbReduceDB++;
@@ -1005,6 +1189,42 @@ void Solver::rebuildOrderHeap()
 }
 
 
+// Calibration runs of -hybrid solve a cube without keeping what they learnt, so that every run
+// starts from the same clauses and the same schedule of 'reduceDB()'. Marked clauses that
+// 'reduceDB()' deleted in between are skipped; the marks survive garbage collection since
+// 'relocAll()' moves them with the learnts.
+void Solver::markLearnts()
+{
+    learnts.copyTo(markedLearnts);
+    markedReduce[0] = nbclausesbeforereduce;
+    int64_t next = curRestart * nbclausesbeforereduce - (int64_t)conflicts;
+    markedReduce[1] = next > 1 ? (int)next : 1;
+}
+
+
+void Solver::removeNewLearnts()
+{
+    assert(decisionLevel() == 0);
+    for (int i = 0; i < markedLearnts.size(); i++)
+        if (ca[markedLearnts[i]].mark() == 0) ca[markedLearnts[i]].mark(2);
+
+    int i, j;
+    for (i = j = 0; i < learnts.size(); i++){
+        Clause& c = ca[learnts[i]];
+        if (c.mark() == 2){
+            c.mark(0);
+            learnts[j++] = learnts[i];
+        }else if (c.mark() == 0)
+            removeClause(learnts[i]);
+    }
+    learnts.shrink(i - j);
+    markedLearnts.clear();
+    nbclausesbeforereduce = markedReduce[0];
+    curRestart = (conflicts + markedReduce[1] + nbclausesbeforereduce - 1) / nbclausesbeforereduce;
+    checkGarbage();
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  simplify : [void]  ->  [bool]
@@ -1015,6 +1235,7 @@ void Solver::rebuildOrderHeap()
 |________________________________________________________________________________________________@*/
 bool Solver::simplify()
 {
+    PROFILE_PHASE(phSimplify);
     assert(decisionLevel() == 0);
 
     if (!ok || propagate() != CRef_Undef)
@@ -1037,6 +1258,635 @@ bool Solver::simplify()
 }
 
 
+void Solver::certifyClause(const Lit* lits, int size, bool deleted)
+{
+    PROFILE_PHASE(phProof);
+    if (vbyte) {
+      write_char (deleted ? 'd' : 'a');
+      for (int i = 0; i < size; i++)
+        write_lit(lits[i]);
+      write_lit (mkLit(0));
+    }
+    else {
+      if (deleted) fprintf(certifiedOutput, "d ");
+      for (int i = 0; i < size; i++)
+        fprintf(certifiedOutput, "%i ", (var(lits[i]) + 1) * (-2 * sign(lits[i]) + 1));
+      fprintf(certifiedOutput, "0\n");
+    }
+}
+
+
+// The clause must be detached, otherwise it propagates its own last literal.
+bool Solver::vivifyClause(CRef cr, vec<Lit>& out)
+{
+    Clause& c = ca[cr];
+    out.clear();
+    for (int i = 0; i < c.size(); i++){
+        Lit p = c[i];
+        if (value(p) == l_True){            // Implied by the negation of the literals so far.
+            out.push(p);
+            break; }
+        if (value(p) == l_False) continue;  // Implied false, so 'p' is redundant.
+        out.push(p);
+        newDecisionLevel();
+        uncheckedEnqueue(~p);
+        if (propagate() != CRef_Undef) break;
+    }
+    cancelUntil(0);
+    return out.size() < c.size();
+}
+
+
+// Replaces the literals of the detached learnt clause 'cr' by 'lits', a subset of them, and
+// attaches it again. A unit is enqueued instead and the clause is freed. The clause must not be
+// satisfied, so it is no reason at level 0.
+bool Solver::shrinkLearnt(CRef cr, const vec<Lit>& lits)
+{
+    Clause& c = ca[cr];
+    assert(decisionLevel() == 0);
+    assert(lits.size() > 0 && lits.size() < c.size());
+    assert(!satisfied(c));
+
+    if (certifiedUNSAT) {
+      certifyClause(&lits[0], lits.size(), false);
+      certifyClause(&c[0], c.size(), true);
+    }
+
+    for (int i = 0; i < lits.size(); i++)
+        c[i] = lits[i];
+    c.shrink(c.size() - lits.size());
+    c.setSizeWithoutSelectors(c.size());
+    if (c.lbd() > (unsigned int)c.size()) c.setLBD(c.size());
+
+    if (c.size() == 1){
+        c.mark(1);
+        ca.free(cr);
+        nbUn++;
+        if (!enqueue(lits[0])) return ok = false;
+        return ok = (propagate() == CRef_Undef);
+    }
+
+    attachClause(cr);
+    return true;
+}
+
+
+struct inprocess_size_lt {
+    ClauseAllocator& ca;
+    inprocess_size_lt(ClauseAllocator& ca_) : ca(ca_) {}
+    bool operator () (CRef x, CRef y) { return ca[x].size() < ca[y].size(); }
+};
+
+static inline uint32_t abstractLits(const Clause& c)
+{
+    uint32_t abstraction = 0;
+    for (int i = 0; i < c.size(); i++)
+        abstraction |= 1 << (var(c[i]) & 31);
+    return abstraction;
+}
+
+// Same as 'Clause::subsumes()' but with the abstractions given explicitly, since learnt clauses use
+// their extra field for the activity.
+static inline Lit subsumesLits(const Clause& c, uint32_t c_abs, const Clause& d, uint32_t d_abs)
+{
+    if (d.size() < c.size() || (c_abs & ~d_abs) != 0)
+        return lit_Error;
+
+    Lit ret = lit_Undef;
+    for (int i = 0; i < c.size(); i++){
+        for (int j = 0; j < d.size(); j++)
+            if (c[i] == d[j])
+                goto ok;
+            else if (ret == lit_Undef && c[i] == ~d[j]){
+                ret = c[i];
+                goto ok;
+            }
+        return lit_Error;
+    ok:;
+    }
+    return ret;
+}
+
+
+bool Solver::subsumeLearnts()
+{
+    // Learnt clauses which may be subsumed or strengthened, with their occurrences:
+    vec<CRef>      cands;
+    vec<uint32_t>  abst;
+    vec<vec<int> > occs(nVars());
+    for (int i = 0; i < learnts.size(); i++){
+        Clause& c = ca[learnts[i]];
+        if (c.mark() || c.size() > inprocessSubLim) continue;
+        for (int k = 0; k < c.size(); k++)
+            occs[var(c[k])].push(cands.size());
+        cands.push(learnts[i]);
+        abst.push(abstractLits(c)); }
+
+    // All clauses are candidate subsumers, shortest first:
+    vec<CRef> queue;
+    for (int i = 0; i < clauses.size(); i++)
+        if (ca[clauses[i]].size() <= inprocessSubLim) queue.push(clauses[i]);
+    for (int i = 0; i < cands.size(); i++)
+        queue.push(cands[i]);
+    sort(queue, inprocess_size_lt(ca));
+
+    vec<Lit> lits;
+    int64_t  steps = 0;
+    for (int q = 0; q < queue.size() && steps < inprocessSteps; q++){
+        CRef    cr = queue[q];
+        Clause& c  = ca[cr];
+        if (c.mark() || satisfied(c)) continue;
+        uint32_t c_abs = abstractLits(c);
+
+        // Find best variable to scan:
+        Var best = var(c[0]);
+        for (int i = 1; i < c.size(); i++)
+            if (occs[var(c[i])].size() < occs[best].size())
+                best = var(c[i]);
+
+        vec<int>& cs = occs[best];
+        for (int j = 0; j < cs.size() && !c.mark(); j++){
+            int     d  = cs[j];
+            CRef    dr = cands[d];
+            Clause& dc = ca[dr];
+            if (dr == cr || dc.mark()) continue;
+            steps += dc.size();
+
+            Lit l = subsumesLits(c, c_abs, dc, abst[d]);
+            if (l == lit_Error) continue;
+            // Left to 'simplify()': a clause satisfied by a unit of this pass may be its reason.
+            if (satisfied(dc)) continue;
+            if (l == lit_Undef){
+                nbInprocSubsumed++;
+                removeClause(dr);
+                continue; }
+
+            // Self-subsuming resolution removes '~l' from 'dc':
+            nbInprocStrengthened++;
+            lits.clear();
+            for (int k = 0; k < dc.size(); k++)
+                if (dc[k] != ~l) lits.push(dc[k]);
+            detachClause(dr, true);
+            if (!shrinkLearnt(dr, lits)) return false;
+            if (dc.mark()) continue;
+            abst[d] = abstractLits(dc);
+            remove(occs[var(l)], d);
+            if (var(l) == best) j--;
+            queue.push(dr);
+        }
+    }
+
+    int i, j;
+    for (i = j = 0; i < learnts.size(); i++)
+        if (ca[learnts[i]].mark() == 0)
+            learnts[j++] = learnts[i];
+    learnts.shrink(i - j);
+    return true;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  inprocess : [void]  ->  [bool]
+|
+|  Description:
+|    Simplify the learnt clause database at the root level, typically between two cubes. Learnt
+|    clauses with a small LBD are vivified by propagating the negation of their literals, then
+|    learnt clauses are subsumed and strengthened by all clauses in the same way as
+|    'SimpSolver::backwardSubsumptionCheck()' does for the original ones. No variable is
+|    eliminated, so the variables of later assumptions need not be frozen.
+|    Returns FALSE if the clause set became unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool Solver::inprocess()
+{
+    PROFILE_PHASE(phInprocess);
+    assert(decisionLevel() == 0);
+
+    if (!ok || propagate() != CRef_Undef)
+        return ok = false;
+    if (incremental)   // Selectors must stay at the end of the learnt clauses.
+        return true;
+
+    nbInprocess++;
+
+    // Vivification must not disturb the saved phases:
+    vec<char> saved_polarity;
+    polarity.copyTo(saved_polarity);
+
+    uint64_t budget = propagations + (uint64_t)(inprocessEffort * (propagations - lastInprocessProps));
+    vec<Lit> lits;
+    int i, j;
+    for (i = j = 0; i < learnts.size(); i++){
+        CRef    cr = learnts[i];
+        Clause& c  = ca[cr];
+        if (c.mark()) continue;
+        if (ok && satisfied(c)){
+            removeClause(cr);
+            continue; }
+        if (!ok || c.size() <= 2 || c.lbd() > lbLBDVivifyClause || propagations >= budget){
+            learnts[j++] = cr;
+            continue; }
+
+        detachClause(cr, true);
+        if (!vivifyClause(cr, lits)){
+            attachClause(cr);
+            learnts[j++] = cr;
+            continue; }
+
+        nbVivifiedLits += c.size() - lits.size();
+        shrinkLearnt(cr, lits);
+        if (!c.mark()) learnts[j++] = cr;
+    }
+    learnts.shrink(i - j);
+    saved_polarity.copyTo(polarity);
+
+    if (!ok || !subsumeLearnts())
+        return ok = false;
+
+    lastInprocessProps = propagations;
+
+    // Force the removal of clauses satisfied by new units:
+    simpDB_assigns = -1;
+    simpDB_props   = 0;
+    checkGarbage();
+    return simplify();
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  probeCube : [void]  ->  [bool]
+|
+|  Description:
+|    Probes both phases of the variables chosen by 'selectProbes()' once the assumptions are
+|    propagated, within 'probeProps' propagations. A failed literal is refuted by the usual
+|    conflict analysis. A literal implied by both phases is learnt from the resolvent of its two
+|    implications, each expressed in the probe and the assumptions by 'analyzeFinal()'. Literals
+|    equivalent to a probe without any assumption are learnt as two binary clauses. All of these
+|    clauses follow from the formula alone, so sibling cubes keep what probing found.
+|    Returns FALSE if the assumptions are refuted or the clause set became unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool Solver::probeCube()
+{
+    PROFILE_PHASE(phProbe);
+    // Probing must not disturb the saved phases:
+    vec<char> saved_polarity;
+    polarity.copyTo(saved_polarity);
+    probeStamp.growTo(2 * nVars(), 0);
+
+    vec<Var>       cands;
+    vec<Lit>       implied, c, r;
+    vec<vec<Lit> > under, found, proof;
+    bool           root_ok = probeRoot();
+    int            root    = assumptions.size();
+    uint64_t       budget  = propagations + probeProps;
+    if (root_ok) selectProbes(cands);
+
+    for (int i = 0; root_ok && i < cands.size() && propagations < budget; i++){
+        Lit x = mkLit(cands[i], polarity[cands[i]]);
+        if (value(x) != l_Undef) continue;
+        nbProbes++;
+
+        if (probeFailed(x)){
+            root_ok = probeRoot();
+            continue; }
+        probeCount++;
+        for (int j = trail_lim[root] + 1; j < trail.size(); j++)
+            probeStamp[toInt(trail[j])] = probeCount;
+        cancelUntil(root);
+
+        if (probeFailed(~x)){
+            root_ok = probeRoot();
+            continue; }
+
+        // Literals implied by both phases, or equal to '~x' without assumptions, with their
+        // implication under '~x':
+        implied.clear(); under.clear();
+        for (int j = trail_lim[root] + 1; j < trail.size(); j++){
+            Lit p = trail[j];
+            if (probeStamp[toInt(p)] != probeCount && probeStamp[toInt(~p)] != probeCount) continue;
+            analyzeFinal(p, c);
+            if (probeStamp[toInt(p)] != probeCount && c.size() > 2) continue;
+            implied.push(p);
+            under.push();
+            c.copyTo(under.last()); }
+        cancelUntil(root);
+        if (implied.size() == 0) continue;
+
+        // Probing 'x' again assigns the same literals, now with their implication under 'x':
+        found.clear(); proof.clear();
+        newDecisionLevel();
+        uncheckedEnqueue(x);
+        propagate();
+        for (int j = 0; j < implied.size(); j++){
+            Lit p = implied[j];
+            if (value(p) == l_False){
+                analyzeFinal(~p, c);
+                if (c.size() > 2) continue;
+                found.push(); under[j].copyTo(found.last());
+                found.push(); c.copyTo(found.last());
+                nbEquivLits++;
+                continue; }
+
+            // Resolve 'p | x | ...' and 'p | ~x | ...' on 'x':
+            analyzeFinal(p, c);
+            r.clear();
+            seen[var(x)] = 1;
+            for (int k = 0; k < c.size(); k++)
+                if (!seen[var(c[k])]){ seen[var(c[k])] = 1; r.push(c[k]); }
+            for (int k = 0; k < under[j].size(); k++)
+                if (!seen[var(under[j][k])]){ seen[var(under[j][k])] = 1; r.push(under[j][k]); }
+            seen[var(x)] = 0;
+            for (int k = 0; k < r.size(); k++) seen[var(r[k])] = 0;
+            found.push(); r.copyTo(found.last());
+            if (certifiedUNSAT){
+                certifyClause(&c[0], c.size(), false);
+                certifyClause(&under[j][0], under[j].size(), false);
+                proof.push(); c.copyTo(proof.last());
+                proof.push(); under[j].copyTo(proof.last()); }
+            nbImpliedLits++;
+        }
+        cancelUntil(root);
+
+        // The resolvents are unit on the highest level of their other literals:
+        int bt = root;
+        for (int j = 0; j < found.size(); j++){
+            vec<Lit>& f = found[j];
+            if (value(f[0]) != l_Undef) continue;
+            int max_k = 1;
+            for (int k = 2; k < f.size(); k++)
+                if (level(var(f[k])) > level(var(f[max_k]))) max_k = k;
+            if (f.size() == 1) bt = 0;
+            else if (value(f[max_k]) == l_False){
+                Lit q = f[max_k]; f[max_k] = f[1]; f[1] = q;
+                if (level(var(q)) < bt) bt = level(var(q)); }
+        }
+        cancelUntil(bt);
+        for (int j = 0; j < found.size(); j++)
+            learnProbe(found[j], value(found[j][0]) == l_Undef && (found[j].size() == 1 || value(found[j][1]) == l_False));
+        for (int j = 0; j < proof.size(); j++)
+            certifyClause(&proof[j][0], proof[j].size(), true);
+        root_ok = probeRoot();
+    }
+
+    cancelUntil(0);
+    saved_polarity.copyTo(polarity);
+    return root_ok;
+}
+
+
+// Assigns the assumptions that are not yet assigned. Conflicts on the way are learnt as in
+// 'search()'. Returns FALSE if an assumption is false or the clause set is unsatisfiable.
+bool Solver::probeRoot()
+{
+    PROFILE_PHASE(phProbe);
+    vec<Lit>     learnt_clause, selectors;
+    int          backtrack_level;
+    unsigned int nblevels, szWoutSelectors;
+    for (;;){
+        CRef confl = propagate();
+        if (confl != CRef_Undef){
+            if (decisionLevel() == 0) return ok = false;
+            learnt_clause.clear(); selectors.clear();
+            analyze(confl, learnt_clause, selectors, backtrack_level, nblevels, szWoutSelectors);
+            cancelUntil(backtrack_level);
+            learnProbe(learnt_clause, true);
+        }else if (decisionLevel() < assumptions.size()){
+            Lit p = assumptions[decisionLevel()];
+            if (value(p) == l_False){
+                cancelUntil(0);
+                return false; }
+            newDecisionLevel();     // A dummy level if 'p' is already true.
+            if (value(p) == l_Undef) uncheckedEnqueue(p);
+        }else
+            return true;
+    }
+}
+
+
+bool Solver::probeFailed(Lit p)
+{
+    newDecisionLevel();
+    uncheckedEnqueue(p);
+    CRef confl = propagate();
+    if (confl == CRef_Undef) return false;
+
+    vec<Lit>     learnt_clause, selectors;
+    int          backtrack_level;
+    unsigned int nblevels, szWoutSelectors;
+    analyze(confl, learnt_clause, selectors, backtrack_level, nblevels, szWoutSelectors);
+    cancelUntil(backtrack_level);
+    learnProbe(learnt_clause, true);
+    nbFailedLits++;
+    return true;
+}
+
+
+// The 'probeCands' unassigned decision variables with the highest activity, which includes the
+// hints of the cube, or with the most binary implications in both phases.
+void Solver::selectProbes(vec<Var>& out)
+{
+    vec<double> score;
+    out.clear();
+    for (Var v = 0; v < nVars(); v++){
+        if (value(v) != l_Undef || !decision[v]) continue;
+        double s = probeOrder == 0 ? activity[v]
+                 : (watchesBin[mkLit(v, false)].size() + 1.0) * (watchesBin[mkLit(v, true)].size() + 1.0);
+        if (out.size() == probeCands){
+            if (s <= score.last()) continue;
+        }else{
+            out.push(); score.push(); }
+        int i;
+        for (i = out.size() - 1; i > 0 && score[i - 1] < s; i--){
+            out[i] = out[i - 1]; score[i] = score[i - 1]; }
+        out[i] = v; score[i] = s; }
+}
+
+
+// Adds 'c' as a learnt clause, watching its first two literals. If 'asserting', the first literal
+// is enqueued with the clause as reason.
+void Solver::learnProbe(vec<Lit>& c, bool asserting)
+{
+    unsigned int lbd = computeLBD(c);
+    if (certifiedUNSAT) certifyClause(&c[0], c.size(), false);
+    if (exchange != NULL) exportClause(c, lbd);
+
+    if (c.size() == 1){
+        if (asserting) uncheckedEnqueue(c[0]);
+        return; }
+    CRef cr = ca.alloc(c, true);
+    ca[cr].setLBD(lbd < (unsigned int)c.size() ? lbd : c.size());
+    ca[cr].setSizeWithoutSelectors(c.size());
+    learnts.push(cr);
+    attachClause(cr);
+    claBumpActivity(ca[cr]);
+    if (asserting) uncheckedEnqueue(c[0], cr);
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  walk : [void]  ->  [lbool]
+|
+|  Description:
+|    Runs probSAT (see 'LocalSearch.h') for 'walkFlips' flips on the formula under the assumptions,
+|    as 'reduceCube()' leaves it, starting from the saved phases (and so from the hints of a cube).
+|    The best assignment, extended by the propagated and the equivalent literals, becomes the saved
+|    phases, so that CDCL goes on near it. Returns l_True with 'model' set if it satisfies the
+|    problem clauses, l_Undef otherwise; refuting the assumptions is left to 'search()'.
+|________________________________________________________________________________________________@*/
+lbool Solver::walk()
+{
+    PROFILE_PHASE(phWalk);
+    vec<Lit> out, units, repr;
+    if (reduceCube(assumptions, out, units, repr) == l_False)
+        return l_Undef;
+    nbWalks++;
+
+    vec<char> init(nVars());
+    for (Var v = 0; v < nVars(); v++) init[v] = !polarity[v];
+    LocalSearch ls(out, nVars(), nbWalks * 0x9E3779B97F4A7C15ULL ^ (uint64_t)random_seed);
+    bool        found = ls.run(init, walkFlips);
+    nbWalkFlips += ls.flips;
+
+    vec<char>& val = ls.best;
+    for (int i = 0; i < units.size(); i++)
+        val[var(units[i])] = !sign(units[i]);
+    for (Var v = 0; v < nVars() && repr.size() > 0; v++){
+        Lit p = repr[toInt(mkLit(v))];
+        if (var(p) != v) val[v] = val[var(p)] ^ sign(p); }
+    for (Var v = 0; v < nVars(); v++)
+        polarity[v] = !val[v];
+    if (!found) return l_Undef;
+
+    for (Var v = 0; v < nVars(); v++)
+        model.push(lbool((bool)val[v]));
+    for (int i = 0; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        int j = 0;
+        while (j < c.size() && model[var(c[j])] != lbool(!sign(c[j]))) j++;
+        if (j == c.size()){ model.clear(); return l_Undef; } }
+    nbWalkModels++;
+    return l_True;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  Clause sharing between parallel workers:
+|
+|    Every worker solves its own cubes on a copy of the formula. Learnt units and clauses within the
+|    LBD and size limits are pushed to one ring per other worker; imports happen at restarts, when
+|    the solver is at level 0. The learnt clauses of a worker never depend on the cube, because
+|    assumptions are only decisions, except those containing selector variables in incremental
+|    mode. Clauses seen lately, in either direction, are skipped by their hash.
+|________________________________________________________________________________________________@*/
+static inline uint64_t clauseHash(const vec<Lit>& c)
+{
+    // Independent of the literal order:
+    uint64_t h = 0;
+    for (int i = 0; i < c.size(); i++){
+        uint64_t x = (uint64_t)toInt(c[i]) * 0x9E3779B97F4A7C15ULL;
+        h += x ^ (x >> 29); }
+    return h ^ c.size();
+}
+
+
+void Solver::setExchange(ClauseExchange* x, int id)
+{
+    exchange   = x;
+    exchangeId = id;
+    sharedHashes.clear();
+    sharedHashes.growTo(1 << 16, 0);
+}
+
+
+// The hashes are kept in a direct-mapped table of 2^16 slots (the top 16 bits of the mixed hash), so
+// the memory stays the same for the whole run. A clause is recognized until another one takes its
+// slot; a duplicate let through this way only costs a redundant learnt clause.
+bool Solver::sharedSeen(uint64_t h)
+{
+    uint64_t& slot = sharedHashes[(h * 0x9E3779B97F4A7C15ULL) >> 48];
+    if (slot == h) return true;
+    slot = h;
+    return false;
+}
+
+
+void Solver::copyClausesTo(Solver& to) const
+{
+    vec<Lit> lits;
+    while (to.nVars() < nVars())
+        to.newVar();
+    if (!ok){
+        to.addClause_(lits);
+        return; }
+
+    for (int i = 0; i < (trail_lim.size() == 0 ? trail.size() : trail_lim[0]); i++){
+        lits.clear();
+        lits.push(trail[i]);
+        to.addClause_(lits); }
+    for (int i = 0; i < clauses.size(); i++){
+        const Clause& c = ca[clauses[i]];
+        lits.clear();
+        for (int j = 0; j < c.size(); j++)
+            lits.push(c[j]);
+        to.addClause_(lits); }
+}
+
+
+void Solver::exportClause(const vec<Lit>& c, unsigned int lbd)
+{
+    if (c.size() > 1 && (lbd > shareLBD || c.size() > shareSize))
+        return;
+
+    if (sharedSeen(clauseHash(c))) return;
+
+    nbExported++;
+    for (int i = 0; i < exchange->nWorkers(); i++)
+        if (i != exchangeId)
+            exchange->ring(exchangeId, i).push(c, lbd);
+}
+
+
+bool Solver::importClauses()
+{
+    assert(decisionLevel() == 0);
+
+    vec<Lit>     c;
+    unsigned int lbd;
+    for (int w = 0; w < exchange->nWorkers(); w++){
+        if (w == exchangeId) continue;
+        ClauseRing& ring = exchange->ring(w, exchangeId);
+        while (ring.pop(c, lbd)){
+            if (sharedSeen(clauseHash(c))) continue;
+            nbImported++;
+
+            // Remove false literals and skip satisfied clauses:
+            int i, j;
+            for (i = j = 0; i < c.size(); i++)
+                if (value(c[i]) == l_True) break;
+                else if (value(c[i]) == l_Undef) c[j++] = c[i];
+            if (i < c.size()) continue;
+            c.shrink(i - j);
+
+            if (c.size() == 0)
+                return ok = false;
+            else if (c.size() == 1)
+                uncheckedEnqueue(c[0]);
+            else{
+                CRef cr = ca.alloc(c, true);
+                ca[cr].setLBD(lbd < (unsigned int)c.size() ? lbd : c.size());
+                ca[cr].setSizeWithoutSelectors(c.size());
+                learnts.push(cr);
+                attachClause(cr);
+            }
+        }
+    }
+    return true;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  search : (nof_conflicts : int) (params : const SearchParams&)  ->  [lbool]
@@ -1078,6 +1928,7 @@ lbool Solver::search(int nof_conflicts)
 	  }
 
 	  trailQueue.push(trail.size());
+	  if (trail.size() > maxTrail) maxTrail = trail.size();
 	  // BLOCK RESTART (CP 2012 paper)
 	  if( conflictsRestarts>LOWER_BOUND_FOR_BLOCKING_RESTART && lbdQueue.isvalid()  && trail.size()>R*trailQueue.getavg()) {
 	    lbdQueue.fastclear();
@@ -1095,6 +1946,7 @@ lbool Solver::search(int nof_conflicts)
             cancelUntil(backtrack_level);
 
             if (certifiedUNSAT) {
+              PROFILE_PHASE(phProof);
               if (vbyte) {
                 write_char ('a');
                 for (int i = 0; i < learnt_clause.size(); i++)
@@ -1109,6 +1961,10 @@ lbool Solver::search(int nof_conflicts)
               }
             }
 
+            // Clauses with selectors depend on assumptions and must stay local:
+            if (exchange != NULL && (int)szWoutSelectors == learnt_clause.size())
+                exportClause(learnt_clause, nblevels);
+
             if (learnt_clause.size() == 1){
 	      uncheckedEnqueue(learnt_clause[0]);nbUn++;
             }else{
@@ -1137,6 +1993,8 @@ lbool Solver::search(int nof_conflicts)
 	      bt = (decisionLevel()<assumptions.size()) ? decisionLevel() : assumptions.size();
 	    }
 	    cancelUntil(bt);
+	    if (exchange != NULL && decisionLevel() == 0 && !importClauses())
+	      return l_False;
 	    return l_Undef; }
 
            // Simplify the set of problem clauses:
@@ -1163,6 +2021,7 @@ lbool Solver::search(int nof_conflicts)
                     analyzeFinal(~p, conflict);
 
                     if (certifiedUNSAT) {
+                      PROFILE_PHASE(phProof);
                       if (vbyte) {
                         write_char ('a');
                         for (int i = 0; i < conflict.size(); i++)
@@ -1179,6 +2038,8 @@ lbool Solver::search(int nof_conflicts)
                       }
                     }
                     cancelUntil(0);
+                    if (exchange != NULL && !incremental)
+                        exportClause(conflict, conflict.size());
                     addClause_(conflict);
                     nbclausesbeforereduce = firstReduceDB;
                     return l_False;
@@ -1247,6 +2108,7 @@ void Solver::printIncrementalStats() {
 // NOTE: assumptions passed in member-variable 'assumptions'.
 lbool Solver::solve_()
 {
+  PROFILE_PHASE(phSearch);
 
   if(incremental && certifiedUNSAT) {
     printf("Can not use incremental and certified unsat in the same time\n");
@@ -1258,6 +2120,7 @@ lbool Solver::solve_()
     double curTime = cpuTime();
 
     solves++;
+    if (solves == 1) attachTernaries();
 
     lbool   status        = l_Undef;
     if(!incremental && verbosity>=1) {
@@ -1280,6 +2143,15 @@ lbool Solver::solve_()
       printf("c =========================================================================================================\n");
     }
 
+    // Local search on the first cubes, which march_cu orders by their chance to be satisfiable:
+    maxTrail = walkedTrail = 0;
+    if (walkFlips > 0 && solves <= (uint64_t)walkCubes)
+        status = walk();
+
+    // A cube refuted while probing is left to 'search()', which finds the false assumption at once:
+    if (status == l_Undef && probeCands > 0 && assumptions.size() > 0 && !incremental && !probeCube() && !ok)
+        status = l_False;
+
     // Search:
     int curr_restarts = 0;
     while (status == l_Undef){
@@ -1287,6 +2159,13 @@ lbool Solver::solve_()
 
         if (!withinBudget()) break;
         curr_restarts++;
+
+        // Local search again once a conflict came closer to a full assignment than before, while
+        // flipping costs less than a quarter of the propagations:
+        if (status == l_Undef && walkFlips > 0 && walkTrail > 0 && decisionLevel() == 0
+            && maxTrail > walkedTrail && maxTrail >= walkTrail * nVars() && 4 * nbWalkFlips <= propagations){
+            walkedTrail = maxTrail;
+            status = walk(); }
     }
 
     if (!incremental && verbosity >= 1)
@@ -1300,14 +2179,15 @@ lbool Solver::solve_()
     }
 */
 
-    if (status == l_True){
-        // Extend & copy model:
+    if (status == l_True && model.size() == 0){
+        // Extend & copy model (local search has its own):
         model.growTo(nVars());
         for (int i = 0; i < nVars(); i++) model[i] = value(i);
     }else if (status == l_False && conflict.size() == 0)
         ok = false;
 
     cancelUntil(0);
+    undoHints();
 
     double finalTime = cpuTime();
     if(status==l_True) {
@@ -1401,6 +2281,394 @@ void Solver::toDimacs(FILE* f, const vec<Lit>& assumps)
 }
 
 
+//=================================================================================================
+// Exporting cubes:
+//
+// 'exportCube()' writes the formula under a cube for an external solver. The cube is propagated on
+// a new decision level, equivalent literals (strongly connected components of the binary clauses)
+// are replaced by the literal of their smallest variable and the remaining variables are renumbered
+// from 1. Units produced by the substitution are propagated as well before the CNF is written.
+// Comment lines map the result back to the input numbering:
+//
+//   c cube <id>
+//   c units <assigned literals> 0
+//   c map <input variable of variable 1, 2, ...> 0
+//   c equiv <variable> <equivalent literal> ... 0
+//
+// Returns l_False if the cube is refuted (an empty clause is written), l_True if no clause remains.
+// 'reduceCube()' computes the same formula in memory for the hybrid conquer driver.
+
+// Maps every literal (by 'toInt') to its representative. Returns FALSE if a literal is equivalent
+// to its negation. 'lits' holds clauses terminated by 'lit_Undef', only binary ones are edges.
+static bool findEquivalences(int nvars, const vec<Lit>& lits, vec<Lit>& repr)
+{
+    int       nlits = 2 * nvars;
+    vec<int>  start(nlits + 1, 0), edges, index(nlits, -1), low(nlits, 0), stack, path, pos;
+    vec<char> onStack(nlits, 0);
+
+    repr.clear();
+    for (int i = 0; i < nlits; i++) repr.push(toLit(i));
+
+    // Implications '~a -> b' and '~b -> a' in compressed rows:
+    for (int i = 0, j; i < lits.size(); i = j + 1){
+        for (j = i; lits[j] != lit_Undef; j++);
+        if (j - i != 2) continue;
+        start[toInt(~lits[i]) + 1]++;
+        start[toInt(~lits[i + 1]) + 1]++; }
+    for (int i = 0; i < nlits; i++) start[i + 1] += start[i];
+    edges.growTo(start[nlits]);
+    vec<int> fill; start.copyTo(fill);
+    for (int i = 0, j; i < lits.size(); i = j + 1){
+        for (j = i; lits[j] != lit_Undef; j++);
+        if (j - i != 2) continue;
+        edges[fill[toInt(~lits[i])]++]     = toInt(lits[i + 1]);
+        edges[fill[toInt(~lits[i + 1])]++] = toInt(lits[i]); }
+
+    // Tarjan's algorithm with an explicit path:
+    int counter = 0;
+    for (int r = 0; r < nlits; r++){
+        if (index[r] != -1 || start[r] == start[r + 1]) continue;
+        index[r] = low[r] = counter++;
+        stack.push(r); onStack[r] = 1;
+        path.push(r); pos.push(start[r]);
+        while (path.size() > 0){
+            int u = path.last();
+            if (pos.last() < start[u + 1]){
+                int w = edges[pos.last()++];
+                if (index[w] == -1){
+                    index[w] = low[w] = counter++;
+                    stack.push(w); onStack[w] = 1;
+                    path.push(w); pos.push(start[w]);
+                }else if (onStack[w] && index[w] < low[u])
+                    low[u] = index[w];
+                continue; }
+
+            path.pop(); pos.pop();
+            if (path.size() > 0 && low[u] < low[path.last()]) low[path.last()] = low[u];
+            if (low[u] != index[u]) continue;
+
+            int k = stack.size();
+            do k--; while (stack[k] != u);
+            Lit best = toLit(u);
+            for (int i = k; i < stack.size(); i++)
+                if (var(toLit(stack[i])) < var(best)) best = toLit(stack[i]);
+            for (int i = k; i < stack.size(); i++){
+                // A component containing 'x' and '~x' also contains 'best' and '~best':
+                if (stack[i] == toInt(~best)) return false;
+                repr[stack[i]] = best;
+                onStack[stack[i]] = 0; }
+            stack.shrink(stack.size() - k);
+        }
+    }
+    return true;
+}
+
+
+// Writes 'n ' without the overhead of 'fprintf()'.
+static inline void putInt(FILE* f, int n)
+{
+    char buf[16], *p = buf + sizeof(buf);
+    unsigned u = n < 0 ? -(unsigned)n : n;
+    *--p = ' ';
+    do *--p = '0' + u % 10; while (u /= 10);
+    if (n < 0) *--p = '-';
+    fwrite(p, 1, buf + sizeof(buf) - p, f);
+}
+
+
+lbool Solver::reduceCube(const vec<Lit>& cube, vec<Lit>& out, vec<Lit>& units, vec<Lit>& repr)
+{
+    vec<Lit>  lits;                 // Clauses terminated by 'lit_Undef'.
+    vec<char> seen;
+    lbool     ret = ok ? l_Undef : l_False;
+    int       nclauses = 0;
+
+    if (ret == l_Undef){
+        newDecisionLevel();
+        for (int i = 0; i < cube.size() && ret == l_Undef; i++)
+            if (value(cube[i]) == l_False) ret = l_False;
+            else if (value(cube[i]) == l_Undef) uncheckedEnqueue(cube[i]);
+        if (ret == l_Undef && propagate() != CRef_Undef) ret = l_False; }
+
+    out.clear();
+    while (ret == l_Undef){
+        lits.clear();
+        for (int i = 0; i < clauses.size(); i++){
+            Clause& c = ca[clauses[i]];
+            if (satisfied(c)) continue;
+            for (int j = 0; j < c.size(); j++)
+                if (value(c[j]) == l_Undef) lits.push(c[j]);
+            lits.push(lit_Undef); }
+
+        if (!findEquivalences(nVars(), lits, repr)){ ret = l_False; break; }
+
+        out.clear(); nclauses = 0;
+        seen.clear(); seen.growTo(2 * nVars(), 0);
+        units.clear();
+        for (int i = 0, j; i < lits.size(); i = j + 1){
+            int  begin = out.size();
+            bool taut  = false;
+            for (j = i; lits[j] != lit_Undef; j++){
+                Lit p = repr[toInt(lits[j])];
+                if (seen[toInt(~p)]) taut = true;
+                else if (!seen[toInt(p)]){ seen[toInt(p)] = 1; out.push(p); } }
+            for (int k = begin; k < out.size(); k++) seen[toInt(out[k])] = 0;
+            if (taut) out.shrink(out.size() - begin);
+            else if (out.size() - begin == 1){
+                units.push(out[begin]);
+                out.shrink(1);
+            }else{
+                out.push(lit_Undef);
+                nclauses++; } }
+
+        if (units.size() == 0) break;
+        for (int i = 0; i < units.size() && ret == l_Undef; i++)
+            if (value(units[i]) == l_False) ret = l_False;
+            else if (value(units[i]) == l_Undef) uncheckedEnqueue(units[i]);
+        if (ret == l_Undef && propagate() != CRef_Undef) ret = l_False;
+    }
+
+    trail.copyTo(units);
+    cancelUntil(0);
+    if (ret == l_False) out.clear();
+    else if (nclauses == 0) ret = l_True;
+    return ret;
+}
+
+
+// Counts the problem clauses that the propagated cube does not satisfy by their free literals,
+// 'lengths[k]' for 'k' free literals and the last entry for all longer ones. 'assigned' is the
+// number of literals the cube assigns, its own included.
+lbool Solver::cubeShape(const vec<Lit>& cube, vec<int>& lengths, int& assigned)
+{
+    for (int i = 0; i < lengths.size(); i++) lengths[i] = 0;
+    assigned = 0;
+    if (!ok) return l_False;
+
+    lbool ret  = l_Undef;
+    int   root = trail.size();
+    newDecisionLevel();
+    for (int i = 0; i < cube.size() && ret == l_Undef; i++)
+        if (value(cube[i]) == l_False) ret = l_False;
+        else if (value(cube[i]) == l_Undef) uncheckedEnqueue(cube[i]);
+    if (ret == l_Undef && propagate() != CRef_Undef) ret = l_False;
+
+    if (ret == l_Undef){
+        assigned = trail.size() - root;
+        int last = lengths.size() - 1;
+        for (int i = 0; i < clauses.size(); i++){
+            const Clause& c = ca[clauses[i]];
+            int free = 0;
+            for (int j = 0; j < c.size() && free >= 0; j++)
+                if (value(c[j]) == l_True) free = -1;
+                else if (value(c[j]) == l_Undef) free++;
+            if (free >= 0) lengths[free < last ? free : last]++; }
+    }
+    cancelUntil(0);
+    return ret;
+}
+
+
+lbool Solver::exportCube(FILE* f, const vec<Lit>& cube, int id)
+{
+    vec<Lit> out, units, repr;
+    lbool    ret = reduceCube(cube, out, units, repr);
+
+    fprintf(f, "c cube %d\n", id);
+    if (ret == l_False)
+        fprintf(f, "p cnf 0 1\n0\n");
+    else{
+        vec<Var> map; Var max = 0;
+        int      nclauses = 0;
+        for (int i = 0; i < out.size(); i++)
+            if (out[i] != lit_Undef) mapVar(var(out[i]), map, max);
+            else nclauses++;
+        vec<Var> inv(max);
+        for (int i = 0; i < map.size(); i++)
+            if (map[i] != -1) inv[map[i]] = i;
+
+        fputs("c units ", f);
+        for (int i = 0; i < units.size(); i++)
+            putInt(f, sign(units[i]) ? -(var(units[i]) + 1) : var(units[i]) + 1);
+        fputs("0\nc map ", f);
+        for (int i = 0; i < max; i++)
+            putInt(f, inv[i] + 1);
+        vec<char> assigned(nVars(), 0);
+        for (int i = 0; i < units.size(); i++) assigned[var(units[i])] = 1;
+        fputs("0\nc equiv ", f);
+        for (Var v = 0; v < nVars(); v++){
+            Lit p = repr[toInt(mkLit(v))];
+            if (var(p) == v || assigned[v]) continue;
+            putInt(f, v + 1);
+            putInt(f, sign(p) ? -(var(p) + 1) : var(p) + 1); }
+        fprintf(f, "0\np cnf %d %d\n", max, nclauses);
+        for (int i = 0; i < out.size(); i++)
+            if (out[i] == lit_Undef) fputs("0\n", f);
+            else putInt(f, sign(out[i]) ? -(map[var(out[i])] + 1) : map[var(out[i])] + 1);
+    }
+    return ret;
+}
+
+
+//=================================================================================================
+// Solver images:
+//
+// An image holds the state after parsing and root-level simplification: the clause arena, the
+// clause lists, the watches, the root-level trail and the variable activities and phases. All
+// fields are native 32-bit words (and doubles for activities), so an image is only portable
+// between builds with the same layout, which the header checks.
+
+static const char     image_magic[8] = { 'i', 'g', 'l', 'u', 'c', 'o', 's', 'e' };
+static const uint32_t image_version  = 1;
+
+struct ImageHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t word_sizes;        // sizeof(Lit), sizeof(CRef) and sizeof(double), one byte each.
+    uint32_t vars, arena, extra, clauses, learnts, trail, watchers, bin_watchers;
+};
+
+void Solver::writeWatches(FILE* f, OccLists<Lit, vec<Watcher>, WatcherDeleted>& ws, int vars)
+{
+    for (int i = 0; i < 2 * vars; i++){
+        uint32_t n = ws[toLit(i)].size();
+        fwrite(&n, sizeof(n), 1, f); }
+    for (int i = 0; i < 2 * vars; i++){
+        vec<Watcher>& w = ws[toLit(i)];
+        for (int j = 0; j < w.size(); j++){
+            uint32_t x[2] = { w[j].cref, (uint32_t)toInt(w[j].blocker) };
+            fwrite(x, sizeof(x), 1, f); }
+    }
+}
+
+bool Solver::readWatches(FILE* f, OccLists<Lit, vec<Watcher>, WatcherDeleted>& ws, int vars)
+{
+    vec<uint32_t> sizes(2 * vars), x;
+    if (fread((uint32_t*)sizes, sizeof(uint32_t), sizes.size(), f) != (size_t)sizes.size())
+        return false;
+    for (int i = 0; i < 2 * vars; i++){
+        uint32_t      n = sizes[i];
+        vec<Watcher>& w = ws[toLit(i)];
+        x.growTo(2 * n);
+        if (fread((uint32_t*)x, sizeof(uint32_t), 2 * n, f) != 2 * n)
+            return false;
+        w.capacity(n);
+        for (uint32_t j = 0; j < n; j++)
+            w.push(Watcher(x[2 * j], toLit(x[2 * j + 1])));
+    }
+    return true;
+}
+
+
+bool Solver::saveImage(const char* file)
+{
+    assert(decisionLevel() == 0);
+    if (!ok || propagate() != CRef_Undef)
+        return ok = false;
+
+    // Images have the watches of the parser, taken before the first search:
+    if (ternaryWatches) return false;
+
+    // Compact the arena and clean the watches:
+    garbageCollect();
+
+    FILE* f = fopen(file, "wb");
+    if (f == NULL) return false;
+
+    ImageHeader h;
+    memcpy(h.magic, image_magic, sizeof(h.magic));
+    h.version      = image_version;
+    h.word_sizes   = sizeof(Lit) | sizeof(CRef) << 8 | sizeof(double) << 16;
+    h.vars         = nVars();
+    h.arena        = ca.size();
+    h.extra        = ca.extra_clause_field;
+    h.clauses      = clauses.size();
+    h.learnts      = learnts.size();
+    h.trail        = trail.size();
+    h.watchers     = h.bin_watchers = 0;
+    for (int i = 0; i < 2 * nVars(); i++){
+        h.watchers     += watches   [toLit(i)].size();
+        h.bin_watchers += watchesBin[toLit(i)].size(); }
+    fwrite(&h, sizeof(h), 1, f);
+
+    if (ca.size() > 0)
+        fwrite(ca.RegionAllocator<uint32_t>::lea(0), sizeof(uint32_t), ca.size(), f);
+    fwrite((const CRef*)clauses, sizeof(CRef), clauses.size(), f);
+    fwrite((const CRef*)learnts, sizeof(CRef), learnts.size(), f);
+    fwrite((const Lit*)trail, sizeof(Lit), trail.size(), f);
+    fwrite((const double*)activity, sizeof(double), nVars(), f);
+    fwrite((const char*)polarity, sizeof(char), nVars(), f);
+    fwrite((const char*)decision, sizeof(char), nVars(), f);
+    writeWatches(f, watches, nVars());
+    writeWatches(f, watchesBin, nVars());
+
+    bool written = !ferror(f);
+    return fclose(f) == 0 && written;
+}
+
+
+bool Solver::loadImage(const char* file)
+{
+    assert(nVars() == 0 && ca.size() == 0);
+
+    FILE* f = fopen(file, "rb");
+    if (f == NULL) return false;
+    struct stat st;
+    ImageHeader h;
+    if (fstat(fileno(f), &st) != 0 || fread(&h, sizeof(h), 1, f) != 1){
+        fclose(f);
+        return false; }
+    size_t expected = sizeof(h) + sizeof(uint32_t) * (h.arena + h.clauses + h.learnts + h.trail)
+        + (sizeof(double) + 2) * h.vars + 2 * sizeof(uint32_t) * (2 * h.vars + h.watchers + h.bin_watchers);
+    if (memcmp(h.magic, image_magic, sizeof(h.magic)) != 0 || h.version != image_version
+        || h.word_sizes != (sizeof(Lit) | sizeof(CRef) << 8 | sizeof(double) << 16)
+        || expected != (size_t)st.st_size){
+        fclose(f);
+        return false; }
+
+    for (uint32_t v = 0; v < h.vars; v++)
+        newVar();
+
+    // The sections are read straight into the solver's own buffers:
+    vec<Lit>  units(h.trail);
+    vec<char> dec(h.vars);
+    bool      read = true;
+    ca.extra_clause_field = h.extra;
+    if (h.arena > 0){
+        ca.RegionAllocator<uint32_t>::alloc(h.arena);
+        read = fread(ca.RegionAllocator<uint32_t>::lea(0), sizeof(uint32_t), h.arena, f) == h.arena; }
+    clauses.growTo(h.clauses);
+    learnts.growTo(h.learnts);
+    read = read
+        && fread((CRef*)clauses, sizeof(CRef), h.clauses, f) == h.clauses
+        && fread((CRef*)learnts, sizeof(CRef), h.learnts, f) == h.learnts
+        && fread((Lit*)units, sizeof(Lit), h.trail, f) == h.trail
+        && fread((double*)activity, sizeof(double), h.vars, f) == h.vars
+        && fread((char*)polarity, sizeof(char), h.vars, f) == h.vars
+        && fread((char*)dec, sizeof(char), h.vars, f) == h.vars
+        && readWatches(f, watches, h.vars)
+        && readWatches(f, watchesBin, h.vars);
+    fclose(f);
+    if (!read) return false;
+
+    for (int i = 0; i < clauses.size(); i++) clauses_literals += ca[clauses[i]].size();
+    for (int i = 0; i < learnts.size(); i++) learnts_literals += ca[learnts[i]].size();
+
+    // Root-level assignments, already propagated:
+    for (int i = 0; i < units.size(); i++)
+        uncheckedEnqueue(units[i]);
+    qhead = trail.size();
+
+    for (uint32_t v = 0; v < h.vars; v++)
+        setDecisionVar(v, dec[v]);
+
+    rebuildOrderHeap();
+    simpDB_assigns = nAssigns();
+    simpDB_props   = clauses_literals + learnts_literals;
+    return true;
+}
+
+
 //=================================================================================================
 // Garbage Collection methods:
 
@@ -1411,6 +2679,7 @@ void Solver::relocAll(ClauseAllocator& to)
     // for (int i = 0; i < watches.size(); i++)
     watches.cleanAll();
     watchesBin.cleanAll();
+    watchesTer.cleanAll();
     for (int v = 0; v < nVars(); v++)
         for (int s = 0; s < 2; s++){
             Lit p = mkLit(v, s);
@@ -1421,6 +2690,9 @@ void Solver::relocAll(ClauseAllocator& to)
             vec<Watcher>& ws2 = watchesBin[p];
             for (int j = 0; j < ws2.size(); j++)
                 ca.reloc(ws2[j].cref, to);
+            vec<TernaryWatcher>& ws3 = watchesTer[p];
+            for (int j = 0; j < ws3.size(); j++)
+                ca.reloc(ws3[j].cref, to);
         }
 
     // All reasons:
@@ -1436,6 +2708,12 @@ void Solver::relocAll(ClauseAllocator& to)
     //
     for (int i = 0; i < learnts.size(); i++)
         ca.reloc(learnts[i], to);
+    int i, j;
+    for (i = j = 0; i < markedLearnts.size(); i++)
+        if (ca[markedLearnts[i]].reloced()){
+            ca.reloc(markedLearnts[i], to);
+            markedLearnts[j++] = markedLearnts[i]; }
+    markedLearnts.shrink(i - j);
 
     // All original:
     //
@@ -1446,6 +2724,7 @@ void Solver::relocAll(ClauseAllocator& to)
 
 void Solver::garbageCollect()
 {
+    PROFILE_PHASE(phGarbage);
     // Initialize the next region to a size corresponding to the estimated utilization degree. This
     // is not precise but should avoid some unnecessary reallocations for the new region:
     ClauseAllocator to(ca.size() - ca.wasted());
@@ -36,6 +36,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "core/SolverTypes.h"
 #include "core/BoundedQueue.h"
 #include "core/Constants.h"
+#include "core/ClauseExchange.h"
+#include "core/Profile.h"
 
 
 namespace Glucose {
@@ -66,6 +68,11 @@ public:
     // Solving:
     //
     bool    simplify     ();                        // Removes already satisfied clauses.
+    bool    inprocess    ();                        // Vivifies, subsumes and strengthens learnt clauses at the root level.
+    void    markLearnts  ();                        // Remember the current learnt clauses.
+    void    removeNewLearnts();                     // Remove the learnt clauses added since 'markLearnts()'.
+    void    copyClausesTo(Solver& to) const;        // Adds the original clauses and root-level units to another solver.
+    void    setExchange  (ClauseExchange* x, int id); // Shares short learnt clauses with the other workers of 'x'.
     bool    solve        (const vec<Lit>& assumps); // Search for a model that respects a given set of assumptions.
     lbool   solveLimited (const vec<Lit>& assumps); // Search for a model that respects a given set of assumptions (With resource constraints).
     bool    solve        ();                        // Search without assumptions.
@@ -75,8 +82,13 @@ public:
     bool    okay         () const;                  // FALSE means solver is in a conflicting state
 
     void    toDimacs     (FILE* f, const vec<Lit>& assumps);            // Write CNF to file in DIMACS-format.
+    bool    saveImage    (const char* file);                          // Write the root-level solver state to a binary image.
+    bool    loadImage    (const char* file);                          // Read an image into a solver without variables.
     void    toDimacs     (const char *file, const vec<Lit>& assumps);
     void    toDimacs     (FILE* f, Clause& c, vec<Var>& map, Var& max);
+    lbool   exportCube   (FILE* f, const vec<Lit>& cube, int id);       // Write the formula under a cube, simplified and renumbered.
+    lbool   reduceCube   (const vec<Lit>& cube, vec<Lit>& out, vec<Lit>& units, vec<Lit>& repr); // The formula written by 'exportCube()', not renumbered.
+    lbool   cubeShape    (const vec<Lit>& cube, vec<int>& lengths, int& assigned); // Count the remaining clauses under a cube by their free literals.
     void printLit(Lit l);
     void printClause(CRef c);
     void printInitialClause(CRef c);
@@ -90,6 +102,7 @@ public:
     //
     void    setPolarity    (Var v, bool b); // Declare which polarity the decision heuristic should use for a variable. Requires mode 'polarity_user'.
     void    setDecisionVar (Var v, bool b); // Declare if a variable should be eligible for selection in the decision heuristic.
+    void    hintCube       (const vec<Lit>& hints); // Decide on these literals first, in this order, in the next solve (phase and activity hints of a cube).
 
     // Read state:
     //
@@ -150,6 +163,26 @@ public:
     int lbSizeMinimizingClause;
     unsigned int lbLBDMinimizingClause;
 
+    // Constants for inprocessing learnt clauses
+    unsigned int lbLBDVivifyClause;
+    int inprocessSubLim;
+    double inprocessEffort;
+    int64_t inprocessSteps;
+
+    // Constants for sharing learnt clauses
+    unsigned int shareLBD;
+    int shareSize;
+
+    // Constants for probing at the cube root
+    int probeCands;
+    int probeOrder;
+    int64_t probeProps;
+
+    // Constants for local search under the assumptions
+    int64_t walkFlips;
+    int walkCubes;
+    double walkTrail;
+
     double    var_decay;
     double    clause_decay;
     double    random_var_freq;
@@ -159,6 +192,7 @@ public:
     bool      rnd_pol;            // Use random polarities for branching heuristics.
     bool      rnd_init_act;       // Initialize variable activities with a small random value.
     double    garbage_frac;       // The fraction of wasted memory allowed before a garbage collection is triggered.
+    double    ternary_frac;       // Watch ternary clauses inline if they are at least this fraction of the problem clauses.
 
     // Certified UNSAT ( Thanks to Marijn Heule)
     FILE*               certifiedOutput;
@@ -172,6 +206,11 @@ public:
     //
     uint64_t nbRemovedClauses,nbReducedClauses,nbDL2,nbBin,nbUn,nbReduceDB,solves, starts, decisions, rnd_decisions, propagations, conflicts,conflictsRestarts,nbstopsrestarts,nbstopsrestartssame,lastblockatrestart;
     uint64_t dec_vars, clauses_literals, learnts_literals, max_literals, tot_literals;
+    uint64_t nbInprocess, nbVivifiedLits, nbInprocSubsumed, nbInprocStrengthened;
+    uint64_t nbExported, nbImported;
+    uint64_t nbProbes, nbFailedLits, nbImpliedLits, nbEquivLits;
+    uint64_t nbWalks, nbWalkModels, nbWalkFlips;
+    PhaseProfile profile;   // Cycles by phase, with GLUCOSE_PROFILE only.
 
 protected:
     long curRestart;
@@ -188,11 +227,22 @@ protected:
         bool operator!=(const Watcher& w) const { return cref != w.cref; }
     };
 
+    // A watcher of a ternary clause carries both other literals. Propagation only reads the clause
+    // to move the watch, see 'propagate()':
+    struct TernaryWatcher {
+        CRef cref;
+        Lit  other1, other2;
+        TernaryWatcher(CRef cr, Lit p, Lit q) : cref(cr), other1(p), other2(q) {}
+        bool operator==(const TernaryWatcher& w) const { return cref == w.cref; }
+        bool operator!=(const TernaryWatcher& w) const { return cref != w.cref; }
+    };
+
     struct WatcherDeleted
     {
         const ClauseAllocator& ca;
         WatcherDeleted(const ClauseAllocator& _ca) : ca(_ca) {}
-        bool operator()(const Watcher& w) const { return ca[w.cref].mark() == 1; }
+        template<class W>
+        bool operator()(const W& w) const { return ca[w.cref].mark() == 1; }
     };
 
     struct VarOrderLt {
@@ -208,13 +258,21 @@ protected:
     bool                ok;               // If FALSE, the constraints are already unsatisfiable. No part of the solver state may be used!
     double              cla_inc;          // Amount to bump next clause with.
     vec<double>         activity;         // A heuristic measurement of the activity of a variable.
+    vec<Var>            hinted;           // Variables lifted by 'hintCube()' for the next solve,
+    vec<double>         hintBonus;        // the activity each of them got (see 'hintScale'),
     double              var_inc;          // Amount to bump next variable with.
+    double              hintScale;        // Rescaling of the activities since the hints were given.
     OccLists<Lit, vec<Watcher>, WatcherDeleted>
                         watches;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
     OccLists<Lit, vec<Watcher>, WatcherDeleted>
                         watchesBin;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
+    OccLists<Lit, vec<TernaryWatcher>, WatcherDeleted>
+                        watchesTer;       // 'watches' of the ternary clauses, see 'attachTernaries()'.
+    bool                ternaryWatches;   // Ternary clauses are in 'watchesTer' instead of 'watches'.
     vec<CRef>           clauses;          // List of problem clauses.
     vec<CRef>           learnts;          // List of learnt clauses.
+    vec<CRef>           markedLearnts;    // Learnt clauses at the last 'markLearnts()',
+    int                 markedReduce[2];  // and 'nbclausesbeforereduce' and the conflicts to the next 'reduceDB()'.
 
     vec<lbool>          assigns;          // The current assignments.
     vec<char>           polarity;         // The preferred polarity of each variable.
@@ -266,6 +324,22 @@ protected:
     int64_t             propagation_budget; // -1 means no budget.
     bool                asynch_interrupt;
 
+    // Inprocessing:
+    uint64_t            lastInprocessProps; // Propagations when the last inprocessing round finished.
+
+    // Clause sharing:
+    ClauseExchange*     exchange;           // NULL unless running as a parallel worker.
+    int                 exchangeId;
+    vec<uint64_t>       sharedHashes;       // Hash of the last clause exported or imported in each slot.
+
+    // Probing:
+    vec<unsigned int>   probeStamp;         // 'probeStamp[toInt(p)] == probeCount' if the last probe implied 'p'.
+    unsigned int        probeCount;
+
+    // Local search:
+    int                 maxTrail;           // Longest trail at a conflict in this call of 'solve_()'.
+    int                 walkedTrail;        // 'maxTrail' at the last walk of this call.
+
 
     // Variables added for incremental mode
     int incremental; // Use incremental SAT Solver
@@ -292,18 +366,35 @@ protected:
     void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
     void     removeSatisfied  (vec<CRef>& cs);                                         // Shrink 'cs' to contain only non-satisfied clauses.
     void     rebuildOrderHeap ();
+    bool     vivifyClause     (CRef cr, vec<Lit>& out);                              // Shortens a detached clause by propagation.
+    bool     shrinkLearnt     (CRef cr, const vec<Lit>& lits);                       // Replaces a detached learnt clause by a subset.
+    bool     subsumeLearnts   ();                                                    // Backward subsumption on the learnt clauses.
+    void     certifyClause    (const Lit* lits, int size, bool deleted);             // Writes a clause to the DRUP proof.
+    void     exportClause     (const vec<Lit>& c, unsigned int lbd);                 // Offers a learnt clause to the other workers.
+    bool     importClauses    ();                                                    // Adds the clauses of the other workers at level 0.
+    bool     sharedSeen       (uint64_t h);                                          // Was a clause with this hash shared lately? Records it.
+    bool     probeCube        ();                                                    // Failed and implied literals under the assumptions.
+    bool     probeRoot        ();                                                    // Assigns the assumptions, learning from conflicts.
+    bool     probeFailed      (Lit p);                                               // Propagates 'p' above the assumptions, learning if it fails.
+    void     selectProbes     (vec<Var>& out);                                       // The variables 'probeCube()' tries.
+    void     learnProbe       (vec<Lit>& c, bool asserting);                         // Adds a learnt clause found by probing.
+    lbool    walk             ();                                                    // Local search under the assumptions, which sets the phases.
+    void        writeWatches  (FILE* f, OccLists<Lit, vec<Watcher>, WatcherDeleted>& ws, int vars);
+    bool        readWatches   (FILE* f, OccLists<Lit, vec<Watcher>, WatcherDeleted>& ws, int vars);
 
     // Maintaining Variable/Clause activity:
     //
     void     varDecayActivity ();                      // Decay all variables with the specified factor. Implemented by increasing the 'bump' value instead.
     void     varBumpActivity  (Var v, double inc);     // Increase a variable with the current 'bump' value.
     void     varBumpActivity  (Var v);                 // Increase a variable with the current 'bump' value.
+    void     undoHints        ();                      // Take back the activity 'hintCube()' gave.
     void     claDecayActivity ();                      // Decay all clauses with the specified factor. Implemented by increasing the 'bump' value instead.
     void     claBumpActivity  (Clause& c);             // Increase a clause with the current 'bump' value.
 
     // Operations on clauses:
     //
     void     attachClause     (CRef cr);               // Attach a clause to watcher lists.
+    void     attachTernaries  ();                      // Move the ternary clauses to 'watchesTer' if there are enough of them.
     void     detachClause     (CRef cr, bool strict = false); // Detach a clause to watcher lists.
     void     removeClause     (CRef cr);               // Detach and free a clause.
     bool     locked           (const Clause& c) const; // Returns TRUE if a clause is a reason for some implication in the current state.
@@ -357,7 +448,8 @@ inline void Solver::varBumpActivity(Var v, double inc) {
         // Rescale:
         for (int i = 0; i < nVars(); i++)
             activity[i] *= 1e-100;
-        var_inc *= 1e-100; }
+        var_inc *= 1e-100;
+        hintScale *= 1e-100; }
 
     // Update order_heap with respect to new activity:
     if (order_heap.inHeap(v))
@@ -384,12 +476,12 @@ inline bool     Solver::addClause       (Lit p)                 { add_tmp.clear(
 inline bool     Solver::addClause       (Lit p, Lit q)          { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); return addClause_(add_tmp); }
 inline bool     Solver::addClause       (Lit p, Lit q, Lit r)   { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); return addClause_(add_tmp); }
  inline bool     Solver::locked          (const Clause& c) const {
-   if(c.size()>2)
+   if(c.size()>3 || (c.size()==3 && !ternaryWatches))
      return value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && ca.lea(reason(var(c[0]))) == &c;
-   return
-     (value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && ca.lea(reason(var(c[0]))) == &c)
-     ||
-     (value(c[1]) == l_True && reason(var(c[1])) != CRef_Undef && ca.lea(reason(var(c[1]))) == &c);
+   for (int i = 0; i < c.size(); i++)
+     if (value(c[i]) == l_True && reason(var(c[i])) != CRef_Undef && ca.lea(reason(var(c[i]))) == &c)
+       return true;
+   return false;
  }
 inline void     Solver::newDecisionLevel()                      { trail_lim.push(trail.size()); }
 
@@ -0,0 +1,60 @@
+/root/repo/iglucose/core/CubeServer.o /root/repo/iglucose/core/CubeServer.or /root/repo/iglucose/core/CubeServer.od /root/repo/iglucose/core/CubeServer.op: /root/repo/iglucose/core/CubeServer.cc \
+ /root/repo/iglucose/core/../utils/System.h \
+ /root/repo/iglucose/core/../mtl/IntTypes.h \
+ /root/repo/iglucose/core/../core/CubeServer.h \
+ /root/repo/iglucose/core/../mtl/Vec.h \
+ /root/repo/iglucose/core/../mtl/XAlloc.h \
+ /root/repo/iglucose/core/../core/SolverTypes.h \
+ /root/repo/iglucose/core/../mtl/Alg.h \
+ /root/repo/iglucose/core/../mtl/Map.h \
+ /root/repo/iglucose/core/../mtl/Alloc.h \
+ /root/repo/iglucose/core/../core/CubeTrie.h \
+ /root/repo/iglucose/core/../core/CubeJournal.h \
+ /root/repo/iglucose/core/../core/CubeMetrics.h
+/root/repo/iglucose/core/Main.o /root/repo/iglucose/core/Main.or /root/repo/iglucose/core/Main.od /root/repo/iglucose/core/Main.op: /root/repo/iglucose/core/Main.cc \
+ /root/repo/iglucose/core/../utils/System.h \
+ /root/repo/iglucose/core/../mtl/IntTypes.h \
+ /root/repo/iglucose/core/../utils/ParseUtils.h \
+ /root/repo/iglucose/core/../utils/Options.h \
+ /root/repo/iglucose/core/../mtl/Vec.h \
+ /root/repo/iglucose/core/../mtl/XAlloc.h \
+ /root/repo/iglucose/core/../core/Dimacs.h \
+ /root/repo/iglucose/core/../core/SolverTypes.h \
+ /root/repo/iglucose/core/../mtl/Alg.h \
+ /root/repo/iglucose/core/../mtl/Map.h \
+ /root/repo/iglucose/core/../mtl/Alloc.h \
+ /root/repo/iglucose/core/../core/Solver.h \
+ /root/repo/iglucose/core/../mtl/Heap.h \
+ /root/repo/iglucose/core/../core/BoundedQueue.h \
+ /root/repo/iglucose/core/../core/Constants.h \
+ /root/repo/iglucose/core/../core/ClauseExchange.h \
+ /root/repo/iglucose/core/../core/Profile.h \
+ /root/repo/iglucose/core/../core/CubeTrie.h \
+ /root/repo/iglucose/core/../core/CubeMetrics.h \
+ /root/repo/iglucose/core/../core/CubeJournal.h \
+ /root/repo/iglucose/core/../core/CubeServer.h \
+ /root/repo/iglucose/core/../core/CubeRouter.h \
+ /root/repo/iglucose/core/../mtl/Sort.h \
+ /root/repo/iglucose/core/../../march_cu/libmarch.h \
+ /root/repo/iglucose/core/../core/CubeSplitter.h \
+ /root/repo/iglucose/core/../core/CubeCounter.h \
+ /root/repo/iglucose/core/../core/CubeStats.h
+/root/repo/iglucose/core/Solver.o /root/repo/iglucose/core/Solver.or /root/repo/iglucose/core/Solver.od /root/repo/iglucose/core/Solver.op: /root/repo/iglucose/core/Solver.cc \
+ /root/repo/iglucose/core/../mtl/Sort.h \
+ /root/repo/iglucose/core/../mtl/Vec.h \
+ /root/repo/iglucose/core/../mtl/IntTypes.h \
+ /root/repo/iglucose/core/../mtl/XAlloc.h \
+ /root/repo/iglucose/core/../core/Solver.h \
+ /root/repo/iglucose/core/../mtl/Heap.h \
+ /root/repo/iglucose/core/../mtl/Alg.h \
+ /root/repo/iglucose/core/../utils/Options.h \
+ /root/repo/iglucose/core/../utils/ParseUtils.h \
+ /root/repo/iglucose/core/../core/SolverTypes.h \
+ /root/repo/iglucose/core/../mtl/Map.h \
+ /root/repo/iglucose/core/../mtl/Alloc.h \
+ /root/repo/iglucose/core/../core/BoundedQueue.h \
+ /root/repo/iglucose/core/../core/Constants.h \
+ /root/repo/iglucose/core/../core/ClauseExchange.h \
+ /root/repo/iglucose/core/../core/Profile.h \
+ /root/repo/iglucose/core/../core/LocalSearch.h \
+ /root/repo/iglucose/core/../utils/System.h
@@ -28,6 +28,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 **************************************************************************************************/
 
 #include <errno.h>
+#include <ctype.h>
 
 #include <signal.h>
 #include <zlib.h>
@@ -69,6 +70,99 @@ void printStats(Solver& solver)
 
 
 
+// Reads the literals of a file in DIMACS style, skipping comment lines, the header and the status
+// line of a solver output, and the 'v' that starts a value line. Every 0 ends a clause. Any other
+// word, or a literal of a variable above 'nvars', is an error.
+static void readLits(FILE* in, const char* name, int nvars, vec<vec<Lit> >& out)
+{
+    vec<Lit> lits;
+    char     tok[16];
+    bool     bol = true;
+    int      c   = getc(in);
+    while (c != EOF){
+        if (isspace(c)){
+            bol = c == '\n' || c == '\r';     // (progress bars start their lines with a '\r')
+            c   = getc(in);
+            continue; }
+        if (bol && (c == 'c' || c == 'p' || c == 's')){
+            while (c != '\n' && c != EOF) c = getc(in);
+            continue; }
+
+        int n = 0;
+        for (; c != EOF && !isspace(c); c = getc(in))
+            if (n < (int)sizeof(tok) - 1) tok[n++] = c;
+            else                          n = sizeof(tok);
+        if (n == sizeof(tok)){
+            tok[n - 1] = 0;
+            printf("ERROR! Not a literal of %d variables in %s: %s...\n", nvars, name, tok), exit(1); }
+        tok[n] = 0;
+        bool first = bol;
+        bol = false;
+        if (first && strcmp(tok, "v") == 0) continue;
+
+        char* end;
+        long  lit = strtol(tok, &end, 10);
+        if (end == tok || *end != 0 || lit < -nvars || lit > nvars)
+            printf("ERROR! Not a literal of %d variables in %s: %s\n", nvars, name, tok), exit(1);
+        if (lit == 0){
+            out.push();
+            lits.copyTo(out.last());
+            lits.clear(); }
+        else
+            lits.push(mkLit(abs(lit) - 1, lit < 0));
+    }
+    if (lits.size() > 0){
+        out.push();
+        lits.copyTo(out.last()); }
+}
+
+
+// Extends a model of the simplified formula to the original one with a reconstruction stack
+// written by 'SimpSolver::writeSimplified()', and prints it in the usual output format.
+static int extendModel(const char* model_file, const char* stack_file)
+{
+    FILE* st = fopen(stack_file, "r");
+    if (st == NULL)
+        printf("ERROR! Could not open file: %s\n", stack_file), exit(1);
+    int nvars;
+    if (fscanf(st, "c reconstruction stack of %d variables", &nvars) != 1 || nvars < 0)
+        printf("ERROR! Not a reconstruction stack: %s\n", stack_file), exit(1);
+    vec<vec<Lit> > stack;
+    readLits(st, stack_file, nvars, stack);
+    fclose(st);
+
+    FILE* in = model_file == NULL ? stdin : fopen(model_file, "r");
+    if (in == NULL)
+        printf("ERROR! Could not open file: %s\n", model_file), exit(1);
+    vec<vec<Lit> > model;
+    readLits(in, model_file == NULL ? "<stdin>" : model_file, nvars, model);
+    if (in != stdin) fclose(in);
+
+    vec<lbool> values(nvars, l_Undef);
+    for (int i = 0; i < model.size(); i++)
+        for (int j = 0; j < model[i].size(); j++){
+            Lit p = model[i][j];
+            values[var(p)] = lbool(!sign(p)); }
+
+    // Same rule as 'SimpSolver::extendModel()', the first literal is set if the rest is false:
+    for (int i = stack.size()-1; i >= 0; i--){
+        vec<Lit>& c = stack[i];
+        if (c.size() == 0) continue;
+        for (int j = 1; j < c.size(); j++)
+            if ((values[var(c[j])] ^ sign(c[j])) != l_False)
+                goto next;
+        values[var(c[0])] = lbool(!sign(c[0]));
+    next:;
+    }
+
+    printf("s SATISFIABLE\nv ");
+    for (int i = 0; i < values.size(); i++)
+        printf("%s%d ", values[i] == l_False ? "-" : "", i + 1);
+    printf("0\n");
+    return 10;
+}
+
+
 static Solver* solver;
 // Terminate by notifying the solver and back out gracefully. This is mainly to have a test-case
 // for this feature of the Solver as it may take longer than an immediate call to '_exit()'.
@@ -108,10 +202,16 @@ int main(int argc, char** argv)
         IntOption    vv  ("MAIN", "vv",   "Verbosity every vv conflicts", 10000, IntRange(1,INT32_MAX));
         BoolOption   pre    ("MAIN", "pre",    "Completely turn on/off any preprocessing.", true);
         StringOption dimacs ("MAIN", "dimacs", "If given, stop after preprocessing and write the result to this file.");
+        StringOption stack  ("MAIN", "stack",  "If given with -dimacs, keep the variable numbering and write the model reconstruction stack to this file.");
+        StringOption freeze ("MAIN", "freeze", "File with the variables that must not be eliminated, e.g. those cubes may branch on.");
+        StringOption extend ("MAIN", "extend", "Extend the model in the input file with this reconstruction stack and print it.");
         IntOption    cpu_lim("MAIN", "cpu-lim","Limit on CPU time allowed in seconds.\n", INT32_MAX, IntRange(0, INT32_MAX));
         IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", INT32_MAX, IntRange(0, INT32_MAX));
 
         parseOptions(argc, argv, true);
+
+        if (extend)
+            exit(extendModel(argc == 1 ? NULL : argv[1], (const char*)extend));
         
         SimpSolver  S;
         double      initial_time = cpuTime();
@@ -164,6 +264,18 @@ int main(int argc, char** argv)
         parse_DIMACS(in, S);
         gzclose(in);
 
+        if (freeze){
+            FILE* fr = fopen((const char*)freeze, "r");
+            if (fr == NULL)
+                printf("ERROR! Could not open file: %s\n", (const char*)freeze), exit(1);
+            vec<vec<Lit> > frozen;
+            readLits(fr, (const char*)freeze, S.nVars(), frozen);
+            fclose(fr);
+            for (int i = 0; i < frozen.size(); i++)
+                for (int j = 0; j < frozen[i].size(); j++)
+                    S.setFrozen(var(frozen[i][j]), true);
+        }
+
        if (S.verbosity > 0){
             printf("c |  Number of variables:  %12d                                                                   |\n", S.nVars());
             printf("c |  Number of clauses:    %12d                                                                   |\n", S.nClauses()); }
@@ -200,7 +312,16 @@ int main(int argc, char** argv)
         if (dimacs){
             if (S.verbosity > 0)
                 printf("c =======================================[ Writing DIMACS ]===============================================\n");
-            S.toDimacs((const char*)dimacs);
+            if (stack){
+                FILE* cnf = fopen((const char*)dimacs, "w");
+                FILE* st  = fopen((const char*)stack, "w");
+                if (cnf == NULL || st == NULL)
+                    fprintf(stderr, "could not open file %s\n", cnf == NULL ? (const char*)dimacs : (const char*)stack), exit(1);
+                S.writeSimplified(cnf, st);
+                fclose(cnf);
+                fclose(st);
+            }else
+                S.toDimacs((const char*)dimacs);
             if (S.verbosity > 0)
                 printStats(S);
             exit(0);
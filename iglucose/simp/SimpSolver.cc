@@ -18,6 +18,8 @@ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
 OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 **************************************************************************************************/
 
+#include <pthread.h>
+
 #include "mtl/Sort.h"
 #include "simp/SimpSolver.h"
 #include "utils/System.h"
@@ -36,6 +38,7 @@ static BoolOption   opt_use_elim         (_cat, "elim",         "Perform variabl
 static IntOption    opt_grow             (_cat, "grow",         "Allow a variable elimination step to grow by a number of clauses.", 0);
 static IntOption    opt_clause_lim       (_cat, "cl-lim",       "Variables are not eliminated if it produces a resolvent with a length above this limit. -1 means no limit", 20,   IntRange(-1, INT32_MAX));
 static IntOption    opt_subsumption_lim  (_cat, "sub-lim",      "Do not check if subsumption against a clause larger than this. -1 means no limit.", 1000, IntRange(-1, INT32_MAX));
+static IntOption    opt_elim_threads     (_cat, "elim-threads", "Threads that test variable eliminations ahead of the heap order (0 = none). The result is the same for any number.", 0, IntRange(0, 256));
 static DoubleOption opt_simp_garbage_frac(_cat, "simp-gc-frac", "The fraction of wasted memory allowed before a garbage collection is triggered during simplification.",  0.5, DoubleRange(0, false, HUGE_VAL, false));
 
 
@@ -51,6 +54,7 @@ SimpSolver::SimpSolver() :
   , use_asymm          (opt_use_asymm)
   , use_rcheck         (opt_use_rcheck)
   , use_elim           (opt_use_elim)
+  , elim_threads       (opt_elim_threads)
   , merges             (0)
   , asymm_lits         (0)
   , eliminated_vars    (0)
@@ -85,6 +89,10 @@ Var SimpSolver::newVar(bool sign, bool dvar) {
         occurs    .init(v);
         touched   .push(0);
         elim_heap .insert(v);
+        occ_stamp .push(1);
+        tried_stamp.push(0);
+        tried_elim.push(0);
+        tried_merges.push(0);
     }
     return v; }
 
@@ -163,6 +171,7 @@ bool SimpSolver::addClause_(vec<Lit>& ps)
         // consequence of how backward subsumption is used to mimic
         // forward subsumption.
         subsumption_queue.insert(cr);
+        touchOccurs(c);
         for (int i = 0; i < c.size(); i++){
             occurs[var(c[i])].push(cr);
             n_occ[toInt(c[i])]++;
@@ -181,12 +190,14 @@ void SimpSolver::removeClause(CRef cr)
 {
     const Clause& c = ca[cr];
 
-    if (use_simplification)
+    if (use_simplification){
+        touchOccurs(c);
         for (int i = 0; i < c.size(); i++){
             n_occ[toInt(c[i])]--;
             updateElimHeap(var(c[i]));
             occurs.smudge(var(c[i]));
         }
+    }
 
     Solver::removeClause(cr);
 }
@@ -201,6 +212,7 @@ bool SimpSolver::strengthenClause(CRef cr, Lit l)
     // FIX: this is too inefficient but would be nice to have (properly implemented)
     // if (!find(subsumption_queue, &c))
     subsumption_queue.insert(cr);
+    touchOccurs(c);
 
     if (certifiedUNSAT) {
       for (int i = 0; i < c.size(); i++)
@@ -262,11 +274,9 @@ bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& ou
 }
 
 
-// Returns FALSE if clause is always satisfied.
-bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, int& size)
+// Returns FALSE if clause is always satisfied. Does not count the merge, 'tryElim()' does.
+bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, int& size) const
 {
-    merges++;
-
     bool  ps_smallest = _ps.size() < _qs.size();
     const Clause& ps  =  ps_smallest ? _qs : _ps;
     const Clause& qs  =  ps_smallest ? _ps : _qs;
@@ -485,6 +495,74 @@ static void mkElimClause(vec<uint32_t>& elimclauses, Var v, Clause& c)
 
 
 
+// The test of 'eliminateVar()': TRUE if the resolvents on 'v' of its clauses stay within 'grow' and
+// 'clause_lim'. It only reads the clauses (skipping the deleted ones instead of cleaning the list), so
+// several threads can run it at a time while nothing else changes the clause database.
+bool SimpSolver::tryElim(Var v, int& nmerges)
+{
+    const vec<CRef>& cls = occurs[v];
+    vec<CRef>        pos, neg;
+    for (int i = 0; i < cls.size(); i++)
+        if (ca[cls[i]].mark() != 1)
+            (find(ca[cls[i]], mkLit(v)) ? pos : neg).push(cls[i]);
+
+    int cnt         = 0;
+    int clause_size = 0;
+    nmerges = 0;
+
+    for (int i = 0; i < pos.size(); i++)
+        for (int j = 0; j < neg.size(); j++){
+            nmerges++;
+            if (merge(ca[pos[i]], ca[neg[j]], v, clause_size) &&
+                (++cnt > pos.size() + neg.size() + grow || (clause_lim != -1 && clause_size > clause_lim)))
+                return false; }
+    return true;
+}
+
+
+struct TryJob {
+    SimpSolver* S;
+    int         first, step;
+};
+
+void* SimpSolver::tryWorker(void* arg)
+{
+    TryJob&     job = *(TryJob*)arg;
+    SimpSolver& S   = *job.S;
+    for (int i = job.first; i < S.ahead.size(); i += job.step){
+        Var v = S.ahead[i];
+        S.tried_elim [v] = S.tryElim(v, S.tried_merges[v]);
+        S.tried_stamp[v] = S.occ_stamp[v]; }
+    return NULL;
+}
+
+
+// Tests the elimination of 'first' and of the candidates at the top of the heap on 'elim_threads'
+// threads. Only the test is done ahead: 'eliminateVar()' takes its result as long as 'occ_stamp'
+// says the clauses of the variable are the same, and otherwise tests again. The variables are still
+// eliminated one by one in the order of the heap, so the formula is the same as without threads.
+void SimpSolver::tryAhead(Var first)
+{
+    ahead.clear();
+    ahead.push(first);
+    for (int i = 0; i < elim_heap.size() && ahead.size() < 64 * elim_threads; i++){
+        Var v = elim_heap[i];
+        if (tried_stamp[v] != occ_stamp[v] && !frozen[v] && !isEliminated(v) && value(v) == l_Undef)
+            ahead.push(v); }
+
+    vec<TryJob>    jobs(elim_threads);
+    vec<pthread_t> threads(elim_threads);
+    for (int t = 0; t < elim_threads; t++){
+        jobs[t].S     = this;
+        jobs[t].first = t;
+        jobs[t].step  = elim_threads;
+        if (t > 0) pthread_create(&threads[t], NULL, tryWorker, &jobs[t]); }
+    tryWorker(&jobs[0]);
+    for (int t = 1; t < elim_threads; t++)
+        pthread_join(threads[t], NULL);
+}
+
+
 bool SimpSolver::eliminateVar(Var v)
 {
     assert(!frozen[v]);
@@ -499,16 +577,15 @@ bool SimpSolver::eliminateVar(Var v)
         (find(ca[cls[i]], mkLit(v)) ? pos : neg).push(cls[i]);
 
     // Check wether the increase in number of clauses stays within the allowed ('grow'). Moreover, no
-    // clause must exceed the limit on the maximal clause size (if it is set):
+    // clause must exceed the limit on the maximal clause size (if it is set). The test may have been
+    // done ahead on the same clauses:
     //
-    int cnt         = 0;
-    int clause_size = 0;
-
-    for (int i = 0; i < pos.size(); i++)
-        for (int j = 0; j < neg.size(); j++)
-            if (merge(ca[pos[i]], ca[neg[j]], v, clause_size) && 
-                (++cnt > cls.size() + grow || (clause_lim != -1 && clause_size > clause_lim)))
-                return true;
+    if (tried_stamp[v] != occ_stamp[v]){
+        tried_elim [v] = tryElim(v, tried_merges[v]);
+        tried_stamp[v] = occ_stamp[v]; }
+    merges += tried_merges[v];
+    if (!tried_elim[v])
+        return true;
 
     // Delete and store old clauses:
     eliminated[v] = true;
@@ -598,6 +675,46 @@ void SimpSolver::extendModel()
 }
 
 
+void SimpSolver::writeSimplified(FILE* cnf, FILE* stack)
+{
+    assert(decisionLevel() == 0);
+
+    int cnt = 0;
+    for (int i = 0; i < clauses.size(); i++)
+        if (!satisfied(ca[clauses[i]]))
+            cnt++;
+
+    fprintf(cnf, "p cnf %d %d\n", nVars(), cnt);
+    for (int i = 0; i < clauses.size(); i++){
+        Clause& c = ca[clauses[i]];
+        if (satisfied(c)) continue;
+        for (int j = 0; j < c.size(); j++)
+            if (value(c[j]) != l_False)
+                fprintf(cnf, "%s%d ", sign(c[j]) ? "-" : "", var(c[j]) + 1);
+        fprintf(cnf, "0\n");
+    }
+
+    if (stack == NULL) return;
+
+    // Clauses of eliminated variables in elimination order, then the root-level units, which are
+    // thus reconstructed first:
+    fprintf(stack, "c reconstruction stack of %d variables\n", nVars());
+    // The layout of 'elimclauses' can only be parsed backwards, see 'extendModel()':
+    vec<int> ends;
+    for (int i = elimclauses.size()-1; i > 0; i -= elimclauses[i] + 1)
+        ends.push(i);
+    for (int k = ends.size()-1; k >= 0; k--){
+        int i = ends[k];
+        for (int j = i - elimclauses[i]; j < i; j++){
+            Lit x = toLit(elimclauses[j]);
+            fprintf(stack, "%s%d ", sign(x) ? "-" : "", var(x) + 1); }
+        fprintf(stack, "0\n");
+    }
+    for (int i = 0; i < trail.size(); i++)
+        fprintf(stack, "%s%d 0\n", sign(trail[i]) ? "-" : "", var(trail[i]) + 1);
+}
+
+
 bool SimpSolver::eliminate(bool turn_off_elim)
 {
     if (!simplify())
@@ -651,8 +768,11 @@ bool SimpSolver::eliminate(bool turn_off_elim)
 
             // At this point, the variable may have been set by assymetric branching, so check it
             // again. Also, don't eliminate frozen variables:
-            if (use_elim && value(elim) == l_Undef && !frozen[elim] && !eliminateVar(elim)){
-                ok = false; goto cleanup; }
+            if (use_elim && value(elim) == l_Undef && !frozen[elim]){
+                if (elim_threads > 0 && tried_stamp[elim] != occ_stamp[elim])
+                    tryAhead(elim);
+                if (!eliminateVar(elim)){
+                    ok = false; goto cleanup; } }
 
             checkGarbage(simp_garbage_frac);
         }
@@ -668,6 +788,10 @@ bool SimpSolver::eliminate(bool turn_off_elim)
         n_occ    .clear(true);
         elim_heap.clear(true);
         subsumption_queue.clear(true);
+        occ_stamp   .clear(true);
+        tried_stamp .clear(true);
+        tried_elim  .clear(true);
+        tried_merges.clear(true);
 
         use_simplification    = false;
         remove_satisfied      = true;
@@ -730,6 +854,7 @@ void SimpSolver::relocAll(ClauseAllocator& to)
 
 void SimpSolver::garbageCollect()
 {
+    PROFILE_PHASE(phGarbage);
     // Initialize the next region to a size corresponding to the estimated utilization degree. This
     // is not precise but should avoid some unnecessary reallocations for the new region:
     ClauseAllocator to(ca.size() - ca.wasted()); 
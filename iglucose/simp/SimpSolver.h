@@ -68,6 +68,13 @@ class SimpSolver : public Solver {
     virtual void garbageCollect();
 
 
+    // Preprocessing for cube-and-conquer. The formula keeps the original variable numbering, so
+    // cubes generated on it need no remapping. Each line of the stack is a clause with the
+    // reconstructed literal first; see 'extendModel()':
+    //
+    void    writeSimplified (FILE* cnf, FILE* stack);
+
+
     // Generate a (possibly simplified) DIMACS file:
     //
 #if 0
@@ -90,6 +97,7 @@ class SimpSolver : public Solver {
     bool    use_asymm;         // Shrink clauses by asymmetric branching.
     bool    use_rcheck;        // Check if a clause is already implied. Prett costly, and subsumes subsumptions :)
     bool    use_elim;          // Perform variable elimination.
+    int     elim_threads;      // Threads that test eliminations ahead of the heap order (see 'tryAhead()').
 
     // Statistics:
     //
@@ -137,6 +145,11 @@ class SimpSolver : public Solver {
     vec<char>           eliminated;
     int                 bwdsub_assigns;
     int                 n_touched;
+    vec<uint32_t>       occ_stamp;         // Changes whenever a clause of the variable is added, removed or strengthened.
+    vec<uint32_t>       tried_stamp;       // 'occ_stamp' when the elimination of the variable was tested ahead,
+    vec<char>           tried_elim;        // whether it passed,
+    vec<int>            tried_merges;      // and the merges it took.
+    vec<Var>            ahead;             // Variables of the current 'tryAhead()'.
 
     // Temporaries:
     //
@@ -150,7 +163,11 @@ class SimpSolver : public Solver {
     void          updateElimHeap           (Var v);
     void          gatherTouchedClauses     ();
     bool          merge                    (const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& out_clause);
-    bool          merge                    (const Clause& _ps, const Clause& _qs, Var v, int& size);
+    bool          merge                    (const Clause& _ps, const Clause& _qs, Var v, int& size) const;
+    void          touchOccurs              (const Clause& c);
+    bool          tryElim                  (Var v, int& nmerges);
+    void          tryAhead                 (Var first);
+    static void*  tryWorker                (void* job);
     bool          backwardSubsumptionCheck (bool verbose = false);
     bool          eliminateVar             (Var v);
     void          extendModel              ();
@@ -168,6 +185,7 @@ class SimpSolver : public Solver {
 
 
 inline bool SimpSolver::isEliminated (Var v) const { return eliminated[v]; }
+inline void SimpSolver::touchOccurs  (const Clause& c) { for (int i = 0; i < c.size(); i++) occ_stamp[var(c[i])]++; }
 inline void SimpSolver::updateElimHeap(Var v) {
     assert(use_simplification);
     // if (!frozen[v] && !isEliminated(v) && value(v) == l_Undef)
@@ -32,6 +32,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 namespace Glucose {
 
 static inline double cpuTime(void); // CPU-time in seconds.
+static inline double realTime(void); // Wall-clock time in seconds.
 extern double memUsed();            // Memory in mega bytes (returns 0 for unsupported architectures).
 extern double memUsedPeak();        // Peak-memory in mega bytes (returns 0 for unsupported architectures).
 
@@ -44,6 +45,7 @@ extern double memUsedPeak();        // Peak-memory in mega bytes (returns 0 for
 #include <time.h>
 
 static inline double Glucose::cpuTime(void) { return (double)clock() / CLOCKS_PER_SEC; }
+static inline double Glucose::realTime(void) { return (double)time(NULL); }
 
 #else
 #include <sys/time.h>
@@ -55,6 +57,11 @@ static inline double Glucose::cpuTime(void) {
     getrusage(RUSAGE_SELF, &ru);
     return (double)ru.ru_utime.tv_sec + (double)ru.ru_utime.tv_usec / 1000000; }
 
+static inline double Glucose::realTime(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec + (double)tv.tv_usec / 1000000; }
+
 #endif
 
 #endif
@@ -15,6 +15,7 @@ static=no
 classify=no
 aiger=undefined
 yalsat=undefined
+march=undefined
 files=no
 
 ##########################################################################
@@ -54,6 +55,8 @@ do
        echo "--no-aiger      no targets requiring AIGER library"
        echo "--yalsat=<dir>  specify YalSAT directory (default '../yalsat')"
        echo "--no-yalsat     do not include YalSAT code"
+       echo "--march=<dir>   specify libmarch directory (default '../march_cu')"
+       echo "--no-march      no march look-ahead in 'treengeling'"
        echo "--druplig       specify Druplig directory (default '../druplig')"
        echo "--no-druplig    do not include Druplig code"
        echo "--files         generate statistics files"
@@ -80,6 +83,8 @@ do
     --no-aiger) aiger=no;;
     --yalsat=*) yalsat=`echo "$1"|sed -e 's,^--yalsat=,,'`;;
     --no-yalsat) yalsat=no;;
+    --march=*) march=`echo "$1"|sed -e 's,^--march=,,'`;;
+    --no-march) march=no;;
     --druplig) druplig=`echo "$1"|sed -e 's,^--druplig=,,'`;;
     --no-druplig) druplig=no;;
     --files) files=yes;;
@@ -148,6 +153,34 @@ fi
 
 ##########################################################################
 
+if [ x"$march" = xundefined ]
+then
+  if [ -f ../march_cu/libmarch.a ]
+  then
+    march="../march_cu"
+    echo "found and using $march"
+  fi
+fi
+
+if [ x"$march" = xundefined ]
+then
+  march=no
+elif [ ! x"$march" = xno ]
+then
+  if [ ! -d "$march" ]
+  then
+    die "'$march' not a directory (use '--march' or '--no-march')"
+  elif [ ! -f "$march/libmarch.h" ]
+  then
+    die "can not find '$march/libmarch.h'"
+  elif [ ! -f "$march/libmarch.a" ]
+  then
+    die "can not find '$march/libmarch.a'"
+  fi
+fi
+
+##########################################################################
+
 if [ x"$druplig" = xundefined ]
 then
   if [ -d ../druplig ]
@@ -231,6 +264,18 @@ then
   CFLAGS="${CFLAGS}-I$druplig"
 fi
 
+if [ ! "$march" = no ]
+then
+  [ x"$HDEPS" = x ] || HDEPS="${HDEPS} "
+  HDEPS="${HDEPS}$march/libmarch.h"
+  [ x"$LDEPS" = x ] || LDEPS="${LDEPS} "
+  LDEPS="${LDEPS}$march/libmarch.a"
+  [ x"$LIBS" = x ] || LIBS="${LIBS} "
+  LIBS="${LIBS}-L$march -lmarch -lpthread -lm"
+  [ x"$CFLAGS" = x ] || CFLAGS="${CFLAGS} "
+  CFLAGS="${CFLAGS}-I$march"
+fi
+
 [ $chksol = undefined ] && chksol=$check
 [ $static = yes ] && CFLAGS="$CFLAGS -static"
 [ $profile = yes ] && CFLAGS="$CFLAGS -pg"
@@ -241,6 +286,7 @@ fi
 [ $chksol = no ] && CFLAGS="$CFLAGS -DNCHKSOL"
 [ $druplig = no ] && CFLAGS="$CFLAGS -DNLGLDRUPLIG"
 [ $yalsat = no ] && CFLAGS="$CFLAGS -DNLGLYALSAT"
+[ $march = no ] && CFLAGS="$CFLAGS -DNLGLMARCH"
 [ $files = no ] && CFLAGS="$CFLAGS -DNLGLFILES"
 [ $dema = no ] && CFLAGS="$CFLAGS -DNLGLDEMA"
 
@@ -15,8 +15,33 @@
 #include <math.h>
 #include <limits.h>
 #include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 
 #define CLONELIMIT		20000
+#define JOURNALBATCH		64
+#define REMOTEBUF		(1<<16)
+
+/* The shared cube index, the cube states, the trie counters and the 'done'
+ * flag are accessed without locks through the GCC/Clang atomic builtins.
+ */
+#define ATOMIC_GET(PTR) __atomic_load_n ((PTR), __ATOMIC_ACQUIRE)
+#define ATOMIC_SET(PTR,VAL) __atomic_store_n ((PTR), (VAL), __ATOMIC_RELEASE)
+#define ATOMIC_ADD(PTR,VAL) __atomic_fetch_add ((PTR), (VAL), __ATOMIC_ACQ_REL)
+#define ATOMIC_CAS(PTR,OLD,NEW) \
+  __atomic_compare_exchange_n ((PTR), &(OLD), (NEW), 0, \
+                               __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+/* States of a cube in the trie.
+ */
+#define PENDING			0
+#define TAKEN			1
+#define PRUNED			2
 
 #define INC(BYTES) \
 do { \
@@ -86,20 +111,34 @@ typedef struct Worker {
     int64_t decs, confs, props;
     pthread_mutex_t lock;
   } cloned;
-  int last, res;
+  int last, next, res;
   pthread_t thread;
   FILE * proof, * post;
-  int * failed, nfailed;
+  int * failed, nfailed, szfailed;
+  int * cube, szcube, melted;
+  struct {
+    int fd, result, cancelled, solved;
+    int * ids, nids, next;
+    char * buf, * line;
+    int head, tail, szline;
+    double checked;
+    FILE * out;
+  } remote;
 } Worker;
 
 static double startime;
 static size_t allocated, maxallocated;
 static FILE * statsfile, * histfile;
 
+typedef struct Node {
+  int lit, parent, child, sibling, ends, live;
+  unsigned abst;
+} Node;
+
 static Worker * workers;
 static int nworkers;
 
-static int nassumptions, queue, szassumptions;
+static int nassumptions, queue, scheduled, szassumptions;
 static int maxassumptionsize, sumassumptions, redassumptions;
 static double * times, sumtimes;
 static int ** assumptions;
@@ -109,11 +148,37 @@ static signed char * vals;
 static int nlits, szlits;
 static int * lits;
 
+static Node * nodes;
+static int nnodes, sznodes, * leaf, * nextend, npruned;
+static signed char * states, * marks;
+static const int * core;
+static int ncore;
+
 static int verbose, bar, nowitness, plain, clone, deterministic;
-static int noreverse, addassumptions = 1, noflush, reduce, nomelt;
+static int noreverse, addassumptions = 1, noflush, reduce, nomelt, noprune;
 
 static const char * druptraceprefix;
 
+typedef struct Slot {
+  int id, * lits, szlits;
+} Slot;
+
+static int stream, nslots = 1024, streameof, * lastuse;
+static int ntaken, wakereader = -1;
+static Slot * slots;
+static pthread_mutex_t streammutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t streamfilled = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t streamfreed = PTHREAD_COND_INITIALIZER;
+
+static const char * servername;
+static int remotebatch = 16;
+
+static const char * journalname;
+static FILE * journal;
+static int journalpending, nresumed;
+static double journalsynced;
+static signed char * resumed;
+
 static int lineno = 1;
 static char * inputname;
 static FILE * inputfile;
@@ -121,9 +186,9 @@ static FILE * inputfile;
 static int done;
 
 static pthread_mutex_t msgmutex = PTHREAD_MUTEX_INITIALIZER;
-static pthread_mutex_t donemutex = PTHREAD_MUTEX_INITIALIZER;
-static pthread_mutex_t queuemutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t prunemutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t finishedmutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t journalmutex = PTHREAD_MUTEX_INITIALIZER;
 
 static int finished;
 
@@ -187,15 +252,154 @@ static int isnum (const char * str) {
   return !*p;
 }
 
+/*------------------------------------------------------------------------*/
+/* With '-c <server>' every worker opens its own connection to a cube
+ * server ('iglucose -serve=...') and solves the batches of cubes it hands
+ * out instead of taking them from the local queue.  The protocol is
+ * described in 'iglucose/core/CubeServer.h'.  The server only sends in
+ * reply to a request for cubes or to end the run, so any input while a
+ * cube is solved makes 'term' stop the solver.
+ */
+
+static int opensocket (const char * addr) {
+  struct addrinfo hints, * res, * a;
+  struct sockaddr_un sa;
+  char host[256], * port;
+  int fd = -1, one = 1;
+  if (!strncmp (addr, "unix:", 5)) {
+    memset (&sa, 0, sizeof sa);
+    sa.sun_family = AF_UNIX;
+    if (strlen (addr + 5) >= sizeof sa.sun_path) return -1;
+    strcpy (sa.sun_path, addr + 5);
+    if ((fd = socket (AF_UNIX, SOCK_STREAM, 0)) < 0) return -1;
+    if (connect (fd, (struct sockaddr *) &sa, sizeof sa)) close (fd), fd = -1;
+    return fd;
+  }
+  if (strlen (addr) >= sizeof host) return -1;
+  strcpy (host, addr);
+  if ((port = strrchr (host, ':'))) *port++ = 0;
+  else port = host;
+  memset (&hints, 0, sizeof hints);
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo (port == host || !*host ? 0 : host, port, &hints, &res))
+    return -1;
+  for (a = res; a && fd < 0; a = a->ai_next) {
+    if ((fd = socket (a->ai_family, a->ai_socktype, a->ai_protocol)) < 0)
+      continue;
+    setsockopt (fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+    if (connect (fd, a->ai_addr, a->ai_addrlen)) close (fd), fd = -1;
+  }
+  freeaddrinfo (res);
+  return fd;
+}
+
+static void connectremote (Worker * w) {
+  double start = getime ();
+  while ((w->remote.fd = opensocket (servername)) < 0) {
+    if (getime () - start > 30)
+      die ("worker %d can not connect to cube server '%s'",
+           WID (w), servername);
+    usleep (100000);
+  }
+  if (!(w->remote.out = fdopen (dup (w->remote.fd), "w")))
+    die ("worker %d can not write to cube server", WID (w));
+  NEW (w->remote.ids, remotebatch);
+  NEW (w->remote.buf, REMOTEBUF);
+  w->remote.result = -1;
+  msg (w, 1, "connected to cube server '%s'", servername);
+}
+
+static int remotefill (Worker * w) {
+  ssize_t n;
+  do n = read (w->remote.fd, w->remote.buf, REMOTEBUF);
+  while (n < 0 && errno == EINTR);
+  if (n <= 0) return 0;
+  w->remote.head = 0, w->remote.tail = n;
+  return 1;
+}
+
+static char * remoteline (Worker * w) {
+  int n = 0, ch;
+  for (;;) {
+    if (w->remote.head == w->remote.tail && !remotefill (w)) return 0;
+    ch = w->remote.buf[w->remote.head++];
+    if (n == w->remote.szline) {
+      int oldszline = w->remote.szline;
+      w->remote.szline = oldszline ? 2*oldszline : 128;
+      RSZ (w->remote.line, oldszline, w->remote.szline);
+    }
+    if (ch == '\n') break;
+    w->remote.line[n++] = ch;
+  }
+  w->remote.line[n] = 0;
+  return w->remote.line;
+}
+
+/* Returns the next cube or -1 after the end of the run.
+ */
+static int remotejob (Worker * w) {
+  char * line, * end;
+  long id;
+  if (w->remote.next == w->remote.nids) {
+    w->remote.next = w->remote.nids = 0;
+    fprintf (w->remote.out, "g %d\n", remotebatch);
+    fflush (w->remote.out);
+    for (;;) {
+      if (!(line = remoteline (w))) { w->remote.result = 0; return -1; }
+      if (line[0] == 'c') {
+	id = strtol (line + 1, &end, 10);
+	if (end == line + 1 || id < 0 || id >= nassumptions)
+	  die ("invalid cube from server: '%s'", line);
+	if (w->remote.nids == remotebatch)
+	  die ("cube server sent more than %d cubes", remotebatch);
+	w->remote.ids[w->remote.nids++] = id;
+      } else if (line[0] == 'e') break;
+      else if (line[0] == 'q') {
+	w->remote.result = atoi (line + 1);
+	return -1;
+      } else die ("unexpected message from cube server: '%s'", line);
+    }
+  }
+  return w->remote.ids[w->remote.next++];
+}
+
+static int remotecancelled (Worker * w) {
+  struct pollfd p;
+  double now = getime ();
+  if (w->remote.cancelled || now - w->remote.checked < 0.01)
+    return w->remote.cancelled;
+  w->remote.checked = now;
+  p.fd = w->remote.fd, p.events = POLLIN;
+  if (w->remote.head < w->remote.tail || poll (&p, 1, 0) > 0)
+    w->remote.cancelled = 1;
+  return w->remote.cancelled;
+}
+
+static void remoteresult (Worker * w, int id) {
+  int i;
+  FILE * out = w->remote.out;
+  w->remote.solved++;
+  if (w->res == 10) {
+    fprintf (out, "s %d %lld", id, (long long) lglgetconfs (w->lgl));
+    for (i = 1; i < nvars; i++)
+      fprintf (out, " %d", lglderef (w->lgl, i) < 0 ? -i : i);
+    fputs (" 0\n", out);
+  } else if (w->res == 20) {
+    fprintf (out, "u %d %lld", id, (long long) lglgetconfs (w->lgl));
+    for (i = 0; i < w->nfailed; i++)
+      fprintf (out, " %d", w->failed[i]);
+    fputs (" 0\n", out);
+  } else fprintf (out, "x %d\n", id);
+  fflush (out);
+}
+
 static int term (void * voidptr) {
   Worker * w = voidptr;
   int res;
   msg (w, 3, "checking early termination");
-  if (pthread_mutex_lock (&donemutex))
-    warn ("failed to lock 'done' mutex in termination check");
-  res = done;
-  if (pthread_mutex_unlock (&donemutex)) 
-    warn ("failed to unlock 'done' mutex in termination check");
+  res = ATOMIC_GET (&done);
+  if (!res && servername) res = remotecancelled (w);
   msg (w, 3, "early termination check %s", res ? "succeeded" : "failed");
   return res;
 }
@@ -274,13 +478,8 @@ static void initlgl (LGL * lgl, Worker * w, int opts) {
 }
 
 static int justreturn (Worker * w) {
-  int res;
-  if (pthread_mutex_lock (&donemutex))
-    warn ("worker %d failed to lock 'done' mutex", WID (w));
-  res = done;
-  if (pthread_mutex_unlock (&donemutex))
-    warn ("worker %d failed to unlock 'done' mutex", WID (w));
-  return res;
+  (void) w;
+  return ATOMIC_GET (&done);
 }
 
 static int sat (Worker * w) {
@@ -343,32 +542,318 @@ static int sat (Worker * w) {
   return res;
 }
 
+/*------------------------------------------------------------------------*/
+/* Pending cubes are indexed in a trie over their literals in file order.
+ * Cubes leave the trie when they are scheduled.  After a cube is refuted
+ * every pending cube containing all its failed assumptions is pruned
+ * without calling a solver.  Workers take cubes without locking: the
+ * state of a cube moves from 'PENDING' to either 'TAKEN' or 'PRUNED' by
+ * compare-and-swap and the live counters are updated atomically.  Only
+ * pruning itself, which uses 'marks', is serialized by 'prunemutex'.
+ */
+
+static unsigned abstlit (int lit) { return 1u << (abs (lit) & 31); }
+
+static int marklit (int lit) { return 2*abs (lit) + (lit < 0); }
+
+static int newnode (int lit, int parent) {
+  Node * n;
+  if (nnodes == sznodes) {
+    int oldsznodes = sznodes;
+    sznodes = sznodes ? 2*sznodes : 1;
+    RSZ (nodes, oldsznodes, sznodes);
+  }
+  n = nodes + nnodes;
+  n->lit = lit;
+  n->parent = parent;
+  n->child = n->sibling = n->ends = -1;
+  n->live = 0;
+  n->abst = 0;
+  return nnodes++;
+}
+
+static void insertcube (const int * a, int id) {
+  int n = 0, c, m;
+  unsigned abst;
+  const int * p;
+  if (!nnodes) newnode (0, -1);
+  nodes[0].live++;
+  for (p = a; *p; p++) {
+    for (c = nodes[n].child; c >= 0 && nodes[c].lit != *p; c = nodes[c].sibling)
+      ;
+    if (c < 0) {
+      c = newnode (*p, n);
+      nodes[c].sibling = nodes[n].child;
+      nodes[n].child = c;
+    }
+    nodes[n = c].live++;
+  }
+  abst = 0;
+  for (m = n; m >= 0; m = nodes[m].parent) {
+    nodes[m].abst |= abst;
+    if (nodes[m].lit) abst |= abstlit (nodes[m].lit);
+  }
+  leaf[id] = n;
+  nextend[id] = nodes[n].ends;
+  nodes[n].ends = id;
+}
+
+/* Returns zero if the cube was already taken or pruned.
+ */
+static int schedulecube (int id) {
+  signed char pending = PENDING;
+  int n;
+  if (!ATOMIC_CAS (states + id, pending, TAKEN)) return 0;
+  for (n = leaf[id]; n >= 0; n = nodes[n].parent)
+    ATOMIC_ADD (&nodes[n].live, -1);
+  return 1;
+}
+
+static int killall (int n) {
+  signed char pending;
+  int id, c, res = 0;
+  for (id = nodes[n].ends; id >= 0; id = nextend[id])
+    if (pending = PENDING, ATOMIC_CAS (states + id, pending, PRUNED)) res++;
+  for (c = nodes[n].child; c >= 0; c = nodes[c].sibling)
+    if (ATOMIC_GET (&nodes[c].live) > 0) res += killall (c);
+  ATOMIC_ADD (&nodes[n].live, -res);
+  return res;
+}
+
+static int prunerec (int n, int open) {
+  unsigned need = 0;
+  int i, c, lit, res = 0;
+  for (i = 0; i < ncore; i++)
+    if (marks[marklit (core[i])] == 1) need |= abstlit (core[i]);
+  for (c = nodes[n].child; c >= 0; c = nodes[c].sibling) {
+    lit = nodes[c].lit;
+    if (!ATOMIC_GET (&nodes[c].live) || marks[marklit (-lit)]) continue;
+    if (marks[marklit (lit)] == 1) {
+      if (open == 1) res += killall (c);
+      else {
+	marks[marklit (lit)] = 2;
+	res += prunerec (c, open - 1);
+	marks[marklit (lit)] = 1;
+      }
+    } else if (!(need & ~(nodes[c].abst | abstlit (lit))))
+      res += prunerec (c, open);
+  }
+  ATOMIC_ADD (&nodes[n].live, -res);
+  return res;
+}
+
+static int prune (const int * failed, int nfailed) {
+  int i, res;
+  if (!nodes || !ATOMIC_GET (&nodes[0].live)) return 0;
+  if (!nfailed) res = killall (0);
+  else {
+    core = failed, ncore = nfailed;
+    for (i = 0; i < nfailed; i++) marks[marklit (failed[i])] = 1;
+    res = prunerec (0, nfailed);
+    for (i = 0; i < nfailed; i++) marks[marklit (failed[i])] = 0;
+    core = 0, ncore = 0;
+  }
+  npruned += res;
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+/* The journal is an append-only file with header 'p journal <cubes>' and
+ * one 'u <id> <failed> 0' line per refuted cube (the same format as the
+ * '-journal' option of iGlucose).  Records are flushed and synced to disk
+ * in groups of 'JOURNALBATCH' or at least once a second, so a crash loses
+ * at most the last group.  On restart a torn last line is cut off, the
+ * cubes already refuted are skipped and their negated failed assumptions
+ * are added to all workers.  Writing is protected by 'journalmutex'.
+ */
+
+/* The records of a group are flushed into the page cache while the
+ * 'journal' mutex is held, which keeps them in order.  The 'fsync' is done
+ * after releasing it, so other workers are not stalled by the disk.
+ */
+static int flushjournal (void) {
+  journalsynced = getime ();
+  if (!journalpending) return 0;
+  journalpending = 0;
+  if (!fflush (journal)) return 1;
+  warn ("failed to write journal '%s'", journalname);
+  return 0;
+}
+
+static void fsyncjournal (void) {
+  if (fsync (fileno (journal)))
+    warn ("failed to sync journal '%s'", journalname);
+}
+
+static void syncjournal (void) {
+  if (flushjournal ()) fsyncjournal ();
+}
+
+static void record (Worker * w, int id) {
+  int i, sync = 0;
+  if (!journal) return;
+  if (pthread_mutex_lock (&journalmutex))
+    die ("worker %d failed to lock 'journal' mutex", WID (w));
+  fprintf (journal, "u %d", id);
+  for (i = 0; i < w->nfailed; i++)
+    fprintf (journal, " %d", w->failed[i]);
+  fputs (" 0\n", journal);
+  if (++journalpending >= JOURNALBATCH || getime () - journalsynced >= 1.0)
+    sync = flushjournal ();
+  if (pthread_mutex_unlock (&journalmutex))
+    die ("worker %d failed to unlock 'journal' mutex", WID (w));
+  if (sync) fsyncjournal ();
+}
+
+static void resume (void) {
+  int id, lit, n, nlits, szlits, * clause, i, fits, skipped = 0;
+  long good = 0;
+  FILE * file;
+  if (!journalname) return;
+  NEW (resumed, nassumptions);
+  if ((file = fopen (journalname, "r"))) {
+    if (fscanf (file, "p journal %d", &n) != 1 || getc (file) != '\n')
+      die ("invalid journal header in '%s'", journalname);
+    if (n != nassumptions)
+      die ("journal '%s' is for %d cubes but found %d", 
+           journalname, n, nassumptions);
+    good = ftell (file);
+    szlits = 0, nlits = 0, clause = 0;
+    while (fscanf (file, " u %d", &id) == 1) {
+      nlits = 0, lit = 1, fits = (0 <= id && id < nassumptions);
+      while (fscanf (file, "%d", &lit) == 1 && lit) {
+	if (lit <= -nvars || lit >= nvars) { fits = 0; continue; }
+	if (nlits == szlits) {
+	  int oldszlits = szlits;
+	  szlits = szlits ? 2*szlits : 1;
+	  RSZ (clause, oldszlits, szlits);
+	}
+	clause[nlits++] = lit;
+      }
+      if (lit || getc (file) != '\n') break;
+      good = ftell (file);
+      if (!fits) { skipped++; continue; }
+      if (resumed[id]) continue;
+      resumed[id] = 1, nresumed++;
+      if (nodes) schedulecube (id);
+      for (n = 0; n < nworkers; n++) {
+	for (i = 0; i < nlits; i++)
+	  lgladd (workers[n].lgl, -clause[i]);
+	lgladd (workers[n].lgl, 0);
+      }
+    }
+    if (clause) DEL (clause, szlits);
+    fclose (file);
+    if (skipped)
+      warn ("skipped %d records of journal '%s' not fitting the formula",
+            skipped, journalname);
+    if (truncate (journalname, good))
+      die ("can not truncate journal '%s'", journalname);
+  }
+  if (!(journal = fopen (journalname, "a")))
+    die ("can not append to journal '%s'", journalname);
+  if (!good) {
+    fprintf (journal, "p journal %d\n", nassumptions);
+    journalpending = 1;
+    syncjournal ();
+  }
+  finished = nresumed;
+  msg (0, 1, "resumed %d refuted cubes from '%s'", nresumed, journalname);
+}
+
+/*------------------------------------------------------------------------*/
+/* With '--stream' only the formula is parsed before the workers start.
+ * The main thread then reads the cubes one by one into a ring of 'nslots'
+ * slots, cube 'i' goes to slot 'i % nslots' as soon as cube 'i - nslots'
+ * was taken, and workers wait for the cube they claimed.  Memory does not
+ * depend on the number of cubes.  Since the last use of a variable is
+ * only known at the end of the input, all variables stay frozen until
+ * then.  Afterwards 'lastuse' lists the variables by their last cube and
+ * every worker melts the prefix of variables not needed anymore.
+ */
+
+static void wakestream (void) {
+  if (!stream) return;
+  (void) pthread_mutex_lock (&streammutex);
+  (void) pthread_cond_broadcast (&streamfilled);
+  (void) pthread_cond_broadcast (&streamfreed);
+  (void) pthread_mutex_unlock (&streammutex);
+}
+
+static int streamjob (Worker * w) {
+  int res, n;
+  Slot * s;
+  if (deterministic) res = w->next, w->next += nworkers;
+  else res = ATOMIC_ADD (&queue, 1);
+  (void) pthread_mutex_lock (&streammutex);
+  s = slots + res % nslots;
+  while (s->id != res && !ATOMIC_GET (&done) &&
+         !(streameof && res >= nassumptions))
+    (void) pthread_cond_wait (&streamfilled, &streammutex);
+  if (s->id != res) {
+    (void) pthread_mutex_unlock (&streammutex);
+    return -1;
+  }
+  for (n = 0; s->lits[n]; n++)
+    ;
+  if (n >= w->szcube) {
+    RSZ (w->cube, w->szcube, n + 1);
+    w->szcube = n + 1;
+  }
+  memcpy (w->cube, s->lits, (n + 1) * sizeof *w->cube);
+  s->id = -1;
+  if (++ntaken >= wakereader && wakereader >= 0)
+    (void) pthread_cond_signal (&streamfreed);
+  (void) pthread_mutex_unlock (&streammutex);
+  ATOMIC_ADD (&scheduled, 1);
+  return res;
+}
+
+static int streammelt (Worker * w, int last) {
+  int res = 0;
+  if (!ATOMIC_GET (&streameof)) return 0;
+  while (w->melted < nvars - 1 && used[lastuse[w->melted]] <= last)
+    lglmelt (w->lgl, lastuse[w->melted++]), res++;
+  return res;
+}
+
+/* In deterministic mode worker 'i' solves exactly the cubes 'j' with
+ * 'j % nworkers == i' in file order, which needs no coordination at all.
+ * Otherwise the next cube is claimed by an atomic increment of 'queue'.
+ * Returns -1 if no cube is left.
+ */
+static int nextjob (Worker * w) {
+  int res;
+  for (;;) {
+    if (deterministic) res = w->next, w->next += nworkers;
+    else res = ATOMIC_ADD (&queue, 1);
+    if (res >= nassumptions) return -1;
+    if (resumed && resumed[res]) continue;
+    if (nodes && !schedulecube (res)) continue;
+    ATOMIC_ADD (&scheduled, 1);
+    return res;
+  }
+}
+
 static void * work (void * voidptr) {
   int i, last, pm, lm, count, lit, idx, *a, * p, size, red, fin;
   double start, end, delta, avg;
   Worker * w = voidptr;
   msg (w, 1, "running");
   for (;;) {
-    if (pthread_mutex_lock (&queuemutex))
-      die ("worker %d failed to lock 'queue' mutex", WID (w));
-    assert (queue <= nassumptions);
-    if (deterministic && (queue % nworkers) != WID (w)) {
-      if (pthread_mutex_unlock (&queuemutex))
-	die ("worker %d failed to unlock 'queue' mutex", WID (w));
-      usleep (1000);
-      continue;
-    }
-    if ((last = queue) < nassumptions) queue++;
-    if (pthread_mutex_unlock (&queuemutex))
-      die ("worker %d failed to unlock 'queue' mutex", WID (w));
-    if (last == nassumptions) {
+    if (servername) last = remotejob (w);
+    else if (stream) last = streamjob (w);
+    else last = nextjob (w);
+    if (last < 0) {
 DONE:
       if (!bar) msg (w, 1, "done");
       return 0;
     }
     msg (w, 2, "got job %d", last);
     count = 0;
-    for(i = w->last + 1; i <= last; i++) {
+    if (stream) {
+      if (!nomelt) count = streammelt (w, last);
+    } else for(i = w->last + 1; i <= last; i++) {
       a = assumptions[i];
       if (addassumptions > 1 && i < last) {
 	for (p = a; (lit = *p); p++) lgladd (w->lgl, -lit);
@@ -380,7 +865,8 @@ DONE:
 	  lglmelt (w->lgl, idx), count++;
     }
     msg (w, 2, "melted %d variables", count);
-    a = assumptions[w->last = last];
+    a = stream ? w->cube : assumptions[last];
+    w->last = last;
     if (noreverse) {
       for (p = a; (lit = *p); p++)
 	lglassume (w->lgl, lit);
@@ -395,7 +881,7 @@ DONE:
     end = getime ();
     delta = end - start;
     delta = (delta <= 0) ? 0 : delta;
-    times[last] = delta;
+    if (times) times[last] = delta;
     if (bar) {
       (void) pthread_mutex_lock (&finishedmutex);
       fin = ++finished;
@@ -408,18 +894,21 @@ DONE:
     }
     if (w->res == 10) {
       if (!bar) msg (w, 1, "job %d SATISFIABLE", last);
-      if (pthread_mutex_lock (&donemutex))
-	warn ("worker %d failed to lock 'done' mutex", WID (w));
-      done = 1;
-      if (pthread_mutex_unlock (&donemutex))
-	warn ("worker %d failed to unlock 'done' mutex", WID (w));
+      if (servername) remoteresult (w, last);
+      ATOMIC_SET (&done, 1);
+      wakestream ();
       goto DONE;
     } else if (w->res == 20) {
       w->nfailed = 0;
-      if (!w->failed) NEW (w->failed, maxassumptionsize);
+      for (p = a; *p; p++)
+	;
+      if (p - a > w->szfailed) {
+	RSZ (w->failed, w->szfailed, p - a);
+	w->szfailed = p - a;
+      }
       for (p = a; (lit = *p); p++)
 	if (lglfailed (w->lgl, lit)) {
-	  assert (w->nfailed < maxassumptionsize);
+	  assert (w->nfailed < w->szfailed);
 	  w->failed[w->nfailed++] = lit;
 	}
       if (druptraceprefix) {
@@ -442,6 +931,16 @@ DONE:
 	  fprintf (w->post, "%d ", -w->failed[i]);
 	fputs ("0\n", w->post);
       }
+      if (nodes) {
+	if (pthread_mutex_lock (&prunemutex))
+	  die ("worker %d failed to lock 'prune' mutex", WID (w));
+	i = prune (w->failed, w->nfailed);
+	if (pthread_mutex_unlock (&prunemutex))
+	  die ("worker %d failed to unlock 'prune' mutex", WID (w));
+	if (i) msg (w, 2, "job %d pruned %d pending jobs", last, i);
+      }
+      record (w, last);
+      if (servername) remoteresult (w, last);
       red = w->nfailed;
       sumassumptions += (size = p - a);
       redassumptions += red;
@@ -450,16 +949,14 @@ DONE:
 	     last, red, size, delta);
       if (!red && !deterministic) {
 	if (!bar) msg (w, 1, "job %d ACTUALLY FOUND EMPTY CLAUSE", last);
-	if (pthread_mutex_lock (&donemutex))
-	  warn ("worker %d failed to lock 'done' mutex", WID (w));
-	done = 1;
-	if (pthread_mutex_unlock (&donemutex))
-	  warn ("worker %d failed to unlock 'done' mutex", WID (w));
+	ATOMIC_SET (&done, 1);
+	wakestream ();
 	goto DONE;
       }
       if (reduce) lglreducecache (w->lgl);
     } else {
       if (!bar) msg (w, 1, "job %d UNKNOWN", last);
+      if (servername && !w->remote.cancelled) remoteresult (w, last);
       goto DONE;
     }
   }
@@ -471,6 +968,7 @@ static void init (void) {
   NEW (workers, nworkers);
   for (w = workers; w < workers + nworkers; w++) {
     w->last = -1;
+    w->next = w - workers;
     w->lgl = lglinit ();
     pthread_mutex_init (&w->cloned.lock, 0);
     initlgl (w->lgl, w, 1);
@@ -492,16 +990,38 @@ static void reset (void) {
       fclose (w->post);
       w->post = 0;
     } else assert (!w->post);
-    if (w->failed) DEL (w->failed, maxassumptionsize);
+    if (w->failed) DEL (w->failed, w->szfailed);
+    if (w->cube) DEL (w->cube, w->szcube);
+    if (w->remote.out) {
+      fclose (w->remote.out);
+      close (w->remote.fd);
+      DEL (w->remote.ids, remotebatch);
+      DEL (w->remote.buf, REMOTEBUF);
+      if (w->remote.line) DEL (w->remote.line, w->remote.szline);
+    }
   }
   DEL (workers, nworkers);
-  for (i = 0; i < nassumptions; i++) {
+  for (i = 0; !stream && i < nassumptions; i++) {
     for (p = (a = assumptions[i]); *p; p++)
       ;
     DEL (a, (p - a) + 1);
   }
   DEL (assumptions, szassumptions);
-  DEL (times, nassumptions);
+  if (times) DEL (times, nassumptions);
+  if (slots) {
+    for (i = 0; i < nslots; i++)
+      if (slots[i].lits) DEL (slots[i].lits, slots[i].szlits);
+    DEL (slots, nslots);
+  }
+  if (lastuse) DEL (lastuse, nvars - 1);
+  if (nodes) {
+    DEL (nodes, sznodes);
+    DEL (leaf, nassumptions);
+    DEL (nextend, nassumptions);
+    DEL (states, nassumptions);
+    DEL (marks, 2*nvars);
+  }
+  if (resumed) DEL (resumed, nassumptions);
   DEL (lits, szlits);
   DEL (used, szvars);
   if (allocated) 
@@ -530,6 +1050,19 @@ static void add (int lit) {
   for (i = 0; i < nworkers; i++) lgladd (workers[i].lgl, lit);
 }
 
+/* Skips the phase hints ('h' lines of 'march_cu -hints'), which are only
+ * used by iglucose, and returns the first character after them.
+ */
+static int skiphints (int ch) {
+  while (ch == 'h') {
+    while ((ch = next ()) != '\n')
+      if (ch == EOF) perr ("unexpected end-of-file in hints");
+    while ((ch = next ()) == ' ' || ch == '\t' || ch == '\r' || ch == '\n')
+      ;
+  }
+  return ch;
+}
+
 static void parse (void) {
   int ch, lit, sign, * assumption, i;
 HEADER:
@@ -560,8 +1093,10 @@ CLAUSES:
 	perr ("unexpected end-of-file in body comment");
     goto CLAUSES;
   }
+  if (ch == 'h') { ch = skiphints (ch); goto CLAUSES; }
   if (ch == EOF && nlits) perr ("unexpected end-of-file in clause");
   if (ch == 'a' && nlits) perr ("unexpected 'a' in clause");
+  if (ch == 'a' && stream) goto DONE;
   if (ch == 'a') goto ASSUMPTIONS;
   if (ch == EOF) goto DONE;
   if (ch == 'a') goto ASSUMPTIONS;
@@ -623,6 +1158,7 @@ LITS:
 NEXT:
   ch = next ();
   if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n') goto NEXT;
+  ch = skiphints (ch);
   if (ch == EOF) goto DONE;
   if (ch == '-' || isdigit (ch))
 #if 1
@@ -637,14 +1173,111 @@ DONE:
   msg (0, 1, "maximum variable %d in %d clauses", nvars, nclauses);
   msg (0, 1, "parsed %d assumptions", nassumptions);
   nvars++;
+  if (stream) {
+    NEW (slots, nslots);
+    for (i = 0; i < nslots; i++) slots[i].id = -1;
+    return;
+  }
   NEW (times, nassumptions);
   for (i = 0; i < nassumptions; i++) times[i] = -1;
 }
 
+static int cmplastuse (const void * p, const void * q) {
+  return used[*(int*)p] - used[*(int*)q];
+}
+
+/* Reads the next 'a' line into 'lits', the first 'a' was read by 'parse'.
+ */
+static int readcube (int id) {
+  int ch, lit, sign;
+  if (id) {
+    while ((ch = next ()) == ' ' || ch == '\t' || ch == '\r' || ch == '\n')
+      ;
+    ch = skiphints (ch);
+    if (ch == EOF) return 0;
+    if (ch != 'a') perr ("expected 'a' or end-of-file (clauses after cubes need all cubes, drop '--stream')");
+  }
+  if (next () != ' ') perr ("expected space after 'a'");
+  nlits = 0;
+  for (;;) {
+    while ((ch = next ()) == ' ' || ch == '\t' || ch == '\r' || ch == '\n')
+      ;
+    if (ch == '-') {
+      sign = -1;
+      ch = next ();
+      if (!isdigit (ch)) perr ("expected digit after '-'");
+    } else sign = 1;
+    if (!isdigit (ch)) perr ("expected literal");
+    lit = ch - '0';
+    while (isdigit (ch = next ())) lit = 10*lit + ch - '0';
+    if (ch != ' ' && ch != '\t' && ch != '\r' && ch != '\n')
+      perr ("expected white space after '%d'", sign * lit);
+    if (lit >= nvars)
+      perr ("assumption %d exceeds maximum variables %d", lit, nvars - 1);
+    if (!lit) break;
+    if (used[lit] < 0) nused++;
+    used[lit] = id;
+    PUSH (lits, sign * lit);
+  }
+  if (nlits > maxassumptionsize) maxassumptionsize = nlits;
+  return 1;
+}
+
+static void streamcubes (void) {
+  int id, i;
+  Slot * s;
+  for (id = 0; !ATOMIC_GET (&done) && readcube (id); id++) {
+    (void) pthread_mutex_lock (&streammutex);
+    s = slots + id % nslots;
+    if (s->id >= 0) {
+      /* Only wake up again once half of the buffered cubes are taken,
+       * otherwise every taken cube would switch between reader and worker.
+       */
+      wakereader = ntaken + (id - ntaken + 1)/2;
+      while ((s->id >= 0 || ntaken < wakereader) && !ATOMIC_GET (&done))
+	(void) pthread_cond_wait (&streamfreed, &streammutex);
+      wakereader = -1;
+    }
+    if (nlits >= s->szlits) {
+      RSZ (s->lits, s->szlits, nlits + 1);
+      s->szlits = nlits + 1;
+    }
+    for (i = 0; i < nlits; i++) s->lits[i] = lits[i];
+    s->lits[nlits] = 0;
+    s->id = id;
+    nassumptions = id + 1;
+    (void) pthread_cond_broadcast (&streamfilled);
+    (void) pthread_mutex_unlock (&streammutex);
+  }
+  if (!nomelt) {
+    NEW (lastuse, nvars - 1);
+    for (i = 1; i < nvars; i++) lastuse[i - 1] = i;
+    qsort (lastuse, nvars - 1, sizeof *lastuse, cmplastuse);
+  }
+  (void) pthread_mutex_lock (&streammutex);
+  nassumptions = id;
+  ATOMIC_SET (&streameof, 1);
+  (void) pthread_cond_broadcast (&streamfilled);
+  (void) pthread_mutex_unlock (&streammutex);
+  msg (0, 1, "streamed %d cubes using %d variables", id, nused);
+}
+
+static void indexcubes (void) {
+  int i;
+  if (noprune || deterministic || !nassumptions) return;
+  NEW (leaf, nassumptions);
+  NEW (nextend, nassumptions);
+  NEW (states, nassumptions);
+  NEW (marks, 2*nvars);
+  for (i = 0; i < nassumptions; i++)
+    insertcube (assumptions[i], i);
+  msg (0, 1, "indexed %d cubes in %d trie nodes", nassumptions, nnodes);
+}
+
 static void freeze (void) {
   int idx, i;
   for (idx = 1; idx < nvars; idx++)
-    if (used[idx] >= 0)
+    if (stream || used[idx] >= 0)
       for (i = 0; i < nworkers; i++)
 	lglfreeze (workers[i].lgl, idx);
 }
@@ -652,6 +1285,7 @@ static void freeze (void) {
 static void start (void) {
   Worker * w;
   for (w = workers; w < workers + nworkers; w++) {
+    if (servername) connectremote (w);
     if (pthread_create (&w->thread, 0, work, w))
       die ("failed to create worker thread %d", WID (w));
   }
@@ -663,6 +1297,11 @@ static void stop (void) {
   for (w = workers; w < workers + nworkers; w++)
     if (pthread_join (w->thread, 0))
       die ("failed to join worker %d", WID (w));
+  if (journal) {
+    syncjournal ();
+    fclose (journal);
+    journal = 0;
+  }
   if (bar) {
     avg = finished ? sumtimes / finished : 0.0;
     progress ((1000*finished)/nassumptions, finished, nassumptions, avg, 1);
@@ -736,7 +1375,10 @@ static void stats (void) {
   fprintf (file, "c\n");
   fprintf (file, "c ---------[global-stats]-------------------------\n");
   fprintf (file, "c\n");
-  statsps (file, "scheduled jobs", queue, wct);
+  statsps (file, "scheduled jobs", scheduled, wct);
+  fprintf (file, "c %d pruned jobs %.0f%% out of %d\n",
+           npruned, nassumptions ? (100.0*npruned)/nassumptions : 0,
+	   nassumptions);
   fprintf (file, "c %d failed assumptions %.0f%% out of %d\n",
 	   redassumptions,
 	   sumassumptions ? (100.0*redassumptions)/sumassumptions : 0,
@@ -755,7 +1397,7 @@ static void stats (void) {
   n = 0;
   sum = 0;
   max = min = -1;
-  for (i = 0; i < nassumptions; i++) {
+  for (i = 0; times && i < nassumptions; i++) {
     if ((t = times[i]) < 0) continue;
     sum += t;
     times[n++] = t;
@@ -782,7 +1424,7 @@ static void stats (void) {
 static void hist (void) {
   FILE * file = histfile ? histfile : stdout;
   int i;
-  for (i = 0; i < nassumptions; i++)
+  for (i = 0; times && i < nassumptions; i++)
     fprintf (file, "%.3f\n", times[i]);
   fflush (file);
 }
@@ -859,13 +1501,28 @@ int main (int argc, char ** argv) {
 "\n"
 "            jobs are mapped deterministically to workers\n"
 "\n"
+"  --no-prune  do not prune jobs containing failed assumptions\n"
+"              (pruning is always disabled in deterministic mode)\n"
+"\n"
 "  --no-add    do not add failed assumptions as don't care\n"
 "  -A  add all assumptions as don't care\n"
 "\n"
 "  <inccnf>    'p inccnf' + '<lit*> 0' clauses + 'a <lit>* 0' assumptions\n"
 "  <nworkers>  number of workers defaults to 1\n"
 "\n"
-"  -d|--drup   <path-prefix-for-traces>\n");
+"  -d|--drup   <path-prefix-for-traces>\n"
+"\n"
+"  -j <journal>  append refuted cubes to this file and on restart skip\n"
+"                the cubes it already contains\n"
+"\n"
+"  -c <server>   solve the cubes handed out by a cube server\n"
+"                ('iglucose -serve=<server>', 'unix:<path>' or '[<host>:]<port>')\n"
+"  --batch <n>   number of cubes requested from the server at once (16)\n"
+"\n"
+"  --stream      start solving after the formula and read the cubes while\n"
+"                solving, memory does not depend on the number of cubes\n"
+"                (disables pruning, requires cubes after all clauses)\n"
+"  --buffer <n>  number of cubes read ahead in streaming mode (1024)\n");
       exit (0);
     } else if (!strcmp (argv[i], "--version")) {
       printf ("%s\n", lglversion ());
@@ -876,6 +1533,7 @@ int main (int argc, char ** argv) {
     else if (!strcmp (argv[i], "--no-reverse")) noreverse = 1;
     else if (!strcmp (argv[i], "--no-add")) addassumptions = 0;
     else if (!strcmp (argv[i], "--no-melt")) nomelt = 1;
+    else if (!strcmp (argv[i], "--no-prune")) noprune = 1;
     else if (!strcmp (argv[i], "--reduce")) reduce = 1;
     else if (!strcmp (argv[i], "--deterministic") ||
              !strcmp (argv[i], "--det"))
@@ -897,6 +1555,26 @@ int main (int argc, char ** argv) {
       if (druptraceprefix) die ("DRUP path prefix set twice");
       druptraceprefix = argv[i];
     }
+    else if (!strcmp (argv[i], "--stream")) stream = 1;
+    else if (!strcmp (argv[i], "--buffer")) {
+      if (++i == argc) die ("argument to '--buffer' missing");
+      if (!isnum (argv[i]) || (nslots = atoi (argv[i])) <= 0)
+	die ("invalid buffer size '%s'", argv[i]);
+    }
+    else if (!strcmp (argv[i], "-c")) {
+      if (servername) die ("two '-c' options");
+      if (++i == argc) die ("argument to '-c' missing");
+      servername = argv[i];
+    } else if (!strcmp (argv[i], "--batch")) {
+      if (++i == argc) die ("argument to '--batch' missing");
+      if (!isnum (argv[i]) || (remotebatch = atoi (argv[i])) <= 0)
+	die ("invalid batch size '%s'", argv[i]);
+    }
+    else if (!strcmp (argv[i], "-j")) {
+      if (journalname) die ("two '-j' options");
+      if (++i == argc) die ("argument to '-j' missing");
+      journalname = argv[i];
+    }
     else if (argv[i][0] == '-') die ("invalid option '%s'", argv[i]);
     else if (isnum (argv[i])) {
       if (nworkers) die ("number of workers specified twice: '%d' and '%s'",
@@ -907,6 +1585,19 @@ int main (int argc, char ** argv) {
       die ("two files given: '%s' and '%s'", inputname, argv[i]);
     else inputname = argv[i];
   }
+  if (servername && journalname) die ("'-j' and '-c' are exclusive");
+  if (stream) {
+    if (servername) die ("'--stream' and '-c' are exclusive");
+    if (journalname) die ("'--stream' and '-j' are exclusive");
+    if (addassumptions > 1) die ("'--stream' and '-A' are exclusive");
+    if (bar) die ("'--stream' and '-b' are exclusive");
+    noprune = 1;
+  }
+  if (servername && deterministic) die ("'--det' and '-c' are exclusive");
+  if (servername) {
+    signal (SIGPIPE, SIG_IGN);
+    nomelt = noprune = 1;
+  }
   if (bar && !isatty (1)) 
     die ("progress bar requested but <stdout> not connected to terminal");
   if (verbose >= 2 && bar) die ("verbosity %d > 1 with '-b'", verbose);
@@ -929,21 +1620,37 @@ int main (int argc, char ** argv) {
   setsighandlers ();
   msg (0, 1, "parsing %s", inputname);
   parse ();
-  if (closeinputfile) fclose (inputfile);
+  if (closeinputfile && !stream) fclose (inputfile);
   msg (0, 1, "%d variables out of %d used in assumptions which is %.0f%%",
        nused, nvars, nvars ? 100.0 * (nused /(double)nvars) : 0.0);
   freeze ();
+  indexcubes ();
+  resume ();
   start ();
+  if (stream) {
+    streamcubes ();
+    if (closeinputfile) fclose (inputfile);
+  }
   stop ();
   winner = 0;
   for (w = workers; w < workers + nworkers; w++)
     if (w->res) { winner = w;  if (w->res == 10) break; }
+  if (servername) {
+    /* Only a model is final, otherwise the server reports the result. */
+    if (winner && winner->res != 10) winner = 0;
+    for (w = workers, i = 0; w < workers + nworkers; w++) {
+      if (w->remote.result == 20) res = 20;
+      i += w->remote.solved;
+    }
+    msg (0, 0, "conquered %d cubes for '%s'", i, servername);
+  }
   if (winner && (res = winner->res) == 10 && !nowitness) {
       NEW (vals, nvars);
       for (i = 1; i < nvars; i++)
 	vals[i] = lglderef (winner->lgl, i);
   }
-  assert (winner || !nassumptions);
+  if (!winner && nresumed == nassumptions && nassumptions) res = 20;
+  assert (servername || winner || !nassumptions || res);
   resetsighandlers ();
   if (statsfile) stats ();
   if (statsfilename) fclose (statsfile);
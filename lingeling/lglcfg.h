@@ -0,0 +1,8 @@
+/*************************************************************/
+/* Automatically generated by './mkconfig.sh': do note edit! */
+/*************************************************************/
+#define LGL_OS "Linux vm 6.18.44-fc-v139 x86_64"
+#define LGL_COMPILED "Sun Oct 18 22:42:39 UTC 2026"
+#define LGL_RELEASED "Thu May 17 11:57:41 CEST 2018"
+#define LGL_VERSION "bcj"
+#define LGL_ID "78ebb8672540bde0a335aea946bbf32515157d5a"
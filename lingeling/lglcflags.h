@@ -0,0 +1,2 @@
+#define LGL_CC "gcc (Debian 12.2.0-14+deb12u1) 12.2.0"
+#define LGL_CFLAGS "-Wall -O3 -I../march_cu -DNLGLOG -DNDEBUG -DNCHKSOL -DNLGLDRUPLIG -DNLGLYALSAT -DNLGLFILES -DNLGLDEMA"
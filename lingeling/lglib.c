@@ -10535,7 +10535,7 @@ static int lglsyncls (LGL * lgl) {
   consumed = 0;
 RESTART:
   lgl->cbs->cls.consume.fun (lgl->cbs->cls.consume.state, &cls, &glue);
-  if (!cls) return 1;
+  if (!cls) { res = 1; goto CONSUMED; }
   lgl->stats->sync.cls.consumed.tried++;
   LOGCLS (2, cls, "trying to import external clause");
   assert (lglmtstk (&lgl->clause));
@@ -10605,6 +10605,7 @@ RESTART:
 DONE:
   lglclnstk (&lgl->clause);
   if (res && lgl->opts->synclsall.val) goto RESTART;
+CONSUMED:
   if (lgl->cbs->cls.consumed.fun)
     lgl->cbs->cls.consumed.fun (lgl->cbs->cls.consumed.state, consumed);
   return res;
@@ -26157,7 +26158,7 @@ static void lglictrav (LGL * lgl,
   const int * p, * w, * eow, * c;
   int glue;
   HTS * hts;
-  REQINITNOTFORKED ();
+  REQINIT ();
   if (lgl->mt) { trav (state, 0, 0); return; }
   for (idx = 2; idx < lgl->nvars; idx++) {
     for (sign = -1; sign <= 1; sign += 2) {
@@ -26218,6 +26219,7 @@ static void lglirrtrav (void * state, int red, int lit) {
 
 void lglctrav (LGL * lgl, void * state, void (*trav)(void *, int)) {
   IrrTrav irrtrav;
+  REQINITNOTFORKED ();
   irrtrav.state = state;
   irrtrav.trav = trav;
   if (lgl->level) lglbacktrack (lgl, 0);
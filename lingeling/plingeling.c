@@ -22,6 +22,12 @@
 #define NWORKERS 8
 #define MAXGB 12
 #define NUNITS (1<<9)
+#define RINGSIZE (1<<16)	/* literals in the clause ring of a worker */
+#define MAXSHAREGLUE 8		/* default of 'synclsglue' in lingeling */
+#define MINSHAREGLUE 2
+#define SHAREWINDOW 1000	/* offers between adjustments of the glue */
+#define SHARELOW 250		/* per mille imported to decrease glue */
+#define SHAREHIGH 500		/* per mille imported to increase glue */
 
 /*------------------------------------------------------------------------*/
 #if 0
@@ -56,26 +62,44 @@ do { \
 
 /*------------------------------------------------------------------------*/
 
-typedef struct Cls { int wid, count, glue, lits[1]; } Cls;
+/* Every worker exports its clauses to its own ring of RINGSIZE literals,
+ * as records of glue, literals and a terminating zero.  Only the worker
+ * writes to its ring, so exporting needs neither a lock nor a 'malloc'.
+ * Before overwriting old records the worker announces the new end in
+ * 'reserved', and after writing publishes it in 'head'.  Consumers copy
+ * all records up to 'head' of all other rings into a private batch and
+ * afterwards discard the copy if 'reserved' shows that the producer has
+ * wrapped around in the meantime, similar to a sequence lock.
+ */
+typedef struct Ring {
+  int * lits;
+  int64_t head, reserved;
+} Ring;
 
 typedef struct Worker {
   LGL * lgl;
   pthread_t thread;
   int res, fixed;
   int units[NUNITS], nunits;
-  int * cls, szcls;
-  long clsimported;
-  Cls * dead;
+  Ring ring;
+  int64_t * imported;		/* read position in the ring of each worker */
+  int * batch, nbatch, szbatch, nextbatch;
+  int * offers, noffers;	/* offered clauses per producer in a sync */
+  int glue;			/* adaptive glue limit of exported clauses */
+  int64_t offered, useful;	/* updated by consumers, useful in per mille */
+  int64_t lastoffered, lastuseful;
   struct {
     struct { int calls, produced, consumed; } units;
     struct { int produced, consumed; } cls, eqs;
+    struct { int filtered, batches, overruns, incs, decs; } share;
     int produced, consumed;
+    double sharing;
   } stats;
 } Worker;
 
 /*------------------------------------------------------------------------*/
 
-static int verbose, plain, nounits, noeqs, nocls, gclim = 1, gclimset;
+static int verbose, plain, nounits, noeqs, nocls;
 #ifndef NLGLOG
 static int loglevel;
 #endif
@@ -85,13 +109,13 @@ static int forcelocs;
 
 /*------------------------------------------------------------------------*/
 
-static int nworkers, nconsumers, leavebehind, locs;
+static int nworkers, locs;
 static int64_t memlimit, softmemlimit;
 static Worker * workers;
 static int nvars, nclauses;
 static int * vals, * fixed, * repr;
-struct { Cls ** start; long first, num, added, collected, size; } clauses;
-static int nfixed, globalres, gcs;
+static int64_t sharedcls;
+static int nfixed, globalres;
 static const char * name;
 static int nworkers2;
 struct { size_t max, current;} mem;
@@ -106,7 +130,6 @@ static pthread_mutex_t msgmutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t fixedmutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t reprmutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t memutex = PTHREAD_MUTEX_INITIALIZER;
-static pthread_mutex_t clsmutex = PTHREAD_MUTEX_INITIALIZER;
 
 /*------------------------------------------------------------------------*/
 
@@ -163,9 +186,14 @@ static double percent (double a, double b) { return b ? (100 * a) / b : 0; }
 static void stats (void) {
   double real, process, mpps, cps, mb;
   int64_t decs, confs, props;
-  int i, unitcalls;
+  int i, unitcalls, filtered, batches, overruns, incs, decs2;
+  int64_t offered, useful, exported;
+  double sharing;
   Worker * w;
-  unitcalls = decs = confs = 0;
+  unitcalls = decs = confs = exported = 0;
+  filtered = batches = overruns = incs = decs2 = 0;
+  offered = useful = 0;
+  sharing = 0;
   props = 0;
   mb = mem.max / (double)(1<<20);
   for (i = 0; i < nworkers; i++) {
@@ -176,6 +204,15 @@ static void stats (void) {
     props += lglgetprops (w->lgl);
     mb += lglmaxmb (w->lgl);
     unitcalls += w->stats.units.calls;
+    filtered += w->stats.share.filtered;
+    batches += w->stats.share.batches;
+    overruns += w->stats.share.overruns;
+    incs += w->stats.share.incs;
+    decs2 += w->stats.share.decs;
+    exported += w->stats.cls.produced;
+    offered += w->offered;
+    useful += w->useful;
+    sharing += w->stats.sharing;
   }
   real = getime ();
   process = lglprocesstime ();
@@ -185,10 +222,13 @@ static void stats (void) {
   printf ("c\n");
   printf ("c units: %d found, %d publications, %d syncs, %d flushed\n", 
           units, unitcalls, syncs.units, flushed);
-  printf ("c clauses: %ld clauses added, %ld collected %.0f%%, %d gcs\n",
-    clauses.added,
-    clauses.collected, percent (clauses.collected, clauses.added),
-    gcs);
+  printf ("c clauses: %lld exported, %d filtered, %d glue incs, %d decs\n",
+    (long long) exported, filtered, incs, decs2);
+  printf ("c clauses: %lld offered, %.0f%% imported, %d batches, %d overruns\n",
+    (long long) offered, percent (useful / 1000.0, offered),
+    batches, overruns);
+  printf ("c clauses: %.2f seconds importing, %.0f%% of process time\n",
+    sharing, percent (sharing, lglprocesstime ()));
   printf ("c equivalences: %d found, %d syncs\n", eqs, syncs.eqs);
   printf ("c\n");
   printf ("c %lld decisions, %lld conflicts, %.1f conflicts/sec\n", 
@@ -488,150 +528,144 @@ static void consumedunits (void * voidptr, int consumed) {
 
 static void * resize (void*,void*,size_t,size_t);
 
-static size_t sizecls (int len) { return sizeof (Cls) + len * sizeof (int); }
+#define LOAD(PTR) __atomic_load_n ((PTR), __ATOMIC_RELAXED)
+#define STORE(PTR,VAL) __atomic_store_n ((PTR), (VAL), __ATOMIC_RELAXED)
 
 static int lencls (int * c) { int res = 0; while (*c++) res++; return res; }
 
+/* Lowers the glue limit of a producer if too few of its clauses offered to
+ * other workers are actually imported by them, and raises it otherwise.
+ */
+static void adjustglue (Worker * worker) {
+  int64_t offered = LOAD (&worker->offered), useful, rate;
+  int wid = worker - workers;
+  if (offered - worker->lastoffered < SHAREWINDOW) return;
+  useful = LOAD (&worker->useful);
+  rate = (useful - worker->lastuseful) / (offered - worker->lastoffered);
+  worker->lastoffered = offered;
+  worker->lastuseful = useful;
+  if (rate < SHARELOW && worker->glue > MINSHAREGLUE)
+    worker->glue--, worker->stats.share.decs++;
+  else if (rate > SHAREHIGH && worker->glue < MAXSHAREGLUE)
+    worker->glue++, worker->stats.share.incs++;
+  else return;
+  msg (wid, 2, "%lld per mille of offered clauses imported, glue limit %d",
+    (long long) rate, worker->glue);
+}
+
 static void producecls (void * voidptr, int * c, int glue) {
   Worker * worker = voidptr;
+  Ring * ring = &worker->ring;
   int wid = worker - workers;
-  int len, * q, lit;
+  int len, lit, mask = RINGSIZE - 1;
+  int64_t head = ring->head;
   const int * p;
-  size_t bytes;
-  Cls * cls;
   len = lencls (c);
-  bytes = sizecls (len);
-  cls = malloc (bytes);
-  if (!cls) { die ("out of memory in 'producecls'"); exit (1); }
-  LOGMEM (a, cls, bytes);
-  incmem (bytes);
-  cls->wid = wid;
-  cls->glue = glue;
-  cls->count = 0;
-  p = c, q = cls->lits; 
-  while ((lit = *p++)) *q++ = lit;
-  *q++ = 0;
-  if (pthread_mutex_lock (&clsmutex))
-    warn ("failed to lock 'cls' mutex in 'producecls'");
-  msg (wid, 3, "producing glue %d length %d clause %ld",
-    glue, len, clauses.added);
-  if (clauses.num == clauses.size) {
-    int newsize = clauses.size ? 2*clauses.size : 1;
-    size_t old_bytes = clauses.size * sizeof *clauses.start;
-    size_t new_bytes = newsize * sizeof *clauses.start;
-    clauses.start = resize (0, clauses.start, old_bytes, new_bytes);
-    clauses.size = newsize;
+  if (glue > worker->glue || len + 2 > RINGSIZE / 4) {
+    worker->stats.share.filtered++;
+    return;
   }
-  clauses.start[clauses.num++] = cls;
-  clauses.added++;
-  if (pthread_mutex_unlock (&clsmutex))
-    warn ("failed to unlock 'cls' mutex in 'producecls'");
+  msg (wid, 3, "producing glue %d length %d clause", glue, len);
+  STORE (&ring->reserved, head + len + 2);
+  __atomic_thread_fence (__ATOMIC_RELEASE);
+  STORE (ring->lits + (head++ & mask), glue);
+  for (p = c; (lit = *p); p++) STORE (ring->lits + (head++ & mask), lit);
+  STORE (ring->lits + (head++ & mask), 0);
+  __atomic_store_n (&ring->head, head, __ATOMIC_RELEASE);
   worker->stats.cls.produced++;
   worker->stats.produced++;
+  adjustglue (worker);
 }
 
-static void deletecls (Cls * cls) {
-  int len = lencls (cls->lits);
-  size_t bytes = sizecls (len);
-  LOGMEM (d, cls, bytes);
-  decmem (bytes);
-  free (cls);
-}
-
-static void deleteallcls () {
-  Cls * c;
-  int i;
-  for (i = clauses.first; i < clauses.num; i++) {
-    c = clauses.start[i];
-    if (c) deletecls (c);
+static void pushbatch (Worker * worker, int val) {
+  if (worker->nbatch == worker->szbatch) {
+    int newsize = worker->szbatch ? 2*worker->szbatch : 1024;
+    worker->batch = resize (0, worker->batch,
+                            worker->szbatch * sizeof (int),
+                            newsize * sizeof (int));
+    worker->szbatch = newsize;
   }
-  DEL (clauses.start, clauses.size);
+  worker->batch[worker->nbatch++] = val;
 }
 
-static void gcls (void) {
-  long j, k, l;
-  Cls * c;
-  int i;
-  assert (0 <= clauses.first);
-  assert (clauses.first <= clauses.num);
-  gcs++;
-  msg (-1, 1, "garbage collecting clauses: first=%ld, num=%ld, SIZE=%ld",
-    clauses.first, clauses.num, clauses.size);
-  for (k = 0; k < clauses.first; k++) assert (!clauses.start[k]);
-  while (k < clauses.num) {
-    c = clauses.start[k];
-    if (c->count > gclim) break;
-    clauses.start[k++] = 0;
-    deletecls (c);
-  }
-  assert (clauses.first <= k);
-  for (i = 0; i < nworkers; i++) {
-    Worker * worker = workers + i;
-    if (k < worker->clsimported) worker->clsimported -= k;
-    else worker->clsimported = 0;
+/* Copies all new records of the other workers into the batch of 'worker',
+ * each prefixed with the id of its producer.
+ */
+static void fillbatch (Worker * worker) {
+  int wid = worker - workers;
+  int src, lit, mark, mask = RINGSIZE - 1;
+  int64_t pos, head, reserved;
+  double start = currentime ();
+  Ring * ring;
+  worker->nbatch = worker->nextbatch = 0;
+  for (src = 0; src < nworkers; src++) {
+    if (src == wid) continue;
+    ring = &workers[src].ring;
+    head = __atomic_load_n (&ring->head, __ATOMIC_ACQUIRE);
+    pos = worker->imported[src];
+    if (pos == head) continue;
+    mark = worker->nbatch;
+    if (head - pos <= RINGSIZE) {
+      while (pos < head) {
+	pushbatch (worker, src);
+	pushbatch (worker, LOAD (ring->lits + (pos++ & mask)));
+	do pushbatch (worker, lit = LOAD (ring->lits + (pos++ & mask)));
+	while (lit && pos < head);
+	if (lit) pushbatch (worker, 0);		/* torn, dropped below */
+      }
+    }
+    __atomic_thread_fence (__ATOMIC_ACQUIRE);
+    reserved = LOAD (&ring->reserved);
+    if (reserved - worker->imported[src] > RINGSIZE) {
+      msg (wid, 2, "clauses of worker %d overwritten before import", src);
+      worker->nbatch = mark;
+      worker->stats.share.overruns++;
+    }
+    worker->imported[src] = head;
   }
-  j = 0;
-  for (l = k; l < clauses.num; l++)
-    clauses.start[j++] = clauses.start[l];
-  clauses.collected += k;
-  clauses.first = 0;
-  clauses.num -= k;
-  assert (clauses.num >= 0);
+  if (worker->nbatch) worker->stats.share.batches++;
+  worker->stats.sharing += currentime () - start;
 }
 
 static void consumecls (void * voidptr, int ** cptr, int * glueptr) {
   Worker * worker = voidptr;
-  int wid = worker - workers;
-  int res, len, newsize;
-  Cls * cls;
-  if (pthread_mutex_lock (&clsmutex))
-    warn ("failed to lock 'cls' mutex in 'consumecls'");
-  assert (worker->clsimported <= clauses.num);
-RESTART:
-  if (worker->dead) deletecls (worker->dead), worker->dead = 0;
-  if (worker->clsimported == clauses.num) {
-    msg (wid, 3, "all %d clauses already consumed", clauses.num);
+  int wid = worker - workers, src;
+  if (worker->nextbatch == worker->nbatch) fillbatch (worker);
+  if (worker->nextbatch == worker->nbatch) {
+    msg (wid, 3, "all clauses already consumed");
     *cptr = 0;
-  } else {
-    res = worker->clsimported++;
-    cls = clauses.start[res];
-    if (!cls) goto RESTART;
-    cls->count++;
-    if (cls->count + leavebehind >= nconsumers) {
-      clauses.start[res] = 0;
-      assert (!worker->dead);
-      worker->dead = cls;
-      assert (clauses.first <= res);
-      clauses.first++;
-      if (clauses.num > 10000 &&
-	  clauses.first > clauses.num/(nconsumers + 1)) gcls ();
-    }
-    if (cls->wid == wid) goto RESTART;
-    len = lencls (cls->lits);
-    if (len + 1 >= worker->szcls) {
-      newsize = 2*(len + 1);
-      worker->cls = resize (0, worker->cls, 
-                            worker->szcls * sizeof (int),
-                            newsize * sizeof (int));
-      worker->szcls = newsize;
-    }
-    memcpy (worker->cls, cls->lits, (len+1) * sizeof (int));
-    *cptr = worker->cls;
-    *glueptr = cls->glue;
-    msg (wid, 3,
-      "consuming glue %d length %d clause %d",
-      *glueptr, len, res);
+    return;
   }
-  if (pthread_mutex_unlock (&clsmutex))
-    warn ("failed to unlock 'cls' mutex in 'consumecls'");
+  src = worker->batch[worker->nextbatch++];
+  *glueptr = worker->batch[worker->nextbatch++];
+  *cptr = worker->batch + worker->nextbatch;
+  while (worker->batch[worker->nextbatch++])
+    ;
+  worker->offers[src]++;
+  worker->noffers++;
+  msg (wid, 3, "consuming glue %d length %d clause of worker %d",
+    *glueptr, lencls (*cptr), src);
 }
 
+/* Credits each producer with its share of the imported clauses.
+ */
 static void consumedcls (void * voidptr, int consumed) {
   Worker * worker = voidptr;
-  int wid = worker - workers;
+  int wid = worker - workers, src;
   worker->stats.cls.consumed += consumed;
   worker->stats.consumed += consumed;
   msg (wid, 3, "consuming %d clause", consumed);
+  if (!worker->noffers) return;
+  for (src = 0; src < nworkers; src++) {
+    if (!worker->offers[src]) continue;
+    __atomic_fetch_add (&workers[src].offered,
+                        worker->offers[src], __ATOMIC_RELAXED);
+    __atomic_fetch_add (&workers[src].useful,
+      (1000ll * consumed * worker->offers[src]) / worker->noffers,
+      __ATOMIC_RELAXED);
+    worker->offers[src] = 0;
+  }
+  worker->noffers = 0;
 }
 
 static int * lockrepr (void * voidptr) {
@@ -988,7 +1022,6 @@ int main (int argc, char ** argv) {
 "  -t <num>   number of worker threads (default %d on this machine)\n"
 "  -m <num>   maximal memory in MB (default %lld MB on this machine)\n"
 "  -g <num>   maximal memory in GB (default %lld GB on this machine)\n"
-"  -l <num>   limit on number of workers before collecting shared clause\n"
 "\n"
 "  -p         plain portfolio, no sharing, e.g. implies the following:\n"
 "\n"
@@ -1026,13 +1059,6 @@ getsystemcores (0), bytes2mbll (totalmem), bytes2gbll (totalmem));
       if (i + 1 == argc) die ("argument to '-g' missing");
       if (!isposnum (arg = argv[++i]) || (memlimit = (atoll (arg)<<30)) <= 0)
 	die ("invalid argument '%s' to '-g'", arg);
-    } else if (!strcmp (argv[i], "-l")) {
-      if (gclimset) die ("multiple '-l' options");
-      if (i + 1 == argc) die ("argument to '-l' missing");
-      if (!isposnum (argv[++i]))
-	die ("invalid argument '%s' to '-l'", argv[i]);
-      gclim = atoi (argv[i]);
-      gclimset = 1;
     } else if (argv[i][0] == '-') 
       die ("invalid option '%s' (try '-h')", argv[i]);
     else if (!name && isposnum (argv[i]))
@@ -1082,9 +1108,6 @@ getsystemcores (0), bytes2mbll (totalmem), bytes2gbll (totalmem));
   }
   softmemlimit = (memlimit + 2)/3;
   msg (-1, 0, "soft memory limit set to %lld MB", bytes2mbll (softmemlimit));
-  if (gclimset)
-    msg (-1, 0, "garbage collection limit %d ('-l %d')", gclim, gclim);
-  else msg (-1, 0, "default garbage collection limit %d", gclim);
   if (plain) {
     nounits = nocls = noeqs = 1;
     msg (-1, 0, "not sharing anything in plain portolio mode ('-p')");
@@ -1099,6 +1122,17 @@ getsystemcores (0), bytes2mbll (totalmem), bytes2gbll (totalmem));
     else msg (-1, 0, "sharing of equivalences enabled");
   }
   NEW (workers, nworkers);
+  if (!nocls) {
+    for (i = 0; i < nworkers; i++) {
+      w = workers + i;
+      NEW (w->ring.lits, RINGSIZE);
+      NEW (w->imported, nworkers);
+      NEW (w->offers, nworkers);
+      w->glue = MAXSHAREGLUE;
+    }
+    msg (-1, 1, "%d KB clause ring per worker",
+      (int) ((RINGSIZE * sizeof (int)) >> 10));
+  }
   workers[0].lgl = lglminit (0, alloc, resize, dealloc);
   lglsetopt (workers[0].lgl, "druplig", 0);
   setopt (0, workers[0].lgl, "bca", 0);
@@ -1163,19 +1197,6 @@ getsystemcores (0), bytes2mbll (totalmem), bytes2gbll (totalmem));
   if (forcelocs) locs = forcelocs;
 #endif
   setopts (workers[0].lgl, 0);
-  if (locs >= 2) nconsumers = 1;
-  else if (locs == 1) {
-    nconsumers = 1;
-    for (i = 1; i < nworkers; i++)
-      if (i < 8 && !(i & 1)) nconsumers++;
-  } else nconsumers = nworkers;
-  msg (-1, 1,
-    "assuming %d consumers out of %d workers",
-    nconsumers, nworkers);
-  leavebehind = nconsumers / 4;
-  msg (-1, 1,
-    "will leave behind %d consumers out of %d",
-    leavebehind, nconsumers);
   earlyworker = (nworkers > 1 && cloneworker (1)) ? workers + 1 : 0;
   if (earlyworker) {
     assert (earlyworker->lgl);
@@ -1239,6 +1260,7 @@ getsystemcores (0), bytes2mbll (totalmem), bytes2gbll (totalmem));
 	msg (-1, 0, "worker %d is the WINNER with result %d", i, res);
       } else if (res != w->res) die ("result discrepancy");
     }
+    sharedcls += w->stats.cls.produced;
     if (!maxconsumer || w->stats.consumed > maxconsumer->stats.consumed)
       maxconsumer = w;
     if (!maxproducer || w->stats.produced > maxproducer->stats.produced)
@@ -1257,9 +1279,9 @@ getsystemcores (0), bytes2mbll (totalmem), bytes2gbll (totalmem));
       "c %2d %s %7d %3.0f%% = %7d units %3.0f%% + %7d cls %3.0f%% + %7d eqs %3.0f%%\n",
        id, (w == maxproducer ? "PROD" : "prod"),
        w->stats.produced,
-         percent (w->stats.produced, units + eqs + clauses.added),
+         percent (w->stats.produced, units + eqs + sharedcls),
        w->stats.units.produced, percent (w->stats.units.produced, units),
-       w->stats.cls.produced, percent (w->stats.cls.produced, clauses.added),
+       w->stats.cls.produced, percent (w->stats.cls.produced, sharedcls),
        w->stats.eqs.produced, percent (w->stats.eqs.produced, eqs));
   }
   fputs ("c ", stdout);
@@ -1267,7 +1289,7 @@ getsystemcores (0), bytes2mbll (totalmem), bytes2gbll (totalmem));
   fputc ('\n', stdout);
   printf (
     "c    prod %7lld 100%% = %7d units 100%% + %7lld cls 100%% + %7d eqs 100%%\n",
-    (long long) units + eqs + clauses.added, units, (long long) clauses.added, eqs);
+    (long long) units + eqs + sharedcls, units, (long long) sharedcls, eqs);
   printf ("c\n");
   assert (maxconsumer);
   qsort (sorted, nworkers, sizeof *sorted, cmpconsumed);
@@ -1283,9 +1305,9 @@ getsystemcores (0), bytes2mbll (totalmem), bytes2gbll (totalmem));
     printf (
       "c %2d %s %7d %3.0f%% = %7d units %3.0f%% + %7d cls %3.0f%% + %7d eqs %3.0f%%\n",
       id, (w == maxconsumer ? "CONS" : "cons"),
-      w->stats.consumed, percent (w->stats.consumed, units + eqs + clauses.added),
+      w->stats.consumed, percent (w->stats.consumed, units + eqs + sharedcls),
       w->stats.units.consumed, percent (w->stats.units.consumed, units),
-      w->stats.cls.consumed, percent (w->stats.cls.consumed, clauses.added),
+      w->stats.cls.consumed, percent (w->stats.cls.consumed, sharedcls),
       w->stats.eqs.consumed, percent (w->stats.eqs.consumed, eqs));
   }
   fputs ("c ", stdout);
@@ -1293,9 +1315,9 @@ getsystemcores (0), bytes2mbll (totalmem), bytes2gbll (totalmem));
   fputc ('\n', stdout);
   printf (
     "c    cons %7d %3.0f%% = %7d units %3.0f%% + %7d cls %3.0f%% + %7d eqs %3.0f%%\n",
-    sumconsumed,  percent (sumconsumed, units + eqs + clauses.added),
+    sumconsumed,  percent (sumconsumed, units + eqs + sharedcls),
     sumconsumedunits, percent (sumconsumedunits, units),
-    sumconsumedcls, percent (sumconsumedcls, clauses.added),
+    sumconsumedcls, percent (sumconsumedcls, sharedcls),
     sumconsumedeqs, percent (sumconsumedeqs, eqs));
   DEL (sorted, nworkers);
   fflush (stdout);
@@ -1346,17 +1368,20 @@ getsystemcores (0), bytes2mbll (totalmem), bytes2gbll (totalmem));
   msg (-1, 2, "releasing %d workers", nworkers);
   for (i = 0; i < nworkers; i++) {
     w = workers + i;
-    if (!w->lgl) continue;
-    lglrelease (w->lgl);
-    msg (-1, 2, "released worker %d", i);
-    if (w->dead) deletecls (w->dead), w->dead = 0;
-    DEL (w->cls, w->szcls);
+    if (w->lgl) {
+      lglrelease (w->lgl);
+      msg (-1, 2, "released worker %d", i);
+    }
+    if (nocls) continue;
+    DEL (w->ring.lits, RINGSIZE);
+    DEL (w->imported, nworkers);
+    DEL (w->offers, nworkers);
+    DEL (w->batch, w->szbatch);
   }
   DEL (workers, nworkers);
   DEL (fixed, nvars + 1);
   if (!noeqs) DEL (repr, nvars + 1);
   DEL (vals, nvars + 1);
-  deleteallcls ();
 
   assert (getenv ("PLINGELINGLEAK") || !mem.current);
 
@@ -4,6 +4,10 @@
 
 #include "lglib.h"
 
+#ifndef NLGLMARCH
+#include "libmarch.h"
+#endif
+
 #include <assert.h>
 #include <ctype.h>
 #include <limits.h>
@@ -43,6 +47,7 @@
 #define FULLSEARCH		2
 #define DEFBRANCHES		50
 #define OPTIMIZE		10
+#define PARKHOLD		4
 
 /*------------------------------------------------------------------------*/
 
@@ -93,10 +98,11 @@ typedef enum State {
 
 typedef struct Node {
   State state;
-  int pos, lookahead, depth, res, simplified, consumed;
+  int pos, lookahead, depth, res, simplified, consumed, vars, unparked;
   int64_t id, decisions, conflicts, propagations;
+  size_t bytes;
   int * cube;
-  LGL * lgl;
+  LGL * lgl;		// zero while parked
 } Node;
 
 typedef struct Leaf {
@@ -118,7 +124,6 @@ typedef struct Job {
   State state;
   Node * node;
   void * (*fun)(void *);
-  pthread_t thread;
   const char * name;
 } Job;
 
@@ -133,12 +138,12 @@ static int verbose, balance, showstats, nowitness, ncores, randswap, locslkhd;
 static int reducecache, nosimp, forcesimp, forcelkhd = 1, nosearch, noparallel;
 static int stoplkhd, stoplkhdint = 1, lkhdsuccessful, optimize = -1;
 static int fullint = FULLINT, asymmetric = ASYMMETRIC, eager = 1;
-static int splitsuccessful = 1, branches = -1, portfolio = 0;
+static int splitsuccessful = 1, branches = -1, portfolio = 0, marchlkhd;
 
 static int clim, newclim, forcedclim, thisclim, initclim, maxclim, minclim;
 static int nvars, nclauses;
 
-static LGL * root;
+static LGL * root, * base;
 static Node ** nodes;
 static int numnodes, maxnumnodes, sizenodes;
 static int rootconsumed;
@@ -148,10 +153,19 @@ static int nparallel;
 
 static int maxactive, firstosplit, numtosplit, lastosplit;
 static int maxworkers, maxworkers2, numworkers, maxnumworkers;
+static int parked, maxparked;
+static int64_t parkings, unparkings;
 
 static Job ** jobs;
 static int numjobs, sizejobs;
+
+static struct {
+  pthread_t * threads;
+  int num, posted, next, finished, quit;
+  pthread_cond_t work, idle;
+} pool;
 static struct { int64_t cnt, lkhd, split, simp, search; } js;
+static struct { int64_t calls, splits, failed, refuted; } ms;
 
 static int64_t * confstack;
 static int numconfstack, sizeconfstack;
@@ -175,6 +189,7 @@ static int done, stop;
 static struct { unsigned z, w; } rng;
 
 static struct { 
+  Lock base;
   Lock confs;
   Lock done;
   Lock leafs;
@@ -185,6 +200,7 @@ static struct {
   Lock parleafs;
   Lock parstats;
   Lock parunits;
+  Lock pool;
   Lock simplified;
   Lock stats;
   Lock workers;
@@ -262,6 +278,7 @@ static void unlockgen (Lock *lock, const char * name) {
     unlockgen (&lock.NAME, # NAME); \
   }
 
+LOCK (base)
 LOCK (confs)
 LOCK (done)
 LOCK (leafs)
@@ -272,9 +289,11 @@ LOCK (opts)
 LOCK (parleafs)
 LOCK (parstats)
 LOCK (parunits)
+LOCK (pool)
 LOCK (simplified)
 LOCK (stats)
 LOCK (workers)
+UNLOCK (base)
 UNLOCK (confs)
 UNLOCK (done)
 UNLOCK (leafs)
@@ -285,6 +304,7 @@ UNLOCK (opts)
 UNLOCK (parleafs)
 UNLOCK (parstats)
 UNLOCK (parunits)
+UNLOCK (pool)
 UNLOCK (simplified)
 UNLOCK (stats)
 UNLOCK (workers)
@@ -389,6 +409,7 @@ static void perr (const char * fmt, ...) {
 
 static int skipnode (Node * node) {
   assert (node->state != FREE);
+  if (!node->lgl) return 0;
   if (lglinconsistent (node->lgl)) return 1;
   return 0;
 }
@@ -451,12 +472,17 @@ static void * resize (void * dummy, void * ptr,
 }
 
 static int64_t getotalmem (int explain) {
-  long long res;
+  long long res, pages, pagesize;
   FILE * p = popen ("grep MemTotal /proc/meminfo", "r");
   if (p && fscanf (p, "MemTotal: %lld kB", &res) == 1) {
     if (explain)
       msg ("%lld KB total memory according to '/proc/meminfo'", res);
     res <<= 10;
+  } else if ((pages = sysconf (_SC_PHYS_PAGES)) > 0 &&
+             (pagesize = sysconf (_SC_PAGESIZE)) > 0) {
+    res = pages * pagesize;
+    if (explain)
+      msg ("%lld KB total memory according to 'sysconf'", res >> 10);
   } else {
     res = MAXGB << 30;
     if (explain) 
@@ -610,6 +636,9 @@ static void usage () {
 "  --reduce       reduce learned clause cache for all right branches\n"
 "  --force-simp   force simplification even after light simplification\n"
 "  --force-lkhd   force full look-ahead every time\n"
+#ifndef NLGLMARCH
+"  --march        use march double look-ahead to pick split literals\n"
+#endif
 "  --no-simp      do not explicitly simplify in each round\n"
 "  --no-search    do not even search in each round\n"
 "  --no-parallel  disable additional parallel solver instance\n"
@@ -812,8 +841,17 @@ static void initroot () {
   lglsetprefix (root, "c (root) ");
 }
 
-static Node * newnode (Node * parent, int decision) {
+static void setupnode (Node * node) {
   char prefix[80];
+  sprintf (prefix, "c (%d %lld) ", node->depth, (LL) node->id);
+  lglsetprefix (node->lgl, prefix);
+  lglseterm (node->lgl, term, 0);
+  lglsetmsglock (node->lgl, lockmsg, unlockmsg, 0);
+  if (!noparallel) 
+    lglsetconsumeunits (node->lgl, consumeunits, &node->consumed);
+}
+
+static Node * newnode (Node * parent, int decision) {
   Node * res;
   locknodes ();
   NEW (res, 1);
@@ -842,11 +880,7 @@ static Node * newnode (Node * parent, int decision) {
     assert (root);
     res->lgl = lglfork (root);
   }
-  sprintf (prefix, "c (%d %lld) ", res->depth, (LL) res->id);
-  lglsetprefix (res->lgl, prefix);
-  lglseterm (res->lgl, term, 0);
-  lglsetmsglock (res->lgl, lockmsg, unlockmsg, 0);
-  if (!noparallel) lglsetconsumeunits (res->lgl, consumeunits, &res->consumed);
+  setupnode (res);
   cubemsg (res, "opened cube");
   added++;
   return res;
@@ -868,6 +902,69 @@ static void updstats (Node * node) {
   unlockstats ();
 }
 
+/*------------------------------------------------------------------------*/
+
+// A parked node gives back its solver instance and only keeps its cube,
+// which is its delta from the base instance, forked from the root like
+// the first node, but only once the first node is parked.  Every variable
+// of a later node is still active in the base instance, since nodes only
+// ever lose variables.  Unparking clones the base instance and adds the
+// cube as units.  Learned clauses and units of the node are lost, but
+// units of the parallel solver are consumed again.  To not pay for that
+// over and over, 'park' goes a quarter below the soft limit and leaves
+// nodes unparked in the last 'PARKHOLD' rounds alone.  This lets the
+// number of open nodes grow with the available memory instead of being
+// bounded by full clones.
+
+static void initbase () {
+  if (base) return;
+  msg ("forking base solver instance for parked nodes");
+  base = lglfork (root);
+  lglsetopt (base, "block", 0);
+  lglsetprefix (base, "c (base) ");
+}
+
+static void parknode (Node * node) {
+  LGL * lgl = node->lgl;
+  assert (node->state == READY);
+  assert (lgl);
+  assert (!node->res);
+  node->vars = lglnvars (lgl);
+  node->bytes = lglbytes (lgl);
+  updstats (node);
+  node->lgl = 0;
+  lglrelease (lgl);
+  if (++parked > maxparked) maxparked = parked;
+  parkings++;
+  nmsg (node, "parked (%d vars, %d MB)",
+    node->vars, (int) (node->bytes >> 20));
+}
+
+static void unparknode (Node * node) {
+  const int * p;
+  int lit;
+  assert (!node->lgl);
+  assert (base);
+  lockbase ();
+  node->lgl = lglclone (base);
+  unlockbase ();
+  node->decisions = lglgetdecs (node->lgl);
+  node->conflicts = lglgetconfs (node->lgl);
+  node->propagations = lglgetprops (node->lgl);
+  node->consumed = 0;
+  node->simplified = 0;
+  node->unparked = round;
+  setupnode (node);
+  for (p = node->cube; (lit = *p); p++)
+    lgladd (node->lgl, lit), lgladd (node->lgl, 0);
+  lockworkers ();
+  assert (parked > 0);
+  parked--;
+  unparkings++;
+  unlockworkers ();
+  nmsg (node, "unparked with %d cube units", intslen (node->cube));
+}
+
 static void delnode (Node * node) {
   Node * last;
   int lastpos;
@@ -891,13 +988,15 @@ static void delnode (Node * node) {
   nodes[lastpos] = 0;
   unlocknodes ();	// TODO why?
   lgl = node->lgl;
-  updstats (node);
+  if (lgl) updstats (node);
+  else assert (parked > 0), parked--;
   node->lgl = 0;
   if (node->cube) DEL (node->cube, intslen (node->cube) + 1);
   DEL (node, 1);
-  assert (lgl);
-  if (showstats) lglstats (lgl);
-  lglrelease (lgl);
+  if (lgl) {
+    if (showstats) lglstats (lgl);
+    lglrelease (lgl);
+  }
   deleted++;
 }
 
@@ -1124,18 +1223,6 @@ static void schedulejob (Node * node, void*(*fun)(void*),
   jmsg (job, "scheduled");
 }
 
-static void runjob (Job * job) {
-  Node * node = job->node;
-  jmsg (job, "start");
-  assert (node->state == READY);
-  node->state = job->state;
-  threads++;
-  if (pthread_create (&job->thread, 0, job->fun, node))
-    err ("failed to create thread job %d %s [%d %lld]",
-         job->pos, job->name, node->depth, node->id);
-  jmsg (job, "end");
-}
-
 static void incworkers () {
   lockworkers ();
   assert (numworkers <= maxworkers);
@@ -1162,15 +1249,86 @@ static void decworkers () {
   unlockworkers ();
 }
 
+/*------------------------------------------------------------------------*/
+
+// Jobs are run by a pool of 'maxworkers' threads started before the first
+// round.  The main thread posts all jobs of a phase at once and waits
+// until the workers have finished all of them.  Workers take the jobs in
+// the sorted order of the 'jobs' stack, which is the order in which they
+// were started by separate threads before.
+
+static void runjob (Job * job) {
+  Node * node = job->node;
+  jmsg (job, "start");
+  assert (node->state == job->state);
+  incworkers ();
+  if (!node->lgl) unparknode (node);
+  (void) job->fun (node);
+  jmsg (job, "end");
+}
+
+static void * worker (void * dummy) {
+  Job * job;
+  assert (!dummy);
+  lockpool ();
+  for (;;) {
+    while (!pool.quit && pool.next >= pool.posted) {
+      lock.pool.waited++;
+      if (pthread_cond_wait (&pool.work, &lock.pool.mutex))
+	err ("failed to wait for new jobs");
+      lock.pool.waited--;
+    }
+    if (pool.quit) break;
+    job = jobs[pool.next++];
+    unlockpool ();
+    runjob (job);
+    lockpool ();
+    if (++pool.finished == pool.posted && pthread_cond_signal (&pool.idle))
+      err ("failed to signal that all jobs are finished");
+  }
+  unlockpool ();
+  return 0;
+}
+
+static void startworkers () {
+  int i;
+  assert (!pool.num);
+  assert (maxworkers > 0);
+  NEW (pool.threads, maxworkers);
+  for (i = 0; i < maxworkers; i++) {
+    if (pthread_create (pool.threads + i, 0, worker, 0))
+      err ("failed to create worker thread %d", i);
+    pool.num++;
+    threads++;
+  }
+  msg ("started %d worker threads", pool.num);
+}
+
+static void stopworkers () {
+  int i;
+  if (!pool.num) return;
+  lockpool ();
+  assert (!pool.posted);
+  pool.quit = 1;
+  if (pthread_cond_broadcast (&pool.work))
+    err ("failed to broadcast termination to worker threads");
+  unlockpool ();
+  for (i = 0; i < pool.num; i++)
+    if (pthread_join (pool.threads[i], 0))
+      err ("failed to join worker thread %d", i);
+  DEL (pool.threads, pool.num);
+  pool.num = 0;
+}
+
 static size_t nodebytes (Node * n) {
   assert (n->state == READY);
-  assert (n->lgl);
+  if (!n->lgl) return n->bytes;
   return lglbytes (n->lgl);
 }
 
 static size_t nodevars (Node * n) {
   assert (n->state == READY);
-  assert (n->lgl);
+  if (!n->lgl) return n->vars;
   return lglnvars (n->lgl);
 }
 
@@ -1240,12 +1398,20 @@ static void runjobs () {
   int i;
   sortjobs ();
   vrb ("running %d jobs", numjobs);
+  if (!pool.num) startworkers ();
   numworkers = 0;
   for (i = 0; i < numjobs; i++) {
-    incworkers ();
     job = jobs[i];
-    runjob (job);
+    assert (job->node->state == READY);
+    job->node->state = job->state;
   }
+  lockpool ();
+  assert (!pool.posted);
+  pool.next = pool.finished = 0;
+  pool.posted = numjobs;
+  if (pthread_cond_broadcast (&pool.work))
+    err ("failed to broadcast new jobs to worker threads");
+  unlockpool ();
   vrb ("started running %d jobs", numjobs);
 }
 
@@ -1259,8 +1425,6 @@ static void joinjob (Job * job) {
   else if (node->state == SIMP) mmsg ("join simp", node);
   else if (node->state == LKHD) mmsg ("join simp", node);
   else assert (node->state == SPLIT), mmsg ("join split", node);
-  if (pthread_join (job->thread, 0))
-    err ("failed to join thread");
   node->state = READY;
   if (node->res == 20) {
     mmsg ("unsatisfiable", node);
@@ -1279,6 +1443,16 @@ static void joinjob (Job * job) {
 static void joinjobs () {
   int i;
   vrb ("joining %d jobs in round %d", numjobs, round);
+  lockpool ();
+  assert (pool.posted == numjobs);
+  while (pool.finished < pool.posted) {
+    lock.pool.waited++;
+    if (pthread_cond_wait (&pool.idle, &lock.pool.mutex))
+      err ("failed to wait for jobs to finish");
+    lock.pool.waited--;
+  }
+  pool.posted = pool.next = pool.finished = 0;
+  unlockpool ();
   for (i = 0; i < numjobs; i++) joinjob (jobs[i]);
   vrb ("finished joining %d nodes in round %d", numjobs, round);
   numjobs = 0;
@@ -1400,6 +1574,69 @@ static unsigned myrandmod (unsigned mod) {
 }
 
 /*------------------------------------------------------------------------*/
+#ifndef NLGLMARCH
+
+typedef struct MarchSplit { int lit, refuted, failed; } MarchSplit;
+
+static void marchadd (void * march, int lit) { march_add (march, lit); }
+
+static void marchleaf (void * voidptr, const int * cube, int size, int ref) {
+  MarchSplit * split = voidptr;
+  if (size != 1) return;
+  if (ref) split->refuted++, split->failed = cube[0];
+  else if (!split->lit) split->lit = cube[0];
+}
+
+static int marchusable (LGL * lgl, int lit) {
+  if (lglusable (lgl, lit)) return 1;
+  if (!lglreusable (lgl, lit)) return 0;
+  lglreuse (lgl, lit);
+  return 1;
+}
+
+// Let march cube the simplified clauses of the node to depth one and
+// return the first literal of the first cube.  A refuted branch yields a
+// failed literal, which is added as unit.  Then, as well as for satisfied
+// and refuted nodes, zero is returned and 'lglookahead' takes over.
+
+static int marchlookahead (Node * node) {
+  MarchSplit split;
+  March * march;
+  int res;
+  march = march_new ();
+  lglctrav (node->lgl, march, marchadd);
+  march_set_option (march, "d", 1);
+  memset (&split, 0, sizeof split);
+  march_set_cube_callback (march, &split, marchleaf);
+  res = march_cube (march);
+  march_delete (march);
+  lockstats ();
+  ms.calls++;
+  if (res == 20) ms.refuted++;
+  else if (split.refuted == 1) ms.failed++;
+  else if (!res && split.lit) ms.splits++;
+  unlockstats ();
+  if (res == 20) {
+    nmsg (node, "march refuted node");
+    lgladd (node->lgl, 0);
+    return 0;
+  }
+  if (res) {
+    nmsg (node, "march returned %d", res);
+    return 0;
+  }
+  if (split.refuted == 1) {
+    if (!marchusable (node->lgl, split.failed)) return 0;
+    nmsg (node, "march failed literal %d", split.failed);
+    lgladd (node->lgl, -split.failed);
+    lgladd (node->lgl, 0);
+    return 0;
+  }
+  if (!split.lit || !marchusable (node->lgl, split.lit)) return 0;
+  return split.lit;
+}
+
+#endif
 
 static void * lookaheadnode (void * voidptr) {
   int oldvars, newvars, redpermille, oldjwhred;
@@ -1408,7 +1645,10 @@ static void * lookaheadnode (void * voidptr) {
   assert (node->state == LKHD);
   oldjwhred = lglgetopt (node->lgl, "jwhred");
   oldvars = lglnvars (node->lgl);
-  if (!stoplkhd) {
+  if (!stoplkhd && marchlkhd) {
+    nmsg (node, "march double lookahead");
+    lglsetopt (node->lgl, "lkhd", 2);
+  } else if (!stoplkhd) {
     nmsg (node, "full tree-based lookahead");
     lglsetopt (node->lgl, "lkhd", 2);
   } else if (locslkhd) {
@@ -1419,7 +1659,11 @@ static void * lookaheadnode (void * voidptr) {
     lglsetopt (node->lgl, "lkhd", 1);	// JWH
     lglsetopt (node->lgl, "jwhred", 2);
   }
-  node->lookahead = lglookahead (node->lgl);
+  node->lookahead = 0;
+#ifndef NLGLMARCH
+  if (!stoplkhd && marchlkhd) node->lookahead = marchlookahead (node);
+#endif
+  if (!node->lookahead) node->lookahead = lglookahead (node->lgl);
   lglsetopt (node->lgl, "jwhred", oldjwhred);
   nmsg (node, "lookahead literal %d", node->lookahead);
   newvars = lglnvars (node->lgl);
@@ -1498,6 +1742,7 @@ static void lookahead () {
   for (i = firstlkhd (); !donelkhd (i); i = nextlkhd (i)) {
     node = nodes[i];
     expected = nodebytes (node);
+    if (!node->lgl) expected *= 2;	// unparking adds another copy
     nmsg (node, "cloning might add %d MB", bytes2mb (expected));
     nmsg (node, "plus already scheduled %d MB gives %d MB",
 	  bytes2mb (sumbytes), bytes2mb (expected + sumbytes));
@@ -1590,15 +1835,15 @@ static void varspan (int * minvarsptr, int * actvarsptr, int * maxvarsptr) {
   sortnodes ("varspan", incmpnodes);
   for (i = 0; i < numnodes; i++)
     if (!skipnode (nodes[i])) break;
-  minvars = (i < numnodes) ? lglnvars (nodes[i]->lgl) : 0;
+  minvars = (i < numnodes) ? nodevars (nodes[i]) : 0;
   for (i = numnodes-1; i >= 0; i--)
     if (!skipnode (nodes[i])) break;
-  maxvars = (i < 0) ? 0 : lglnvars (nodes[i]->lgl);
+  maxvars = (i < 0) ? 0 : nodevars (nodes[i]);
   j = 0;
   for (i = 0; i < numnodes; i++)
     if (!skipnode (nodes[i]) && ++j == maxactive)
       break;
-  actvars = (j == maxactive) ? lglnvars (nodes[i]->lgl) : maxvars;
+  actvars = (j == maxactive) ? nodevars (nodes[i]) : maxvars;
   *minvarsptr = minvars;
   *actvarsptr = actvars;
   *maxvarsptr = maxvars;
@@ -1786,7 +2031,7 @@ static int flush () {
     assert (node);
     assert (node->state == READY);
     if (node->res == 20) enqnewleafromnode (node), delnode (node);
-    else if (lglinconsistent (node->lgl)) {
+    else if (skipnode (node)) {
       mmsg ("inconsistent", node);
       enqnewleafromnode (node), delnode (node);
     } else i++;
@@ -1806,6 +2051,39 @@ static int flush () {
 
 /*------------------------------------------------------------------------*/
 
+// Every phase works on at most 'maxactive * FULLSIMP' nodes in the order
+// of 'incmpnodes'.  If the soft memory limit is exceeded, nodes behind
+// those are parked, starting with the largest ones, until the memory is
+// a quarter below the limit.
+
+static void park () {
+  int i, l, before = parked;
+  size_t bytes, target;
+  Node * node;
+  lockmem ();
+  bytes = currentbytes;
+  unlockmem ();
+  if (!softlimbytes || bytes <= softlimbytes) return;
+  LOG ("park");
+  target = softlimbytes - softlimbytes/4;
+  sortnodes ("park", incmpnodes);
+  l = maxactive * FULLSIMP;
+  for (i = numnodes - 1; i >= l && bytes > target; i--) {
+    node = nodes[i];
+    assert (node);
+    if (!node->lgl || skipnode (node)) continue;
+    if (node->unparked && round - node->unparked < PARKHOLD) continue;
+    bytes -= nodebytes (node);
+    initbase ();
+    parknode (node);
+  }
+  if (parked > before)
+    msg (" %d parked %d nodes to stay below %d MB, %d parked in total",
+      round, parked - before, bytes2mb (softlimbytes), parked);
+}
+
+/*------------------------------------------------------------------------*/
+
 static void mergestats () {
   Node * node;
   int i;
@@ -1834,6 +2112,8 @@ static void stats () {
       avg (sumclims, inclims + declims + 1),
       (LL) inclims, (LL) declims,
       (LL) forcedclims, (LL) sumsimplified);
+  msg ("%lld parked, %lld unparked nodes, %d parked (%d max)",
+      (LL) parkings, (LL) unparkings, parked, maxparked);
   msg ("");
   msg ("%.2f wall clock time, %.2f process time", w, t);
   msg ("%.0f%% utilization for %d%s worker threads on %d cores",
@@ -1861,6 +2141,9 @@ static void stats () {
   msg ("");
   msg ("%7d %3.0f%% lookaheads      %7.2f seconds %4.0f%%",
     js.lkhd, pcnt (js.lkhd, js.cnt), wct.lkhd, pcnt (wct.lkhd,w));
+  if (marchlkhd)
+    msg ("%7lld march lookaheads, %lld splits, %lld failed, %lld refuted",
+      (LL) ms.calls, (LL) ms.splits, (LL) ms.failed, (LL) ms.refuted);
   msg ("%7d %3.0f%% splits          %7.2f seconds %4.0f%%",
     js.split, pcnt (js.split, js.cnt), wct.split, pcnt (wct.split,w));
   msg ("%7d %3.0f%% simplifications %7.2f seconds %4.0f%%",
@@ -1901,7 +2184,7 @@ static int finish () {
     node = nodes[i];
     assert (node);
     assert (node->state == READY);
-    assert (node->lgl);
+    assert (node->lgl || !node->res);
     if (node->res == 10) break;
   }
   if (i < numnodes) {
@@ -1935,8 +2218,7 @@ static int finish () {
       assert (node);
       assert (node->state == READY);
       assert (!node->res);
-      assert (node->lgl);
-      assert (!lglinconsistent (node->lgl));
+      assert (!skipnode (node));
     }
 #endif
     vrb ("no satisfiable node found but still %d nodes left in round %d", 
@@ -1993,6 +2275,7 @@ static void setsighandlers () {
 static void init () {
   wct.epoch = currentime ();
 
+  pthread_mutex_init (&lock.base.mutex, 0);
   pthread_mutex_init (&lock.confs.mutex, 0);
   pthread_mutex_init (&lock.done.mutex, 0);
   pthread_mutex_init (&lock.leafs.mutex, 0);
@@ -2002,11 +2285,14 @@ static void init () {
   pthread_mutex_init (&lock.parleafs.mutex, 0);
   pthread_mutex_init (&lock.parstats.mutex, 0);
   pthread_mutex_init (&lock.parunits.mutex, 0);
+  pthread_mutex_init (&lock.pool.mutex, 0);
   pthread_mutex_init (&lock.simplified.mutex, 0);
   pthread_mutex_init (&lock.stats.mutex, 0);
   pthread_mutex_init (&lock.workers.mutex, 0);
 
   pthread_cond_init (&workerscond, 0);
+  pthread_cond_init (&pool.work, 0);
+  pthread_cond_init (&pool.idle, 0);
 }
 
 static int has (const char * str, const char * suffix) {
@@ -2087,6 +2373,13 @@ int main (int argc, char ** argv) {
 	err ("invalid number in '%s'", argv[i]);
     } else if (!strcmp (argv[i], "--reduce")) reducecache = 1;
     else if (!strcmp (argv[i], "--locslkhd")) locslkhd = 1;
+    else if (!strcmp (argv[i], "--march")) {
+#ifndef NLGLMARCH
+      marchlkhd = 1;
+#else
+      err ("compiled without libmarch (configure with '--march')");
+#endif
+    }
     else if (!strcmp (argv[i], "--force-simp")) forcesimp = 1;
     else if (!strcmp (argv[i], "--no-force-lkhd")) forcelkhd = 0;
     else if (!strcmp (argv[i], "--no-simp")) nosimp = 1;
@@ -2330,6 +2623,7 @@ int main (int argc, char ** argv) {
 	lookahead ();
 	split ();
 	if ((res = flush ())) break;
+	park ();
 	report ();
 	updateclim ();
 	search ();
@@ -2337,11 +2631,13 @@ int main (int argc, char ** argv) {
     }
 
     if (!noparallel) joinparallel (), releaseparallel ();
+    stopworkers ();
 
     msg ("");
     msg ("cleaning up after %d rounds", round);
     while (numnodes) delnode (nodes[0]);
     while ((leaf = deqleaf ())) deleaf (leaf);
+    if (base) lglrelease (base);
   }
 
   lglrelease (root);
@@ -7,6 +7,22 @@
 #ifndef __COMMON_H__
 #define __COMMON_H__
 
+/* Global state.  libmarch (compiled with -DMARCH_LIB) runs every context
+   on its own thread, so there all state is thread-local.  The variables
+   declared in the headers are defined in march.c (MARCH_GLOBALS). */
+
+#ifdef MARCH_LIB
+  #define TLS			__thread
+#else
+  #define TLS
+#endif
+
+#ifdef MARCH_GLOBALS
+  #define GLOBAL		TLS
+#else
+  #define GLOBAL		extern TLS
+#endif
+
 /*
         --------------------------------------------------------------------------------------------------------------
         -------------------------------------------------[ defines ]--------------------------------------------------
@@ -77,6 +93,7 @@
 #define GAH			  1  // on
 #define WFR			  1  // on
 #define IMP			  1  // on
+#define GAUSS			  0  // off
 
 #define H_MIN			8.0
 #define H_MAX		      550.0
@@ -314,7 +331,7 @@ struct treeNode {
         rstackp--;      \
         restore_implication_arrays( *rstackp ); \
 	}
-int *clause_red_depth;
+GLOBAL int *clause_red_depth;
 
 #define POP_BACKTRACK_LOOKAHEAD_STACK \
 	{ \
@@ -365,132 +382,139 @@ int *clause_red_depth;
         --------------------------------------------------------------------------------------------------------------
 */
 
-char cubesFile[1024];
-char initFile[1024];
+GLOBAL char cubesFile[1024];
+GLOBAL char initFile[1024];
 
-unsigned int seed, hardLimit;
-int *trail, trailSize;
+GLOBAL unsigned int seed, hardLimit;
+GLOBAL int *trail, trailSize;
 
-int addIMP, addWFR, gah;
+GLOBAL int addIMP, addWFR, gah, gauss;
+GLOBAL int nrofhints;
 
-int *clause_reduction;
-int *clause_SAT_flag;
-int **big_to_binary, *btb_size, *big_global_table;
+GLOBAL int *clause_reduction;
+GLOBAL int *clause_SAT_flag;
+GLOBAL int **big_to_binary, *btb_size, *big_global_table;
 
 #ifdef CUBE
-int conflicts;
-int assigned_th;
-double sum_th, factor_th;
-double free_th;
-int part_free;
-int nr_cubes;
-unsigned int cut_depth, cut_var, dynamic;
+GLOBAL int conflicts;
+GLOBAL int assigned_th;
+GLOBAL double sum_th, factor_th;
+GLOBAL double free_th;
+GLOBAL int part_free;
+GLOBAL int nr_cubes;
+GLOBAL unsigned int cut_depth, cut_var, dynamic;
 #endif
 
-int mode, sharp_mode, quiet_mode;
+GLOBAL int mode, sharp_mode, quiet_mode;
+
+GLOBAL char *cubeFile, *learnFile;
 
-char *cubeFile, *learnFile;
+/* quiet_mode 2 (libmarch) prints nothing: cubes go to 'cube_callback' and a
+   satisfying assignment to 'solution_model' */
+GLOBAL void (*cube_callback) (void *state, const int *cube, int size, int refuted);
+GLOBAL void *cube_state;
+GLOBAL int *solution_model;
 
-int cweight;
-double downexp, fraction;
-unsigned int cubeLimit;
+GLOBAL int cweight;
+GLOBAL double downexp, fraction;
+GLOBAL unsigned int cubeLimit;
 
 #ifdef SUPER_LINEAR
-int subtree_size;
+GLOBAL int subtree_size;
 #endif
 
-unsigned int sl_iter, dl_iter;
-float h_min, h_max, h_bin, h_dec;
+GLOBAL unsigned int sl_iter, dl_iter;
+GLOBAL float h_min, h_max, h_bin, h_dec;
 
-float *hiRank, *clause_weight, *hiSum;
-int kSAT_flag;
-int dist_acc_flag;
+GLOBAL float *hiRank, *clause_weight, *hiSum;
+GLOBAL int kSAT_flag;
+GLOBAL int dist_acc_flag;
 
 // used for big clauses and resolvent_look
-int *literal_list, **clause_list, *clause_length, **clause_set, *clause_database, *big_occ;
-int nrofbigclauses;
+GLOBAL int *literal_list, **clause_list, *clause_length, **clause_set, *clause_database, *big_occ;
+GLOBAL int nrofbigclauses;
 
-int target_rights, current_rights;
+GLOBAL int target_rights, current_rights;
 #ifdef CUT_OFF
-int *bins;
+GLOBAL int *bins;
 #endif
 
-int *decisions;
-int jump_depth;
+GLOBAL int *decisions;
+GLOBAL int jump_depth;
 
-int percent;
-float *Rank;
-int Rank_trigger;
-float *diff, *_diff, *size_diff, *diff_tmp, *_diff_tmp, **diff_depth, *diff_table;
-int initial_freevars;
+GLOBAL int percent;
+GLOBAL float *Rank;
+GLOBAL int Rank_trigger;
+GLOBAL float *diff, *_diff, *size_diff, *diff_tmp, *_diff_tmp, **diff_depth, *diff_table;
+GLOBAL int initial_freevars;
 
-double percentage_forced;
+GLOBAL double percentage_forced;
 
 #ifdef COUNT_SAT
-  int count_sat;
+  GLOBAL int count_sat;
 #endif
 
-int *dpll_fixstackp, *end_fixstackp;
+GLOBAL int *dpll_fixstackp, *end_fixstackp;
 
-long long dl_possibility_counter, dl_actual_counter;
+GLOBAL long long dl_possibility_counter, dl_actual_counter;
 
-int *TernaryImpReduction;
+GLOBAL int *TernaryImpReduction;
 
-int tree_elements;
+GLOBAL int tree_elements;
 
 /* doublelook statistics */
-float DL_trigger, DL_trigger_sum;
-long long doublelook_count, doublelook_failed;
+GLOBAL float DL_trigger, DL_trigger_sum;
+GLOBAL long long doublelook_count, doublelook_failed;
 
-int bin_sat, bin_unsat;
-int non_tautological_equivalences;
+GLOBAL int bin_sat, bin_unsat;
+GLOBAL int non_tautological_equivalences;
 
 /* solver AND lookahead AND pre-selection */
-int **TernaryImp, *TernaryImpSize, *tmpTernaryImpSize;
-int *lookaheadArray, lookaheadArrayLength;
-int *bImp_satisfied;
-int *bImp_start;
+GLOBAL int **TernaryImp, *TernaryImpSize, *tmpTernaryImpSize;
+GLOBAL int *lookaheadArray, lookaheadArrayLength;
+GLOBAL int *bImp_satisfied;
+GLOBAL int *bImp_start;
 
-double *lengthWeight;
+GLOBAL double *lengthWeight;
 
-int *freevarsArray;
+GLOBAL int *freevarsArray;
 
 /* statistics */
-int nrofvars, nrofclauses, nrofceq, nroforigvars;
-int original_nrofvars, original_nrofclauses;
-int freevars, activevars, depth;
+GLOBAL int nrofvars, nrofclauses, nrofceq, nroforigvars;
+GLOBAL int original_nrofvars, original_nrofclauses;
+GLOBAL int freevars, activevars, depth;
 
-int **Ceq, **Veq, **VeqLUT, *CeqValues, *CeqSizes;
-int *CeqStamps;
-int *CeqDepends, *VeqDepends;
-int *VeqLength;
-int *eq_found;
+GLOBAL int **Ceq, **Veq, **VeqLUT, *CeqValues, *CeqSizes;
+GLOBAL int *CeqStamps;
+GLOBAL int *CeqDepends, *VeqDepends;
+GLOBAL int *VeqLength;
+GLOBAL int *eq_found;
 
 /* data structure */
-tstamp current_node_stamp;
-tstamp *timeAssignments, *node_stamps;
-int **Cv, *Clength, **BinaryImp, *BinaryImpLength;
+GLOBAL tstamp current_node_stamp;
+GLOBAL tstamp *timeAssignments, *node_stamps;
+GLOBAL int **Cv, *Clength, **BinaryImp, *BinaryImpLength;
 
 /* various stacks */
-int *rstack, *rstackp, rstackSize;
-int *look_fixstack, *look_fixstackp, look_fixstackSize;
-int *look_resstack, *look_resstackp, look_resstackSize;
-int *subsumestack,  *subsumestackp,  subsumestackSize;
-int *bieqstack,  *bieqstackp,  bieqstackSize;
-int *impstack,   *impstackp,   impstackSize;
+GLOBAL int *rstack, *rstackp, rstackSize;
+GLOBAL int *look_fixstack, *look_fixstackp, look_fixstackSize;
+GLOBAL int *look_resstack, *look_resstackp, look_resstackSize;
+GLOBAL int *subsumestack,  *subsumestackp,  subsumestackSize;
+GLOBAL int *bieqstack,  *bieqstackp,  bieqstackSize;
+GLOBAL int *impstack,   *impstackp,   impstackSize;
 
 /* lookahead */
-int *forced_literal_array, forced_literals;
-tstamp currentTimeStamp;
-int iterCounter;
+GLOBAL int *forced_literal_array, forced_literals;
+GLOBAL tstamp currentTimeStamp;
+GLOBAL int iterCounter;
 
-struct treeNode *treeArray;
+GLOBAL struct treeNode *treeArray;
 
 /* accounting */
-int nodeCount;
-long long lookAheadCount;
-int unitResolveCount;
-int necessary_assignments;
-int lookDead, mainDead;
+GLOBAL int nodeCount;
+GLOBAL long long lookAheadCount;
+GLOBAL int unitResolveCount;
+GLOBAL int necessary_assignments;
+GLOBAL int lookDead, mainDead;
 
 #endif
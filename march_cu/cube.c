@@ -11,17 +11,21 @@
 
 #include "cube.h"
 #include "common.h"
+#include "lookahead.h"
 
-FILE *cubes;
+TLS FILE *cubes;
 
-int *cubeTrail;
-int nrofDnodes;
-int Dnodes_size;
-struct Dnode *Dnodes;
-int _nr_cubes;
+TLS int *cubeTrail;
+TLS int nrofDnodes;
+TLS int Dnodes_size;
+TLS struct Dnode *Dnodes;
+TLS int _nr_cubes;
 
-int num_refuted, num_cubes;
-long long sum_refuted, sum_cubes;
+/* every hint set is its size followed by its literals */
+TLS int *hintPool, hintPoolSize, hintPoolAlloc, lastHints;
+
+TLS int num_refuted, num_cubes;
+TLS long long sum_refuted, sum_cubes;
 
 int getNodes () {
   return num_cubes + num_refuted; }
@@ -41,6 +45,16 @@ void Dnode_setWeight (int index, int weight) {
 void Dnode_setDecision (int index, int decision) {
   Dnodes[ index ].decision = decision; }
 
+void Dnode_setHints (int index, int branch) {
+  if (hintPoolSize + nrofhints + 1 > hintPoolAlloc) {
+    hintPoolAlloc = 2 * hintPoolAlloc + nrofhints + 1;
+    hintPool = (int*) realloc (hintPool, sizeof(int) * hintPoolAlloc); }
+  int size = get_hint_literals (hintPool + hintPoolSize + 1, nrofhints, NR(branch));
+  if (size == 0) return;
+  hintPool[ hintPoolSize ] = size;
+  Dnodes[ index ].hints = hintPoolSize + 1;
+  hintPoolSize += size + 1; }
+
 void Dnode_close (int index) {
   if ((Dnodes[Dnodes[index].left ].type == REFUTED_DNODE) &&
       (Dnodes[Dnodes[index].right].type == REFUTED_DNODE))
@@ -66,7 +80,8 @@ void Dnode_init (int index) {
       Dnodes[i].left     = 0;
       Dnodes[i].right    = 0;
       Dnodes[i].decision = 0;
-      Dnodes[i].type     = 0; }
+      Dnodes[i].type     = 0;
+      Dnodes[i].hints    = 0; }
     Dnodes_size *= 2; } }
 
 void init_assumptions () {
@@ -79,7 +94,16 @@ void init_assumptions () {
     Dnodes[i].left     = 0;
     Dnodes[i].right    = 0;
     Dnodes[i].decision = 0;
-    Dnodes[i].type     = 0; } }
+    Dnodes[i].type     = 0;
+    Dnodes[i].hints    = 0; }
+  hintPoolSize = 0; }
+
+void dispose_assumptions () {
+  free (Dnodes);
+  Dnodes = NULL;
+  free (hintPool);
+  hintPool = NULL;
+  hintPoolAlloc = 0; }
 
 void printWeights (struct Dnode Dnode) {
   if (Dnode.type == REFUTED_DNODE) {
@@ -92,10 +116,22 @@ void printWeights (struct Dnode Dnode) {
     printWeights (Dnodes[Dnode.left ]);
     printWeights (Dnodes[Dnode.right]); } }
 
-void printDecisionNode (struct Dnode Dnode, int depth, int discrepancies, int target) {
+/* 'hints' are those of the deepest node with hints on the path, an "h" line
+   is emitted only when they differ from the hints of the previous cube */
+void printDecisionNode (struct Dnode Dnode, int depth, int discrepancies, int target, int hints) {
+  if (Dnode.hints) hints = Dnode.hints;
   if (Dnode.type != INTERNAL_DNODE) {
     if ((target == -1) || (discrepancies == target)) {
       _nr_cubes++;
+      if (cube_callback) {
+        cube_callback (cube_state, cubeTrail, depth, Dnode.type == REFUTED_DNODE);
+        return; }
+      if (hints != lastHints) {
+        fprintf (cubes, "h ");
+        int i; for (i = 0; hints && i < hintPool[ hints - 1 ]; i++)
+          fprintf (cubes, "%d ", hintPool[ hints + i ]);
+        fprintf (cubes, "0\n");
+        lastHints = hints; }
       fprintf (cubes, "a ");
       int i; for (i = 0; i < depth; i++)
 	fprintf (cubes, "%d ", cubeTrail[ i ] );
@@ -104,17 +140,20 @@ void printDecisionNode (struct Dnode Dnode, int depth, int discrepancies, int ta
 
 #ifndef FLIP_ASSUMPTIONS
   cubeTrail[depth] = Dnodes[Dnode.left].decision;
-  printDecisionNode (Dnodes[Dnode.left ], depth+1, discrepancies+1, target);
+  printDecisionNode (Dnodes[Dnode.left ], depth+1, discrepancies+1, target, hints);
 #endif
   cubeTrail[depth] = Dnodes[Dnode.right].decision;
-  printDecisionNode (Dnodes[Dnode.right], depth+1, discrepancies, target);
+  printDecisionNode (Dnodes[Dnode.right], depth+1, discrepancies, target, hints);
 #ifdef FLIP_ASSUMPTIONS
   cubeTrail[depth] = Dnodes[Dnode.left].decision;
-  printDecisionNode (Dnodes[Dnode.left ], depth+1, discrepancies+1, target);
+  printDecisionNode (Dnodes[Dnode.left ], depth+1, discrepancies+1, target, hints);
 #endif
 }
 
 void printUNSAT () {
+  if (cube_callback) {
+    cube_callback (cube_state, NULL, 0, 1);
+    return; }
   if (quiet_mode) cubes = stdout;
   else            cubes = fopen (cubesFile, "w");
   if (quiet_mode == 0)
@@ -153,13 +192,15 @@ void printDecisionTree () {
   cubeTrail = (int*) malloc(sizeof(int) * nrofvars);
   for (i = 0; i < nrofvars; i++) cubeTrail[i] = 0;
 
-  if (quiet_mode) cubes = stdout;
+  if (cube_callback) cubes = NULL;
+  else if (quiet_mode) cubes = stdout;
   else            cubes = fopen (cubesFile, "w");
 
   if (quiet_mode == 0)
     printf("c print learnt clauses and cubes\n");
 
   _nr_cubes   = 0;
+  lastHints   = 0;
   num_refuted = 0;
   num_cubes   = 0;
   sum_refuted = 0;
@@ -176,10 +217,10 @@ void printDecisionTree () {
   if (discrepancy_search) {
     int target = 0;
     do {
-      printDecisionNode (Dnodes[1], 0, 0, target++); }
+      printDecisionNode (Dnodes[1], 0, 0, target++, 0); }
     while (_nr_cubes != nr_cubes); }
-    else printDecisionNode (Dnodes[1], 0, 0, -1);
-  if (quiet_mode == 0)
+    else printDecisionNode (Dnodes[1], 0, 0, -1, 0);
+  if (cubes && quiet_mode == 0)
     fclose (cubes);
   free (cubeTrail);
 }
@@ -16,13 +16,16 @@ struct Dnode {
   int decision;
   int type;
   int weight;
+  int hints;     // 1 + offset in the hint pool, 0 if none
 };
 
 void init_assumptions ();
+void dispose_assumptions ();
 
 void Dnode_setDecision (int index, int decision);
 void Dnode_setType     (int index, int type    );
 void Dnode_setWeight   (int index, int weight  );
+void Dnode_setHints    (int index, int branch  );
 
 int  Dnode_new   (         );
 int  Dnode_left  (int index);
@@ -31,6 +34,6 @@ void Dnode_init  (int index);
 void Dnode_close (int index);
 
 int  getNodes ();
-void printDecisionNode (struct Dnode Dnode, int depth, int dis, int max);
+void printDecisionNode (struct Dnode Dnode, int depth, int dis, int max, int hints);
 void printUNSAT ();
 void printDecisionTree ();
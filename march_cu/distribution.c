@@ -19,10 +19,10 @@
 #define JUMP_DEPTH			999
 
 #ifdef DISTRIBUTION
-int *recorded_literal_array, recorded_literals;
-unsigned int record_array_size, recorded_nodes = 0;
-int *forced_array, forced_array_size, forced_elements;
-int bin_mask = 0, current_bin = 0;
+TLS int *recorded_literal_array, recorded_literals;
+TLS unsigned int record_array_size, recorded_nodes = 0;
+TLS int *forced_array, forced_array_size, forced_elements;
+TLS int bin_mask = 0, current_bin = 0;
 
 void fill_distribution_bins();
 
@@ -178,7 +178,6 @@ void print_records()
 	 the procedure fill distribution_bin create a mapping
 	 for a fixed JUMP DEPTH given a explicit jumping strategy
 *************************/
-int current_rights = 0;
 
 void fill_distribution_bins_rec()
 {
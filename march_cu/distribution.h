@@ -15,8 +15,8 @@ struct record {
     int UNSAT_flag;
 };
 
-unsigned int current_record;
-struct record *records;
+GLOBAL unsigned int current_record;
+GLOBAL struct record *records;
 
 void init_direction();
 
@@ -12,13 +12,13 @@
 #include "doublelook.h"
 #include "lookahead.h"
 
-int *doublelook_fixstackp;
-int *doublelook_resstackp;
+TLS int *doublelook_fixstackp;
+TLS int *doublelook_resstackp;
 
-int DL_MAX_Stamp;
-int DL_lastChanged;
+TLS int DL_MAX_Stamp;
+TLS int DL_lastChanged;
 
-int (*DL_IUP        ) (int *local_fixstackp);
+TLS int (*DL_IUP        ) (int *local_fixstackp);
 int DL_IUP_w_eq_3SAT  (int *local_fixstackp);
 int DL_IUP_w_eq_kSAT  (int *local_fixstackp);
 int DL_IUP_wo_eq_3SAT (int *local_fixstackp);
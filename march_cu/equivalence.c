@@ -42,12 +42,14 @@ int equivalence_reasoning () {
 
 void init_equivalence () {
   int i;
-
-        Ceq        = (int**) malloc( sizeof( int* ) * 2 * nrofclauses );
-        CeqSizes   = (int*)  malloc( sizeof( int  ) * 2 * nrofclauses );
-        CeqStamps  = (int*)  malloc( sizeof( int  ) * 2 * nrofclauses );
-        CeqValues  = (int*)  malloc( sizeof( int  ) * 2 * nrofclauses );
-        CeqDepends = (int*)  malloc( sizeof( int  ) * 2 * nrofclauses );
+  /* gauss_elimination () can add an equivalence per variable */
+  int ceqSize = 2 * nrofclauses + (gauss ? nrofvars : 0);
+
+        Ceq        = (int**) malloc( sizeof( int* ) * ceqSize );
+        CeqSizes   = (int*)  malloc( sizeof( int  ) * ceqSize );
+        CeqStamps  = (int*)  malloc( sizeof( int  ) * ceqSize );
+        CeqValues  = (int*)  malloc( sizeof( int  ) * ceqSize );
+        CeqDepends = (int*)  malloc( sizeof( int  ) * ceqSize );
 	Veq        = (int**) malloc( sizeof( int* ) * ( nrofvars + 1 ) );
         VeqLUT     = (int**) malloc( sizeof( int* ) * ( nrofvars + 1 ) );
         VeqLength  = (int*)  malloc( sizeof( int  ) * ( nrofvars + 1 ) );
@@ -61,7 +63,7 @@ void init_equivalence () {
             VeqLUT[ i ][ 0 ] = 1;
         }
 
-        for( i = 0; i < 2 * nrofclauses; i++ ) CeqDepends[ i ] = 0;
+        for( i = 0; i < ceqSize; i++ ) CeqDepends[ i ] = 0;
 
 	eq_found = (int*) malloc( sizeof(int) * original_nrofvars );
 
@@ -84,6 +86,18 @@ void dispose_equivalence()
         FREE( CeqValues  );
         FREE( CeqDepends );
         FREE( VeqLength  );
+        FREE( eq_found   );
+
+	if( Veq != NULL )
+	{
+	    for( i = 0; i <= original_nrofvars; i++ )
+	    {
+		free( Veq   [ i ] );
+		free( VeqLUT[ i ] );
+	    }
+	    FREE( Veq    );
+	    FREE( VeqLUT );
+	}
 }
 
 void dispose_preprocessor_eq()
@@ -906,7 +920,7 @@ void printNrofEq()
 
 	//printCeq();
 
-	free( eq_found );
+	FREE( eq_found );
 }
 
 void check_integrety()
@@ -0,0 +1,209 @@
+/*
+   MARCH Satisfiability Solver
+   Copyright (C) 2001-2005 M.J.H. Heule, J.E. van Zwieten, and M. Dufour.
+   Copyright (C) 2005-2017 M.J.H. Heule. [marijn@heule.nl]
+
+   This file contains the Gaussian elimination of the preprocessor (-gauss).
+   XOR constraints are recognized as complete sets of clauses over the same
+   variables, split into independent components, and every component is
+   reduced as a bit-packed matrix over GF(2).  Rows with one variable become
+   unit clauses and rows with two variables become the binary clauses
+   (a, b) and (-a, -b), which the parser then turns into an equivalence
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "gauss.h"
+#include "common.h"
+
+#define GS_MAX_LENGTH	6	  // longest recognized XOR (32 clauses)
+#define GS_MAX_WORK	(1 << 28) // word operations allowed per component
+
+TLS int gs_calls, gs_xors, gs_units, gs_equivalences, gs_skipped;
+TLS int *gs_parent, *gs_index;
+
+int gs_find (int v) {
+  while (gs_parent[v] != v) v = gs_parent[v] = gs_parent[gs_parent[v]];
+  return v; }
+
+int gs_same_vars (int a, int b) {
+  int i; for (i = 0; i < Clength[a]; i++)
+    if (NR(Cv[a][i]) != NR(Cv[b][i])) return 0;
+  return 1; }
+
+int gs_known (int x, int y, int value) {
+  int i; for (i = 1; i < Veq[x][0]; i++) {
+    int ceqidx = Veq[x][i];
+    if ((CeqSizes[ceqidx] == 2) && (CeqValues[ceqidx] == value) &&
+        (Ceq[ceqidx][VeqLUT[x][i] ^ 1] == y)) return 1; }
+  return 0; }
+
+/* the rows of the pivot and the target agree on all words before 'from' */
+void gs_add_row (uint64_t *row, const uint64_t *pivot, int from, int words) {
+  int i; for (i = from; i < words; i++) row[i] ^= pivot[i]; }
+
+void gs_push (int **facts, int *nrofFacts, int a, int b) {
+  *facts = (int*) realloc (*facts, sizeof(int) * 2 * (*nrofFacts + 1));
+  (*facts)[2 * *nrofFacts    ] = a;
+  (*facts)[2 * *nrofFacts + 1] = b;
+  (*nrofFacts)++; }
+
+/* eliminates the XORs 'xors' (start offsets into 'xv') of one component;
+   returns UNSAT if the rows contain the contradiction 0 = 1 */
+int gs_component (int *xors, int m, int *xv, int *xrhs, int *vars, int n,
+                  int **facts, int *nrofFacts) {
+  int i, j, r, col, words = (n + 64) / 64;
+
+  if ((double) m * m * words > GS_MAX_WORK) { gs_skipped++; return SAT; }
+
+  for (i = 0; i < n; i++) gs_index[ vars[i] ] = i;
+
+  uint64_t *matrix = (uint64_t*) calloc ((size_t) m * words, sizeof(uint64_t));
+  for (i = 0; i < m; i++) {
+    uint64_t *row = matrix + (size_t) i * words;
+    for (j = xors[i]; xv[j]; j++) row[ gs_index[ xv[j] ] / 64 ] ^= 1ULL << (gs_index[ xv[j] ] % 64);
+    if (xrhs[i]) row[ n / 64 ] ^= 1ULL << (n % 64); }
+
+  for (r = col = 0; col < n && r < m; col++) {
+    uint64_t bit = 1ULL << (col % 64);
+    int w = col / 64;
+    for (i = r; i < m && !(matrix[(size_t) i * words + w] & bit); i++);
+    if (i == m) continue;
+    if (i != r)
+      for (j = w; j < words; j++) {
+        uint64_t tmp = matrix[(size_t) i * words + j];
+        matrix[(size_t) i * words + j] = matrix[(size_t) r * words + j];
+        matrix[(size_t) r * words + j] = tmp; }
+    for (i = 0; i < m; i++)
+      if (i != r && (matrix[(size_t) i * words + w] & bit))
+        gs_add_row (matrix + (size_t) i * words, matrix + (size_t) r * words, w, words);
+    r++; }
+
+  int result = SAT;
+  for (i = 0; i < m && result == SAT; i++) {
+    uint64_t *row = matrix + (size_t) i * words;
+    int rhs = (row[ n / 64 ] >> (n % 64)) & 1, count = 0, lits[2];
+    row[ n / 64 ] &= ~(1ULL << (n % 64));
+    for (j = 0; j < words && count <= 2; j++) {
+      uint64_t word = row[j];
+      while (word && count <= 2) {
+        int b = __builtin_ctzll (word);
+        if (count < 2) lits[count] = vars[ 64 * j + b ];
+        count++;
+        word &= word - 1; } }
+
+    if (count == 0 && rhs) result = UNSAT;
+    else if (count == 1) {
+      gs_push (facts, nrofFacts, rhs ? lits[0] : -lits[0], 0);
+      gs_units++; }
+    else if (count == 2 && gs_equivalences < nrofvars &&   // see init_equivalence
+             !gs_known (lits[0], lits[1], rhs ? -1 : 1)) {
+      gs_push (facts, nrofFacts, lits[0], rhs ? lits[1] : -lits[1]);
+      gs_equivalences++; } }
+
+  free (matrix);
+  return result; }
+
+int gauss_elimination (int *facts) {
+  int i, j, c, nrofXors = 0, xvSize = 0;
+  int *xstart = NULL, *xrhs = NULL, *xv = NULL;
+
+  gs_calls++;
+
+  /* after sort_clauses all clauses over the same variables are adjacent */
+  for (i = 0; i < nrofclauses; i = j) {
+    int k = Clength[i];
+    for (j = i + 1; j < nrofclauses && Clength[j] == k && gs_same_vars (i, j); j++);
+    if (k < 3 || k > GS_MAX_LENGTH || j - i < (1 << (k - 1))) continue;
+
+    int count[2] = { 0, 0 };
+    for (c = i; c < j; c++) {
+      int parity = 0, l;
+      for (l = 0; l < k; l++) parity ^= (Cv[c][l] < 0);
+      count[ parity ]++; }
+
+    int p; for (p = 0; p < 2; p++)
+      if (count[p] == (1 << (k - 1))) {
+        xstart = (int*) realloc (xstart, sizeof(int) * (nrofXors + 1));
+        xrhs   = (int*) realloc (xrhs,   sizeof(int) * (nrofXors + 1));
+        xv     = (int*) realloc (xv,     sizeof(int) * (xvSize + k + 1));
+        xstart[ nrofXors ] = xvSize;
+        xrhs  [ nrofXors ] = p ^ 1;
+        for (c = 0; c < k; c++) xv[ xvSize++ ] = NR(Cv[i][c]);
+        xv[ xvSize++ ] = 0;
+        nrofXors++; } }
+
+  if (gs_calls == 1) gs_xors = nrofXors;
+  if (nrofXors == 0) return SAT;
+
+  gs_parent = (int*) malloc (sizeof(int) * (nrofvars + 1));
+  gs_index  = (int*) malloc (sizeof(int) * (nrofvars + 1));
+  for (i = 0; i <= nrofvars; i++) gs_parent[i] = i;
+  for (i = 0; i < nrofXors; i++)
+    for (j = xstart[i] + 1; xv[j]; j++)
+      gs_parent[ gs_find (xv[j]) ] = gs_find (xv[ xstart[i] ]);
+
+  /* bucket the XORs and their variables by the root of their component */
+  int *xorCount = (int*) calloc (nrofvars + 2, sizeof(int));
+  int *varCount = (int*) calloc (nrofvars + 2, sizeof(int));
+  int *seen     = (int*) calloc (nrofvars + 1, sizeof(int));
+  for (i = 0; i < nrofXors; i++) xorCount[ gs_find (xv[ xstart[i] ]) + 1 ]++;
+  for (i = 0; i < xvSize; i++)
+    if (xv[i] && !seen[ xv[i] ]) { seen[ xv[i] ] = 1; varCount[ gs_find (xv[i]) + 1 ]++; }
+  for (i = 1; i <= nrofvars + 1; i++) {
+    xorCount[i] += xorCount[i - 1];
+    varCount[i] += varCount[i - 1]; }
+
+  int *xors = (int*) malloc (sizeof(int) * nrofXors);
+  int *rhs  = (int*) malloc (sizeof(int) * nrofXors);
+  int *vars = (int*) malloc (sizeof(int) * (varCount[ nrofvars + 1 ] + 1));
+  int *xpos = (int*) malloc (sizeof(int) * (nrofvars + 1));
+  int *vpos = (int*) malloc (sizeof(int) * (nrofvars + 1));
+  for (i = 0; i <= nrofvars; i++) { xpos[i] = xorCount[i]; vpos[i] = varCount[i]; }
+  for (i = 0; i < nrofXors; i++) {
+    int root = gs_find (xv[ xstart[i] ]);
+    xors[ xpos[root]   ] = xstart[i];
+    rhs [ xpos[root]++ ] = xrhs[i]; }
+  for (i = 0; i < xvSize; i++)
+    if (xv[i] && seen[ xv[i] ] == 1) { seen[ xv[i] ] = 2; vars[ vpos[ gs_find (xv[i]) ]++ ] = xv[i]; }
+
+  int *newFacts = NULL, nrofFacts = 0, result = SAT;
+  for (i = 1; i <= nrofvars && result == SAT; i++)
+    if (xorCount[i + 1] > xorCount[i])
+      result = gs_component (xors + xorCount[i], xorCount[i + 1] - xorCount[i], xv,
+                             rhs + xorCount[i], vars + varCount[i], varCount[i + 1] - varCount[i],
+                             &newFacts, &nrofFacts);
+
+  /* append the facts, the next iteration of simplify_formula picks them up */
+  if (result == SAT && nrofFacts) {
+    int size = nrofclauses;
+    for (i = 0; i < nrofFacts; i++) size += newFacts[2 * i + 1] ? 2 : 1;
+    Cv      = (int**) realloc (Cv,      sizeof(int*) * size);
+    Clength = (int* ) realloc (Clength, sizeof(int ) * size);
+    for (i = 0; i < nrofFacts; i++) {
+      int a = newFacts[2 * i], b = newFacts[2 * i + 1];
+      if (b == 0) {
+        Cv[ nrofclauses ] = (int*) malloc (sizeof(int));
+        Cv[ nrofclauses ][ 0 ] = a;
+        Clength[ nrofclauses++ ] = 1;
+        continue; }
+      for (j = 0; j < 2; j++) {
+        Cv[ nrofclauses ] = (int*) malloc (sizeof(int) * 2);
+        Cv[ nrofclauses ][ 0 ] = j ? -a : a;
+        Cv[ nrofclauses ][ 1 ] = j ? -b : b;
+        Clength[ nrofclauses++ ] = 2; } }
+    *facts += nrofFacts; }
+
+  free (newFacts); free (xors); free (rhs); free (vars); free (xpos); free (vpos);
+  free (xorCount); free (varCount); free (seen);
+  free (xstart); free (xrhs); free (xv);
+  FREE (gs_parent); FREE (gs_index);
+
+  return result; }
+
+void gauss_report () {
+  if (quiet_mode == 0)
+    printf ("c gauss_elimination():: %i XORs, %i units and %i equivalences derived%s\n",
+            gs_xors, gs_units, gs_equivalences, gs_skipped ? " (large components skipped)" : ""); }
@@ -0,0 +1,8 @@
+/*
+   MARCH Satisfiability Solver
+   Copyright (C) 2001-2005 M.J.H. Heule, J.E. van Zwieten, and M. Dufour.
+   Copyright (C) 2005-2017 M.J.H. Heule. [marijn@heule.nl]
+*/
+
+int  gauss_elimination (int *facts);
+void gauss_report      ();
@@ -0,0 +1,153 @@
+/*
+   MARCH Satisfiability Solver
+   Copyright (C) 2001-2005 M.J.H. Heule, J.E. van Zwieten, and M. Dufour.
+   Copyright (C) 2005-2017 M.J.H. Heule. [marijn@heule.nl]
+
+   This file contains libmarch: every call of march_cube () starts a thread
+   that renders the formula as DIMACS in memory and runs the same code as
+   march_cu on it.  A new thread starts with zeroed thread-local state, just
+   like a new process, and the cubes are passed to the callback instead of
+   being written to a file.  Only rand () is shared, so contexts that set a
+   seed ("s") are not reproducible while others run.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "libmarch.h"
+#include "march.h"
+#include "common.h"
+#include "metrics.h"
+
+static const char *options[] = { "d", "n", "e", "f", "l", "L", "s", "p",
+  "min", "max", "bin", "dec", "sli", "dli", "gah", "imp", "wfr", "gauss" };
+
+#define NR_OPTIONS	( (int) (sizeof (options) / sizeof (options[0])) )
+
+struct March {
+  int *lits, nrofLits, litsSize;        // clauses, each terminated by 0
+  int nrofClauses, maxVar, open, empty;
+  double value[ NR_OPTIONS ];
+  char   isSet[ NR_OPTIONS ];
+  march_cube_fn fn;
+  void *state;
+  FILE *in;
+  int *model, cubes, result; };
+
+March *march_new () {
+  return (March*) calloc (1, sizeof (March)); }
+
+void march_delete (March *m) {
+  free (m->lits);
+  free (m->model);
+  free (m); }
+
+void march_add (March *m, int lit) {
+  if (m->nrofLits == m->litsSize) {
+    m->litsSize = m->litsSize ? 2 * m->litsSize : 1024;
+    m->lits = (int*) realloc (m->lits, sizeof (int) * m->litsSize); }
+  m->lits[ m->nrofLits++ ] = lit;
+  if (abs (lit) > m->maxVar) m->maxVar = abs (lit);
+  if (lit) { m->open++; return; }
+  if (m->open == 0) m->empty = 1;
+  m->nrofClauses++;
+  m->open = 0; }
+
+int march_set_option (March *m, const char *name, double value) {
+  int i; for (i = 0; i < NR_OPTIONS; i++)
+    if (strcmp (name, options[i]) == 0) {
+      m->value[i] = value;
+      m->isSet[i] = 1;
+      return 1; }
+  return 0; }
+
+void march_set_cube_callback (March *m, void *state, march_cube_fn fn) {
+  m->state = state;
+  m->fn    = fn; }
+
+int march_val (March *m, int lit) {
+  if (m->model == NULL || abs (lit) > m->maxVar) return 0;
+  return m->model[ abs (lit) ]; }
+
+static void setOption (int option, double v) {
+  switch (option) {
+    case  0: cut_depth  = (unsigned int) v; break;
+    case  1: cut_var    = (unsigned int) v; break;
+    case  2: downexp    = v;                break;
+    case  3: fraction   = v;                break;
+    case  4: cubeLimit  = (unsigned int) v; break;
+    case  5: hardLimit  = (unsigned int) v; break;
+    case  6: seed       = (unsigned int) v; break;
+    case  7: mode       = v ? PLAIN_MODE : CUBE_MODE; break;
+    case  8: h_min      = v;                break;
+    case  9: h_max      = v;                break;
+    case 10: h_bin      = v;                break;
+    case 11: h_dec      = v;                break;
+    case 12: sl_iter    = (unsigned int) v; break;
+    case 13: dl_iter    = (unsigned int) v; break;
+    case 14: gah        = (v != 0);         break;
+    case 15: addIMP     = (v != 0);         break;
+    case 16: addWFR     = (v != 0);         break;
+    case 17: gauss      = (v != 0);         break; } }
+
+static void leaf (void *state, const int *cube, int size, int refuted) {
+  March *m = (March*) state;
+  if (!refuted) m->cubes++;
+  if (m->fn) m->fn (m->state, cube, size, refuted); }
+
+static void *run (void *ptr) {
+  March *m = (March*) ptr;
+
+  setDefaults ();
+  int i; for (i = 0; i < NR_OPTIONS; i++)
+    if (m->isSet[i]) setOption (i, m->value[i]);
+
+  quiet_mode     = 2;
+  cube_callback  = leaf;
+  cube_state     = m;
+  solution_model = m->model;
+
+  if (seed) srand (seed);
+  metrics_init (NULL, 1.0);
+
+  m->result = runMarch (m->in);
+  return NULL; }
+
+int march_cube (March *m) {
+  pthread_t thread;
+  char *dimacs;
+  size_t size;
+  int i;
+
+  if (m->open) return EXIT_CODE_ERROR;
+
+  free (m->model);
+  m->model = (int*) calloc (m->maxVar + 1, sizeof (int));
+  m->cubes = 0;
+
+  if (m->empty) {
+    leaf (m, NULL, 0, 1);
+    return EXIT_CODE_UNSAT; }
+  if (m->nrofClauses == 0) return EXIT_CODE_SAT;
+
+  FILE *out = open_memstream (&dimacs, &size);
+  if (out == NULL) return EXIT_CODE_ERROR;
+  fprintf (out, "p cnf %i %i\n", m->maxVar, m->nrofClauses);
+  for (i = 0; i < m->nrofLits; i++)
+    fprintf (out, m->lits[i] ? "%i " : "%i\n", m->lits[i]);
+  fclose (out);
+
+  m->in     = fmemopen (dimacs, size, "r");
+  m->result = EXIT_CODE_ERROR;
+  if (m->in && pthread_create (&thread, NULL, run, m) == 0)
+    pthread_join (thread, NULL);
+  if (m->in) fclose (m->in);
+  m->in = NULL;
+  free (dimacs);
+
+  /* in cube mode march_cu exits with 0 even if all leaves are refuted */
+  if (m->result == EXIT_CODE_UNKNOWN && m->cubes == 0 &&
+      !(m->isSet[7] && m->value[7])) return EXIT_CODE_UNSAT;
+  return m->result; }
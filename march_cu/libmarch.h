@@ -0,0 +1,51 @@
+/*
+   MARCH Satisfiability Solver
+   Copyright (C) 2001-2005 M.J.H. Heule, J.E. van Zwieten, and M. Dufour.
+   Copyright (C) 2005-2017 M.J.H. Heule. [marijn@heule.nl]
+
+   This file contains the C interface of libmarch, the cuber of march_cu
+   as a library.  A context holds a formula and options.  march_cube ()
+   runs the cuber on its own thread, on which all solver state is
+   thread-local, so any number of contexts can run at the same time.
+   Calls on one context must not overlap.
+*/
+
+#ifndef __LIBMARCH_H__
+#define __LIBMARCH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct March March;
+
+/* Called for every leaf of the cube tree in the order of march_cu -o.
+   'refuted' is set for leaves refuted by the look-ahead.  'cube' is only
+   valid during the call, which is made on the cubing thread. */
+typedef void (*march_cube_fn) (void *state, const int *cube, int size, int refuted);
+
+March *march_new    (void);
+void   march_delete (March *m);
+
+/* Adds a literal to the formula, 0 terminates the clause. */
+void   march_add    (March *m, int lit);
+
+/* Sets an option by the name of its march_cu flag without '-':
+   "d" "n" "e" "f" "l" "L" "s" "p" "min" "max" "bin" "dec" "sli" "dli"
+   and "gah" "imp" "wfr" "gauss" (0 or 1).  Returns 0 for an unknown name. */
+int    march_set_option (March *m, const char *name, double value);
+
+void   march_set_cube_callback (March *m, void *state, march_cube_fn fn);
+
+/* Returns 10 if a solution was found, 20 if every leaf is refuted, 0 if
+   cubes were emitted and 1 on an error. */
+int    march_cube   (March *m);
+
+/* After 10: 'lit' if it is true, '-lit' if it is false, 0 if unassigned. */
+int    march_val    (March *m, int lit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
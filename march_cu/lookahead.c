@@ -23,16 +23,18 @@
 
 
 /* global look-ahead variables */
-int new_binaries, *NBCounter, *failed_DL_stamp;
-float weighted_new_binaries, *WNBCounter;
+TLS int new_binaries, *NBCounter, *failed_DL_stamp;
+TLS float weighted_new_binaries, *WNBCounter;
 
 #ifdef DL_DECREASE
-double DL_decrease;
+TLS double DL_decrease;
 #endif
 
-float *EqDiff;
+TLS float *EqDiff;
 
-int (*look_IUP        ) (const int nrval, int *local_fixstackp);
+TLS double *hintScore;
+
+TLS int (*look_IUP        ) (const int nrval, int *local_fixstackp);
 int look_IUP_w_eq_3SAT  (const int nrval, int *local_fixstackp);
 int look_IUP_w_eq_kSAT  (const int nrval, int *local_fixstackp);
 int look_IUP_wo_eq_3SAT (const int nrval, int *local_fixstackp);
@@ -66,7 +68,10 @@ void init_lookahead () {
         if (quiet_mode == 0)
   	  printf("c init_lookahead: longest clause has size %i\n", longest_clause);
 
-	size_diff = (float*) malloc(sizeof(float) * longest_clause );
+	size_diff = (float*) malloc(sizeof(float) * (longest_clause < 3 ? 3 : longest_clause) );
+
+	if (nrofhints > nrofvars) nrofhints = nrofvars;
+	if (nrofhints) hintScore = (double*) malloc (sizeof(double) * nrofhints);
 	size_diff[ 0 ] = 0.0;
 	size_diff[ 1 ] = 0.0;
 	size_diff[ 2 ] = h_bin;
@@ -142,12 +147,15 @@ void dispose_lookahead () {
   dispose_tree();
   FREE (treeArray);
   FREE (size_diff);
+  FREE (hintScore);
 #ifdef EQ
   FREE (lengthWeight);
 #endif
   FREE_OFFSET( EqDiff          );
 //  FREE_OFFSET( diff            );
 //  FREE_OFFSET( diff_tmp        );
+  FREE_OFFSET( _diff           );
+  FREE_OFFSET( _diff_tmp       );
   FREE_OFFSET( NBCounter       );
   FREE_OFFSET( WNBCounter      );
   FREE_OFFSET( failed_DL_stamp );
@@ -572,7 +580,7 @@ int tree_lookahead () {
       if (forced_literals > _forced_literals) {
         if (IS_FIXED(node.literal) && (Rank[NR(node.literal)] < Rank_trigger)) { // obsolete ?
 	  Rank_trigger = Rank[NR(node.literal)];
-          printf ("c forced var with Rank %i\n", Rank_trigger); }
+          if (quiet_mode < 2) printf ("c forced var with Rank %i\n", Rank_trigger); }
 	_forced_literals = forced_literals;
 	lastChanged = node.literal; } }
     currentTimeStamp += 2 * tree_elements;
@@ -787,6 +795,32 @@ int get_signedBranchVariable () {
   return maxDiffVar * maxDiffSide;
 }
 
+/* Stores the (at most 'max') free variables other than 'skip' with the highest
+   diffScore of the last lookahead in 'lits', best first, each signed like the
+   branch literal get_signedBranchVariable would pick for it.  Returns the
+   number stored. */
+int get_hint_literals (int *lits, const int max, const int skip) {
+  double *score = hintScore;
+  int i, j, size = 0;
+
+  for (i = 0; i < lookaheadArrayLength; i++) {
+    int varnr = lookaheadArray[ i ];
+    if (IS_FORCED(varnr) || varnr == skip) continue;
+
+    double left  = 1024 * WNBCounter[ varnr] + 0.0;
+    double right = 1024 * WNBCounter[-varnr] + 0.0;
+    double diffScore = left * right + left + right;
+
+    if (size == max && diffScore <= score[ size - 1 ]) continue;
+    if (size < max) size++;
+    for (j = size - 1; j > 0 && score[ j - 1 ] < diffScore; j--) {
+      score[ j ] = score[ j - 1 ];
+      lits [ j ] = lits [ j - 1 ]; }
+    score[ j ] = diffScore;
+    lits [ j ] = (left > right) ? -varnr : varnr; }
+
+  return size; }
+
 void cleanFormula() { // currently only used in preprocessor
   int i;
   for (i = 1; i <= nrofvars; i++)
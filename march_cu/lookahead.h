@@ -33,6 +33,7 @@ void lookahead_subsume( const int nrval );
 
 void get_forced_literals( int **_forced_literal_array, int *_forced_literals );
 int  get_signedBranchVariable( );
+int  get_hint_literals( int *lits, const int max, const int skip );
 
 int check_all_equal( int clsidx );
 
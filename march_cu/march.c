@@ -9,44 +9,44 @@
 #include <math.h>
 #include <time.h>
 #include <string.h>
+#include <limits.h>
+
+#define MARCH_GLOBALS
 
 #include "march.h"
 #include "cube.h"
 #include "common.h"
+#include "distribution.h"
+#include "tree.h"
 #include "equivalence.h"
+#include "gauss.h"
 #include "lookahead.h"
 #include "parser.h"
 #include "preselect.h"
 #include "progressBar.h"
+#include "metrics.h"
 #include "resolvent.h"
 #include "solver.h"
 #include "memory.h"
 
-void handleUNSAT () {
+int handleUNSAT () {
   if (quiet_mode == 0) {
     printf ("c main():: nodeCount: %i\n", nodeCount);
     printf ("c main():: time=%f\n", ((float)(clock()))/CLOCKS_PER_SEC); }
   if (mode == PLAIN_MODE) {
-    printf( "s UNSATISFIABLE\n" ); }
+    if (quiet_mode < 2) printf( "s UNSATISFIABLE\n" ); }
   else { printUNSAT (); }
   disposeFormula();
-  exit (EXIT_CODE_UNSAT); }
-
-int main (int argc, char** argv) {
-  int result   = UNKNOWN;
-  int exitcode = EXIT_CODE_UNKNOWN;
-
-  if (argc < 2) {
-    printf ("c input file missing, usage: ./march_cu DIMACS-file.cnf\n");
-    printf ("c run using -h for help\n");
-    return EXIT_CODE_ERROR; }
+  return EXIT_CODE_UNSAT; }
 
+void setDefaults () {
   hardLimit  = 0; // no hard limit
   seed       = 0; // no initial seed
   quiet_mode = 0;
   cut_depth  = 0;
   cut_var    = 0;
   cubeLimit  = 0;
+  nrofhints  = 0;
   strcpy (cubesFile, "/tmp/cubes.icnf");
 
   h_min      = H_MIN;
@@ -62,6 +62,7 @@ int main (int argc, char** argv) {
   gah        = GAH;
   addWFR     = WFR;
   addIMP     = IMP;
+  gauss      = GAUSS;
 
 #ifdef SCHUR
   dl_iter    = 0;
@@ -69,7 +70,21 @@ int main (int argc, char** argv) {
 
   cweight  = 8200;
   downexp  = 0.3;
-  fraction = 0.02;
+  fraction = 0.02; }
+
+#ifndef MARCH_LIB
+int main (int argc, char** argv) {
+  FILE* in;
+  int exitcode;
+
+  if (argc < 2) {
+    printf ("c input file missing, usage: ./march_cu DIMACS-file.cnf\n");
+    printf ("c run using -h for help\n");
+    return EXIT_CODE_ERROR; }
+
+  setDefaults ();
+  char *metricsFile  = NULL;
+  double metricsTime = 1.0;
 
   int i;
   for (i = 1; i < argc; i++)
@@ -92,10 +107,14 @@ int main (int argc, char** argv) {
       printf("c OPTIONAL LOOKAHEAD TECHNIQUES (option will negate the default):\n\n");
       printf("   -gah          global autarky heuristic  (default: %s)\n",  (GAH)?"on":"off");
       printf("   -imp          add both implications     (default: %s)\n",  (IMP)?"on":"off");
-      printf("   -wfr          add windfall resolvents   (default: %s)\n\n",(WFR)?"on":"off");
+      printf("   -wfr          add windfall resolvents   (default: %s)\n",  (WFR)?"on":"off");
+      printf("   -gauss        XOR Gaussian elimination  (default: %s)\n\n",(GAUSS)?"on":"off");
       printf("c OUTPUT OPTIONS:\n\n");
       printf("   -o <file>     emit the cubes to <file>  (default: %s)\n", cubesFile);
       printf("   -q            turn on quiet mode        (set default output to stdout)\n");
+      printf("   -m <file>     rewrite JSON metrics file (default:           none)\n");
+      printf("   -mi <float>   seconds between metrics   (default: %4.2f)\n", metricsTime);
+      printf("   -hints <int>  emit phase hints per cube (default: %4.0f,          none)\n", (float) nrofhints);
       printf("   -cnf          add the cnf to the cubes\n\n");
       printf("c MAGIC CONSTANTS:\n\n");
       printf("   -bin <float>  binary clause weight      (default: %6.2f)\n", H_BIN);
@@ -111,14 +130,24 @@ int main (int argc, char** argv) {
     if (strcmp(argv[i], "-p"  ) == 0) { mode = PLAIN_MODE;             }
     if (strcmp(argv[i], "-#"  ) == 0) { sharp_mode = 1;                }
     if (strcmp(argv[i], "-q"  ) == 0) { quiet_mode = 1;                }
+    if (strcmp(argv[i], "-m"  ) == 0) { metricsFile = argv[i+1];       }
+    if (strcmp(argv[i], "-mi" ) == 0) { metricsTime = atof (argv[i+1]); }
     if (strcmp(argv[i], "-d"  ) == 0) { cut_depth  = strtoul (argv[i+1], NULL, 10); }
     if (strcmp(argv[i], "-n"  ) == 0) { cut_var    = strtoul (argv[i+1], NULL, 10); }
     if (strcmp(argv[i], "-l"  ) == 0) { cubeLimit  = strtoul (argv[i+1], NULL, 10); }
+    if (strcmp(argv[i], "-hints") == 0) {
+      char *end = NULL;
+      long n = (i + 1 < argc) ? strtol (argv[i+1], &end, 10) : -1;
+      if (end == argv[i+1] || (end && *end) || n < 0 || n > INT_MAX / 2) {
+        printf ("c -hints needs a number of variables, got '%s'\n", (i + 1 < argc) ? argv[i+1] : "");
+        return EXIT_CODE_ERROR; }
+      nrofhints = (int) n; }
     if (strcmp(argv[i], "-L"  ) == 0) { hardLimit  = strtoul (argv[i+1], NULL, 10); }
     if (strcmp(argv[i], "-s"  ) == 0) { seed       = strtoul (argv[i+1], NULL, 10); }
     if (strcmp(argv[i], "-gah") == 0) { gah       ^= 1;                }
     if (strcmp(argv[i], "-imp") == 0) { addIMP    ^= 1;                }
     if (strcmp(argv[i], "-wfr") == 0) { addWFR    ^= 1;                }
+    if (strcmp(argv[i], "-gauss") == 0) { gauss ^= 1;                  }
     if (strcmp(argv[i], "-min") == 0) { h_min      = atof (argv[i+1]); }
     if (strcmp(argv[i], "-max") == 0) { h_max      = atof (argv[i+1]); }
     if (strcmp(argv[i], "-bin") == 0) { h_bin      = atof (argv[i+1]); }
@@ -134,13 +163,32 @@ int main (int argc, char** argv) {
 
   if (seed) srand (seed);
 
+  metrics_init (metricsFile, metricsTime);
+
+  if ((in = fopen (argv[1], "r")) == NULL) {
+    printf ("c runParser():: input file could not be opened!\n");
+    return EXIT_CODE_ERROR; }
+
+  exitcode = runMarch (in);
+  fclose (in);
+  return exitcode; }
+#endif
+
+/* Parses 'in', cubes the formula with the options in the globals and emits
+   the cubes to 'cubesFile', stdout (quiet mode) or 'cube_callback'.  Returns
+   the exit code of march_cu and releases the formula and the solver. */
+int runMarch (FILE* in) {
+  int result   = UNKNOWN;
+  int exitcode = EXIT_CODE_UNKNOWN;
+  int i;
+
   if (!cut_var && !cut_depth) dynamic = 1;
 
   /***** Parsing... *******/
-  runParser (argv[1]);
+  if ((exitcode = parseFormula (in)) != EXIT_CODE_UNKNOWN) return exitcode;
 
 #ifdef SIMPLE_EQ
-	if (equivalence_reasoning() == UNSAT) handleUNSAT();
+	if (equivalence_reasoning() == UNSAT) return handleUNSAT();
 #endif
         for (i = 0; i < nrofclauses; i++)
           if (Clength[i] > 3) {
@@ -154,7 +202,7 @@ int main (int argc, char** argv) {
 
 #ifndef TERNARYLOOK
 #ifdef RESOLVENTLOOK
-	if (resolvent_look() == UNSAT) handleUNSAT();
+	if (resolvent_look() == UNSAT) return handleUNSAT();
 #endif
 #endif
         if (kSAT_flag)         allocate_big_clauses_datastructures();
@@ -199,6 +247,7 @@ int main (int argc, char** argv) {
         if (count) printf("\nc number free #SAT variables: %i\n", count);
         if (out == freevars) printf("c all remaing variables are free #SAT: 2^%i solutions\n", count);
      }
+        free (status - nrofvars);
 
 
 	if (initSolver ())
@@ -207,7 +256,7 @@ int main (int argc, char** argv) {
 		printf ("c timeout = %i seconds\n", TIMEOUT);
 #endif
 #ifdef PROGRESS_BAR
-		pb_init (6);
+		if (!metrics_enabled ()) pb_init (6);	/* -m replaces the progress bar */
 #endif
 #ifdef DISTRIBUTION
 		result = distribution_branching();
@@ -222,6 +271,7 @@ int main (int argc, char** argv) {
 #ifdef PROGRESS_BAR
 		pb_dispose();
 #endif
+		metrics_write (1);
 	}
 	else
 	{
@@ -247,17 +297,19 @@ int main (int argc, char** argv) {
 	switch (result)
 	{
 	    case SAT:
-		printf( "s SATISFIABLE\n" );
+		if (quiet_mode < 2) printf( "s SATISFIABLE\n" );
 #ifndef COUNT_SAT
                 if (quiet_mode == 0)
 		  printSolution (original_nrofvars);
+                if (solution_model)
+                  storeSolution (solution_model, original_nrofvars);
 #endif
 		exitcode = EXIT_CODE_SAT;
 		break;
 
 	    case UNSAT:
                if (mode == PLAIN_MODE) {
-                 printf ("s UNSATISFIABLE\n");
+                 if (quiet_mode < 2) printf ("s UNSATISFIABLE\n");
   	         exitcode = EXIT_CODE_UNSAT; }
                else {
 
@@ -265,7 +317,7 @@ int main (int argc, char** argv) {
 	       break;
 
 	    default:
-		printf( "s UNKNOWN\n" );
+		if (quiet_mode < 2) printf( "s UNKNOWN\n" );
 		exitcode = EXIT_CODE_UNKNOWN;
             printDecisionTree ();
         }
@@ -277,24 +329,16 @@ int main (int argc, char** argv) {
         return exitcode;
 }
 
-void runParser (char* fname) {
-  FILE* in;
-
-  if ((in = fopen (fname, "r")) == NULL) {
-    printf ("c runParser():: input file could not be opened!\n");
-    exit (EXIT_CODE_ERROR); }
-
+int parseFormula (FILE* in) {
   if (!initFormula (in)) {
-    printf ("c runParser():: p-line not found in input, but required by DIMACS format!\n");
-    fclose (in);
-    exit (EXIT_CODE_ERROR); }
+    if (quiet_mode < 2)
+      printf ("c runParser():: p-line not found in input, but required by DIMACS format!\n");
+    return EXIT_CODE_ERROR; }
 
   if (!parseCNF(in)) {
-    printf ("c runParser():: parse error in input!\n");
-    fclose (in);
-    exit (EXIT_CODE_ERROR); }
-
-  fclose (in);
+    if (quiet_mode < 2)
+      printf ("c runParser():: parse error in input!\n");
+    return EXIT_CODE_ERROR; }
 
   init_equivalence();
 
@@ -303,7 +347,10 @@ void runParser (char* fname) {
       printf ("c runParser():: conflicting unary clauses, so instance is unsatisfiable!\n");
       printf( "c time = %.2f seconds\n", ((float)(clock()))/CLOCKS_PER_SEC ); }
     printUNSAT ();
-    printf ("s UNSATISFIABLE\n");
+    if (quiet_mode < 2) printf ("s UNSATISFIABLE\n");
     disposeFormula ();
-    exit (EXIT_CODE_UNSAT); }
-}
+    return EXIT_CODE_UNSAT; }
+
+  if (gauss && sharp_mode == 0) gauss_report ();
+
+  return EXIT_CODE_UNKNOWN; }
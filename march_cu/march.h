@@ -23,7 +23,11 @@
 #ifndef __MARCHII_H__
 #define __MARCHII_H__
 
+#include <stdio.h>
+
 int main( int argc, char** argv );
-void runParser( char* fname );
+void setDefaults();
+int runMarch( FILE* in );
+int parseFormula( FILE* in );
 
 #endif
@@ -0,0 +1,79 @@
+/*
+   MARCH Satisfiability Solver
+   Copyright (C) 2001-2005 M.J.H. Heule, J.E. van Zwieten, and M. Dufour.
+   Copyright (C) 2005-2017 M.J.H. Heule. [marijn@heule.nl]
+
+   This file contains the metrics snapshots: a JSON file that is rewritten
+   (through a temporary file and rename) at most once per interval, so that
+   long cube runs can be monitored without parsing the console output
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "metrics.h"
+#include "cube.h"
+#include "common.h"
+
+#define MT_MAX_DEPTH	64
+
+TLS char  *mt_file;
+TLS double mt_interval, mt_start, mt_last, mt_done;
+TLS int    mt_cubes, mt_refuted, mt_depth[ MT_MAX_DEPTH ];
+
+/* wall-clock seconds, unaffected by changes of the system time */
+double mt_time () {
+  struct timespec t;
+  clock_gettime (CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9; }
+
+void metrics_init (char *file, double interval) {
+  mt_file     = file;
+  mt_interval = interval;
+  mt_start    = mt_time ();
+  mt_last     = mt_start;
+  mt_done     = 0;
+  mt_cubes    = 0;
+  mt_refuted  = 0;
+  int i; for (i = 0; i < MT_MAX_DEPTH; i++) mt_depth[i] = 0; }
+
+int metrics_enabled () {
+  return mt_file != NULL; }
+
+/* a cube or refuted leaf at 'depth' covers 2^-depth of the search space */
+void metrics_leaf (int depth, int type) {
+  if (mt_file == NULL) return;
+  if (type == CUBE_DNODE) {
+    mt_cubes++;
+    mt_depth[ depth < MT_MAX_DEPTH ? depth : MT_MAX_DEPTH - 1 ]++; }
+  else mt_refuted++;
+  mt_done += ldexp (1.0, -depth);
+
+  if (mt_time () - mt_last >= mt_interval) metrics_write (0); }
+
+void metrics_write (int final) {
+  if (mt_file == NULL) return;
+  mt_last = mt_time ();
+  double elapsed = mt_last - mt_start;
+
+  char tmp[ 4096 ];
+  int  len = snprintf (tmp, sizeof (tmp), "%s.tmp", mt_file);
+  if (len < 0 || len >= (int) sizeof (tmp)) return;
+  FILE *f = fopen (tmp, "w");
+  if (f == NULL) return;
+
+  fprintf (f, "{\n  \"tool\": \"march_cu\",\n  \"final\": %s,\n  \"elapsed\": %.3f,\n", final ? "true" : "false", elapsed);
+  fprintf (f, "  \"nodes\": %i,\n  \"lookaheads\": %lli,\n", nodeCount, lookAheadCount);
+  fprintf (f, "  \"cubes\": %i,\n  \"refuted\": %i,\n", mt_cubes, mt_refuted);
+  fprintf (f, "  \"cubes_per_sec\": %.2f,\n  \"nodes_per_sec\": %.2f,\n",
+    elapsed > 0 ? mt_cubes / elapsed : 0, elapsed > 0 ? nodeCount / elapsed : 0);
+  fprintf (f, "  \"done\": %.6f,\n  \"eta\": %.1f,\n", mt_done, mt_done > 0 ? elapsed / mt_done - elapsed : -1);
+  fprintf (f, "  \"cube_depths\": [");
+  int max = MT_MAX_DEPTH;
+  while (max > 1 && mt_depth[max - 1] == 0) max--;
+  int i; for (i = 0; i < max; i++) fprintf (f, "%s%i", i ? ", " : "", mt_depth[i]);
+  fprintf (f, "]\n}\n");
+
+  if (fclose (f) == 0) rename (tmp, mt_file); }
@@ -0,0 +1,10 @@
+/*
+   MARCH Satisfiability Solver
+   Copyright (C) 2001-2005 M.J.H. Heule, J.E. van Zwieten, and M. Dufour.
+   Copyright (C) 2005-2017 M.J.H. Heule. [marijn@heule.nl]
+*/
+
+void metrics_init  (char *file, double interval);
+void metrics_leaf  (int depth, int type);
+void metrics_write (int final);
+int  metrics_enabled ();
@@ -13,8 +13,9 @@
 #include "parser.h"
 #include "memory.h"
 #include "equivalence.h"
+#include "gauss.h"
 
-int *simplify_stack, *simplify_stackp;
+TLS int *simplify_stack, *simplify_stackp;
 
 #define PUSH_PARSER_NA( __a ) \
 { \
@@ -81,7 +82,7 @@ int initFormula( FILE* in )
 
 	if (result == EOF || result != 2) return 0;
 
-        if (quiet_mode) printf ("p inccnf\n");
+        if (quiet_mode == 1) printf ("p inccnf\n");
 
 	nrofvars    = original_nrofvars;
 	activevars  = original_nrofvars;
@@ -128,6 +129,10 @@ void disposeFormula () {
   FREE_OFFSET( timeAssignments );
   FREE( VeqDepends );
   FREE( Clength );
+  FREE( simplify_stack );
+
+  free_BinaryImp ();
+  dispose_equivalence ();
 
 /* Update cnf structure. */
 
@@ -135,8 +140,6 @@ void disposeFormula () {
   original_nrofclauses = 0;
   nrofvars 	       = 0;
   nrofclauses	       = 0;
-
-  dispose_equivalence ();
 }
 
 /*
@@ -206,7 +209,7 @@ int parseCNF( FILE* in )
 		    if( clen == 0 )
 		    {
 			/* a zero-length clause is not good! */
-			printf( "c WARNING: zero length clause found in input!\n" );
+			if (quiet_mode < 2) printf( "c WARNING: zero length clause found in input!\n" );
 			error = 1;
 		    }
 		    else
@@ -216,7 +219,7 @@ int parseCNF( FILE* in )
 
 			Cv[ i ] = (int*) malloc( sizeof( int ) * clen );
 			Clength[ i ] = clen;
-                        if (quiet_mode) {
+                        if (quiet_mode == 1) {
   			  for (j = 0; j < clen; j++) printf ("%i ", _clause[j]);
                           printf ("0\n"); }
 			for( j = 0; j < clen; j++ ) Cv[ i ][ j ] = _clause[ j ];
@@ -230,7 +233,7 @@ int parseCNF( FILE* in )
 			_clause[ clen++ ] = _lit;
 		    else
 		    {
-			printf( "c WARNING: clause length exceeds total number of variables in this CNF.\n" );
+			if (quiet_mode < 2) printf( "c WARNING: clause length exceeds total number of variables in this CNF.\n" );
 			error = 1;
 		    }
 		}
@@ -255,9 +258,10 @@ int simplify_formula () {
   int satisfied       = 0;
   int duplicates      = 0;
   int bi_equivalences = 0;
+  int xor_facts       = 0;
 
   do {
-    _iterCounter  = bi_equivalences + nrofvars - freevars;
+    _iterCounter  = bi_equivalences + xor_facts + nrofvars - freevars;
 
 
     tautologies += sort_literals();
@@ -267,11 +271,12 @@ int simplify_formula () {
 #ifdef SIMPLE_EQ
     if (sharp_mode == 0) {
       bi_equivalences += find_and_propagate_binary_equivalences ();
-      if (check_vadility_equivalences () == UNSAT) return UNSAT; }
+      if (check_vadility_equivalences () == UNSAT) return UNSAT;
+      if (gauss && gauss_elimination (&xor_facts) == UNSAT) return UNSAT; }
 #endif
 
 
-  } while ((bi_equivalences + nrofvars - freevars) > _iterCounter);
+  } while ((bi_equivalences + xor_facts + nrofvars - freevars) > _iterCounter);
 
   return SAT; }
 
@@ -316,7 +321,7 @@ int find_and_propagate_unary_clauses () {
 
   int result = propagate_unary_clauses();
 
-  free (simplify_stack);
+  FREE (simplify_stack);
 
   return result; }
 
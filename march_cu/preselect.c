@@ -36,21 +36,21 @@
 //#define RANK_TRIGGER		1000000
 
 /* variables */
-int *freevarsLookup;
+TLS int *freevarsLookup;
 
-int* CandidatesSet, nrofCandidates;
+TLS int* CandidatesSet, nrofCandidates;
 
-double preselect_counter;
-int dynamic_preselect_setsize;
+TLS double preselect_counter;
+TLS int dynamic_preselect_setsize;
 
 inline int compute_max_preselected();
 
-int *block_queue, bq_size;
-int *block_var, block_stamp, *block_clause;
+TLS int *block_queue, bq_size;
+TLS int *block_var, block_stamp, *block_clause;
 
-int eq_check_flag = 1;
+TLS int eq_check_flag = 1;
 
-float *hiTmp;
+TLS float *hiTmp;
 
 void init_preselection() {
   preselect_counter = 0;
@@ -421,7 +421,7 @@ int check_ternary_clause_density()
 
 	if( freevars > freevars_sum * 1.5 )
 	{
-		printf("c many dependent variables -> full lookahead\n");
+		if (quiet_mode < 2) printf("c many dependent variables -> full lookahead\n");
 		return 1;
 	}
 
@@ -12,7 +12,8 @@
 #include "progressBar.h"
 #include "common.h"
 
-int pb_count, pb_best, pb_granularity, pb_currentDepth, pb_branchCounted;
+TLS int pb_count, pb_best, pb_granularity, pb_currentDepth, pb_branchCounted;
+TLS int pb_active;	/* set by pb_init, the bar prints nothing before */
 
 void pb_init (int granularity) {
   if (quiet_mode) return;
@@ -25,6 +26,7 @@ void pb_init (int granularity) {
   pb_branchCounted = 0;
   pb_count = 0;
   pb_best  = 10000;
+  pb_active = 1;
 
   printf ("c |");
   int i; for (i = 0; i < (1 << granularity); i++) printf("-");
@@ -32,6 +34,7 @@ void pb_init (int granularity) {
   fflush (stdout); }
 
 void pb_reset () {
+  if (!pb_active) return;
   pb_currentDepth = 0;
   pb_branchCounted = 0;
   pb_count = 0;
@@ -47,23 +50,24 @@ void pb_reset () {
   fflush (stdout); }
 
 void pb_dispose () {
-  if (quiet_mode) return;
+  if (!pb_active) return;
   pb_update ();
-  printf ("\nc\n"); }
+  printf ("\nc\n");
+  pb_active = 0; }
 
 void pb_update () {
-  if (quiet_mode) return;
+  if (!pb_active) return;
   printf( "\rc |" );
   int i; for( i = 0; i < pb_count; i++) printf ("*");
   fflush (stdout); }
 
 void pb_descend () {
-  if (quiet_mode) return;
+  if (!pb_active) return;
   pb_branchCounted = 0;
   pb_currentDepth++; }
 
 void pb_climb () {
-  if (quiet_mode) return;
+  if (!pb_active) return;
   pb_currentDepth--;
 
   if (pb_currentDepth < pb_best) {
@@ -7,9 +7,9 @@
 #include "resolvent.h"
 #include "parser.h"
 
-int *new_resolvent_begin, *new_resolvent_end;
-int **resolvent_list, *resolvent_size, resolvent_list_size;
-int nrofresolvents;
+TLS int *new_resolvent_begin, *new_resolvent_end;
+TLS int **resolvent_list, *resolvent_size, resolvent_list_size;
+TLS int nrofresolvents;
 
 int propagate_big_clauses( const int nrval )
 {
@@ -42,6 +42,7 @@
 #include "memory.h"
 #include "lookahead.h"
 #include "progressBar.h"
+#include "metrics.h"
 #include "parser.h"
 #include "microsat.h"
 
@@ -56,52 +57,52 @@
   #define RIGHT_CHILD	 records[record_index].child[branch_literal < 0]
 #endif
 
-struct solver CDCL;
+TLS struct solver CDCL;
 
-int sl_depth;
+TLS int sl_depth;
 
-int *tmpEqImpSize;
+TLS int *tmpEqImpSize;
 
-int *var_weight;
+TLS int *var_weight;
 
-int *TernaryImpTable, *TernaryImpLast;
-int current_bImp_stamp, *bImp_stamps;
+TLS int *TernaryImpTable, *TernaryImpLast;
+TLS int current_bImp_stamp, *bImp_stamps;
 
-int *newbistack, *newbistackp, newbistackSize;
-int *substack,   *substackp,   substackSize;
+TLS int *newbistack, *newbistackp, newbistackSize;
+TLS int *substack,   *substackp,   substackSize;
 
 int analyze_autarky();
 
-int nrofforced;
+TLS int nrofforced;
 
-unsigned long long solution_bin = 0;
-unsigned int solution_bits = 63;
+TLS unsigned long long solution_bin = 0;
+TLS unsigned int solution_bits = 63;
 
-int discrepancies = 0;
+TLS int discrepancies = 0;
 
-float first_time;
+TLS float first_time;
 #ifdef DISTRIBUTION
-int skip_flag = 0;
-int first_depth = 20;
+TLS int skip_flag = 0;
+TLS int first_depth = 20;
 #endif
 #ifdef SUBTREE_SIZE
-int path_length;
+TLS int path_length;
 #endif
 #ifdef CUT_OFF
-int last_SAT_bin = -1;
+TLS int last_SAT_bin = -1;
 #endif
 #ifdef BACKJUMP
-int backjump_literal = 0;
+TLS int backjump_literal = 0;
 #endif
 
-int currentNodeNumber = 1;
-int UNSATflag = 0;
+TLS int currentNodeNumber = 1;
+TLS int UNSATflag = 0;
 
 #ifdef CUBE
 //int refute_compensation;
-int size_flag;
-FILE *output;
-int current_Dnode;
+TLS int size_flag;
+TLS FILE *output;
+TLS int current_Dnode;
 #endif
 
 #define STAMP_IMPLICATIONS( _nrval ) \
@@ -407,9 +408,26 @@ void disposeSolver () {
   FREE_OFFSET( bImp_satisfied    );
   FREE_OFFSET( node_stamps       );
 
+  FREE_OFFSET( bImp_start          );
+  FREE_OFFSET( TernaryImpReduction );
+  FREE_OFFSET( TernaryImpLast      );
+  FREE( TernaryImpTable );
+
   FREE( tmpEqImpSize );
   FREE( impstack );
   FREE( rstack );
+  FREE( bieqstack );
+  FREE( subsumestack );
+  FREE( newbistack );
+  FREE( substack );
+
+  FREE( decisions );
+  FREE( var_weight );
+  FREE( trail );
+  FREE( CDCL.DB );
+#ifdef CUBE
+  dispose_assumptions();
+#endif
 }
 
 int propagate_forced_literals() {
@@ -497,10 +515,23 @@ void printConflict () {
 
 void refuteNode () {
   Dnode_setType (current_Dnode, REFUTED_DNODE);
+  metrics_leaf (depth, REFUTED_DNODE);
   conflicts++; }
 
+/* in #SAT mode a node without open clauses is a cube, so that the cubes
+   partition the models and the conquer side counts its 2^free models */
+void satisfiedNode () {
+  if (mode != CUBE_MODE) { refuteNode (); return; }
+  nodeCount--;
+  nr_cubes++;
+  Dnode_setType (current_Dnode, CUBE_DNODE);
+  metrics_leaf (depth, CUBE_DNODE); }
+
 int march_solve_rec() {
-  if (nrofclauses == 0) return SAT;
+  /* the preprocessor may leave only equivalences, fix them as verifySolution does */
+  if (nrofclauses == 0) {
+    do { fixDependedEquivalences (); } while (dependantsExists ());
+    return SAT; }
 
   int branch_literal = 0, _result, _percentage_forced;
   int skip_left = 0, skip_right = 0, top_flag = 0;
@@ -546,6 +577,7 @@ int march_solve_rec() {
 	nodeCount--;
 	nr_cubes++;
 	Dnode_setType (current_Dnode, CUBE_DNODE);
+	metrics_leaf (depth, CUBE_DNODE);
 
         free_th *= (1.0 - pow(fraction, pow(depth, downexp)));
 //        free_th *= (1.0 - pow(fraction, depth));
@@ -625,7 +657,7 @@ int march_solve_rec() {
 //                    return UNSAT;
 //#else
                     if (sharp_mode == 1) {
-                      refuteNode ();
+                      satisfiedNode ();
                       return UNSAT; }
                     return verifySolution();
 //#endif
@@ -638,7 +670,7 @@ int march_solve_rec() {
 //                    return UNSAT;
 //#else
                     if (sharp_mode == 1) {
-                      refuteNode ();
+                      satisfiedNode ();
                       return UNSAT; }
 		    return verifySolution ();
 //#endif
@@ -670,6 +702,9 @@ int march_solve_rec() {
 	while( (percentage_forced > 50.0) || (branch_literal == 0) );
 
 	_percentage_forced = percentage_forced;
+#ifdef CUBE
+	if (mode == CUBE_MODE && nrofhints) Dnode_setHints (current_Dnode, branch_literal);
+#endif
 
 	if (gah && depth == 0) {
 	    int i; for (i = 1; i <= nrofvars; i++) {
@@ -1550,6 +1585,8 @@ int verifySolution()
 	dollars = solution_bits - depth;
 	if( dollars < 1 ) dollars = 1;
 
+	if( quiet_mode < 2 )
+	{
 	printf("\nc |" );
 	for( i = solution_bits; i >= dollars; i-- )
 	{
@@ -1568,6 +1605,7 @@ int verifySolution()
 	   printf("$");
 
 	printf("|\n");
+	}
 #else
         printf("s %i\n", solution_bin + 1);
 	fflush( stdout );
@@ -1620,6 +1658,12 @@ int verifySolution()
 	return SAT;
 }
 
+void storeSolution (int *model, const int orignrofvars) {
+  int i; for (i = 1; i <= orignrofvars; i++) {
+    if      (timeAssignments[i] ==  VARMAX   ) model[i] =  i;
+    else if (timeAssignments[i] == (VARMAX+1)) model[i] = -i;
+    else                                       model[i] =  0; } }
+
 void printSolution (const int orignrofvars) {
   printf ("v");
   int i; for (i = 1; i <= orignrofvars; i++) {
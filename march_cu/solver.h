@@ -41,6 +41,7 @@ int march_solve_rec();
 void backtrack();
 int get_direction( int nrval );
 void printSolution( int orignrofvars );
+void storeSolution( int *model, int orignrofvars );
 
 int DPLL_add_binary_implications( int lit1, int lit2 );
 int DPLL_propagate_binary_equivalence( const int bieq );
@@ -29,18 +29,18 @@
 #define	TREEROOT		5
 #define	PREREDUCE		7
 
-int N = 0;
-int K = 0;
-int *comp_ ;
-int *child ;
-int *fai_;
-int *vstack;
-int vindex = 0;
-
-int toprank;
-int nrofroots;
-
-int *NodeType;
+TLS int N = 0;
+TLS int K = 0;
+TLS int *comp_ ;
+TLS int *child ;
+TLS int *fai_;
+TLS int *vstack;
+TLS int vindex = 0;
+
+TLS int toprank;
+TLS int nrofroots;
+
+TLS int *NodeType;
 
 /****************************************************************
 
@@ -9,8 +9,8 @@ struct assignment {
     int varnr;
 };
 
-struct assignment *assignment_array;
-int node_stamp, tree_stamp, changed;
+GLOBAL struct assignment *assignment_array;
+GLOBAL int node_stamp, tree_stamp, changed;
 
 void init_tree();
 void dispose_tree();
@@ -19,12 +19,12 @@ void create_tree_rec( int nrval );
 int calc_tree_size_rec( const int nrval );
 void looklist_rec( int nrval );
 
-int nrgiven;
-int minpos;
-int lastCTS;
+GLOBAL int nrgiven;
+GLOBAL int minpos;
+GLOBAL int lastCTS;
 
-int complement_value;
-int impgiven;
+GLOBAL int complement_value;
+GLOBAL int impgiven;
 
 #define ADD_INCOMING( __parent, __incoming ) \
 { \
@@ -1,9 +1,17 @@
+#!/bin/bash
 CNF=$1
 PAR=4
 DIR=~/CnC/
 OUT=/tmp
 
-rm $OUT/output*.txt
+rm -f $OUT/output*.txt
+
+# Parse the formula once, every job starts from the solver image
+$DIR/iglucose/core/iglucose $CNF -save-image=$OUT/image$$ > /dev/null
+CODE=$?
+if [[ $CODE == 20 ]]; then echo "s UNSATISFIABLE"; rm -f $OUT/image$$; exit 20; fi
+if [[ $CODE != 0 ]]; then echo "c ERROR! Could not write the solver image"; rm -f $OUT/image$$; exit 1; fi
+
 $DIR/march_cu/march_cu $CNF -o $OUT/cubes$$ $2 $3 $4 $5 $6 $7 $8 $9
 
 FLAG=1
@@ -30,13 +38,12 @@ done &
 for (( CORE=0; CORE<$PAR; CORE++ ))
 do
   echo "p inccnf" > $OUT/formula$$-$CORE.icnf
-  cat $CNF | grep -v c >> $OUT/formula$$-$CORE.icnf
   awk 'NR % '$PAR' == '$CORE'' $OUT/cubes$$ >> $OUT/formula$$-$CORE.icnf
-  $DIR/iglucose/core/iglucose $OUT/formula$$-$CORE.icnf $OUT/output-$CORE.txt -verb=0 &
+  $DIR/iglucose/core/iglucose $OUT/formula$$-$CORE.icnf $OUT/output-$CORE.txt -verb=0 -load-image=$OUT/image$$ &
 done
 wait
 
-rm $OUT/cubes$$
+rm $OUT/cubes$$ $OUT/image$$
 for (( CORE=0; CORE<$PAR; CORE++ ))
 do
   rm $OUT/formula$$-$CORE.icnf
@@ -1,2 +1,20 @@
 ./cube-glucose.sh tests/eq.atree.braun.8.unsat.cnf
 ./cube-lingeling.sh tests/eq.atree.braun.8.unsat.cnf
+
+# Two guarded pigeon hole formulas, 'a 2' is unsatisfiable and 'a -2' satisfiable. The leaves kept
+# from splitting 'a 1' must not make -split-conflicts refute 'a -2':
+iglucose/core/iglucose -split-conflicts=20 -split-depth=2 tests/split-php.icnf | grep -q "^s SATISFIABLE" || echo "FAIL: tests/split-php.icnf"
+
+# 18 variables in the header, 15 in the clauses: -count has to double for each of the other 3.
+# 448 models by brute force, with or without the cubes of march_cu -#:
+iglucose/core/iglucose -count tests/count-unused.cnf | grep -q "^c s exact arb int 448$" || echo "FAIL: tests/count-unused.cnf"
+iglucose/core/iglucose -count -workers=2 tests/count-unused.icnf | grep -q "^c s exact arb int 448$" || echo "FAIL: tests/count-unused.icnf"
+
+# Unsatisfiable random 3-SAT where a calibration run of -hybrid already refutes the formula:
+iglucose/core/iglucose -hybrid tests/hybrid-unsat.icnf | grep -q "^s UNSATISFIABLE" || echo "FAIL: tests/hybrid-unsat.icnf"
+
+# Testing eliminations ahead on threads must not change the simplified formula or the stack:
+iglucose/simp/iglucose tests/ptn-easy.cnf -verb=0 -dimacs=/tmp/elim0$$.cnf -stack=/tmp/elim0$$ > /dev/null
+iglucose/simp/iglucose tests/ptn-easy.cnf -verb=0 -elim-threads=4 -dimacs=/tmp/elim4$$.cnf -stack=/tmp/elim4$$ > /dev/null
+cmp -s /tmp/elim0$$.cnf /tmp/elim4$$.cnf && cmp -s /tmp/elim0$$ /tmp/elim4$$ || echo "FAIL: -elim-threads=4 on tests/ptn-easy.cnf"
+rm -f /tmp/elim0$$.cnf /tmp/elim0$$ /tmp/elim4$$.cnf /tmp/elim4$$